@@ -26,11 +26,11 @@ static GFraMe_tilemap floor_tm;
 /**
  * Tilemap data for the background
  */
-static char bg_data[BG_W * BG_H];
+static GFraMe_tile bg_data[BG_W * BG_H];
 /**
  * Tilemap data for the floor
  */
-static char floor_data[FLOOR_W * FLOOR_H];
+static GFraMe_tile floor_data[FLOOR_W * FLOOR_H];
 /**
  * Floor collideable; doesn't need gfx
  */
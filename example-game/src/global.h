@@ -10,7 +10,7 @@
 /**
  * Function that maps a character to its tile counterpart
  */
-#define CHAR2TILE(x)	(x - '!')
+#define CHAR2TILE(x)	((x) > '!' ? (x) - '!' : 0)
 
 /**
  * Whether the main loop is running
@@ -37,7 +37,7 @@ static int game_init;
 static GFraMe_accumulator timer;
 
 static GFraMe_tilemap init_text;
-static char init_data[20];
+static GFraMe_tile init_data[20];
 static int is_text_visible;
 static int requestSwitch;
 
@@ -15,7 +15,7 @@ static GFraMe_tilemap tm_multi;
 /**
  * Current data used by the multiplier
  */
-static char data[5];
+static GFraMe_tile data[5];
 /**
  * Timer used to decrease the current level
  */
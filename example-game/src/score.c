@@ -24,7 +24,7 @@ static GFraMe_tilemap score;
 /**
  * Data with things to be added
  */
-static char score_data[9*2];
+static GFraMe_tile score_data[9*2];
 /**
  * How many actualy points the player has
  */
@@ -45,7 +45,7 @@ static int highscore = 0;
 static int hs_time;
 
 void score_init() {
-	char *tmp;
+	GFraMe_tile *tmp;
 	// Assign basic tilemap data
 	tmp = GFraMe_str2tiles(score_data, "  SCORE  ", 0);
 	tmp = GFraMe_str2tiles(tmp, "000000000", 0);
@@ -60,7 +60,7 @@ void score_init() {
 }
 
 void highscore_init() {
-	char *tmp;
+	GFraMe_tile *tmp;
 	int i;
 	GFraMe_ret rv;
 	
@@ -46,6 +46,63 @@ struct stGFraMe_animation {
 	int tile;
 };
 typedef struct stGFraMe_animation GFraMe_animation;
+
+/**
+ * Data of an animation that's shared by every instance playing it
+ */
+struct stGFraMe_animdef {
+	/**
+	 * Frames indexes in the spriteset
+	 */
+	int const *frames;
+	/**
+	 * How many frames there are
+	 */
+	int num_frames;
+	/**
+	 * Whether the animation should loop
+	 */
+	int do_loop;
+	/**
+	 * How long, in milliseconds, a frame should last (0, if each frame has its
+	 *own duration)
+	 */
+	int frame_duration;
+	/**
+	 * Time (since the start of the animation) when each frame ends, if each
+	 *frame has its own duration (NULL, otherwise)
+	 */
+	int *times;
+	/**
+	 * How long, in milliseconds, the whole animation lasts
+	 */
+	int total;
+};
+typedef struct stGFraMe_animdef GFraMe_animdef;
+
+/**
+ * An instance playing an animation definition
+ */
+struct stGFraMe_animplayer {
+	/**
+	 * Animation being played (NULL, if none)
+	 */
+	GFraMe_animdef const *def;
+	/**
+	 * Current frame in the frames array
+	 */
+	int index;
+	/**
+	 * Decreasing accumulator; when it's less or equal to zero, issue a new
+	 *frame (and, when it stays that way, the animation finished)
+	 */
+	int acc;
+	/**
+	 * How many times the animations has finished, i.e. it looped
+	 */
+	int num_finished;
+};
+typedef struct stGFraMe_animplayer GFraMe_animplayer;
  
 /**
  * Initialize an animation	
@@ -77,6 +134,94 @@ GFraMe_ret GFraMe_animation_update(GFraMe_animation *anim, int ms);
  * @param	*anim	Current animation
  */
 void GFraMe_animation_reset(GFraMe_animation *anim);
+
+/**
+ * Initialize an animation definition
+ * @param	*def	Animation definition to be initialized
+ * @param	fps	At how many frames per second it should run
+ * @param	*frames	Array of frames (int)
+ * @param	num_frames	How many frames there are in the animation
+ * @param	do_loop	Whether it should loop (1) or not (0)
+ */
+void GFraMe_animdef_init(GFraMe_animdef *def, int fps, int const *frames,
+						 int num_frames, int do_loop);
+
+/**
+ * Initialize an animation definition where each frame has its own duration
+ * @param	*def	Animation definition to be initialized
+ * @param	*frames	Array of frames (int)
+ * @param	*durations	How long, in milliseconds, each frame lasts
+ * @param	num_frames	How many frames there are in the animation
+ * @param	do_loop	Whether it should loop (1) or not (0)
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_animdef_init_durations(GFraMe_animdef *def,
+										 int const *frames,
+										 int const *durations, int num_frames,
+										 int do_loop);
+
+/**
+ * Release every memory used by an animation definition
+ * @param	*def	The animation definition
+ */
+void GFraMe_animdef_clear(GFraMe_animdef *def);
+
+/**
+ * Find the state of an animation at a given time, without playing through it
+ *(in constant time, if every frame has the same duration, or logarithmic,
+ *otherwise)
+ * @param	*def	The animation definition
+ * @param	t_ms	Time since the animation started, in milliseconds
+ * @param	*index	Returns the frame's index in the frames array (may be NULL)
+ * @param	*num_finished	Returns how many times the animation finished
+ *			  (may be NULL)
+ * @return	The tile displayed at that time
+ */
+int GFraMe_animation_sample(GFraMe_animdef const *def, int t_ms, int *index,
+							int *num_finished);
+
+/**
+ * Set an instance to the state its animation would be in after some time
+ *(e.g., to rewind it or to catch up after a stall)
+ * @param	*player	The instance
+ * @param	t_ms	Time since the animation started, in milliseconds
+ */
+void GFraMe_animplayer_seek(GFraMe_animplayer *player, int t_ms);
+
+/**
+ * Start playing an animation from its first frame
+ * @param	*player	The instance
+ * @param	*def	Animation to be played (NULL stops the current one)
+ */
+void GFraMe_animplayer_play(GFraMe_animplayer *player,
+							GFraMe_animdef const *def);
+
+/**
+ * Get the tile currently displayed by an instance
+ * @param	*player	The instance
+ * @return	The tile (-1, if there's no animation)
+ */
+int GFraMe_animplayer_get_tile(GFraMe_animplayer *player);
+
+/**
+ * Updates an instance, changing the frame (as many times as needed)
+ * @param	*player	The instance
+ * @param	ms	Time elapsed, in milliseconds
+ * @return	GFraMe_ret_ok - if nothing happened; GFraMe_ret_anim_new_frame - if a new frame was issued; GFraMe_ret_anim_finished - if the animation finished running
+ */
+GFraMe_ret GFraMe_animplayer_update(GFraMe_animplayer *player, int ms);
+
+/**
+ * Updates many instances at once
+ * @param	*players	The instances
+ * @param	num	How many instances there are
+ * @param	ms	Time elapsed, in milliseconds
+ * @param	*changed	Returns the index of every instance whose tile
+ *			  changed (must fit 'num' indexes)
+ * @return	How many instances had their tile changed
+ */
+int GFraMe_animation_update_many(GFraMe_animplayer *players, int num, int ms,
+								 int *changed);
  
 #endif
 
@@ -6,6 +6,18 @@
 
 #include <GFraMe/GFraMe_error.h>
 
+/**
+ * Get the path of an asset; on desktop, it's within the 'assets/' folder (which
+ *is on the game's path, on release builds). SDL already looks for assets on a
+ *mobile device within 'assets/', so the name is copied as is
+ * @param	*dst	Buffer that receives the path
+ * @param	*src	Asset's name, relative to the 'assets/' folder
+ * @param	*len	Size of 'dst', in characters; returns how many characters
+ *		  were left unused (if 0, the path was truncated)
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_assets_clean_filename(char *dst, char *src, int *len);
+
 /**
  * Check whether a file exists
  * @param	*filename	File to be checked
@@ -0,0 +1,236 @@
+/**
+ * @include/GFraMe/GFraMe_camera.h
+ *
+ * View into the world. Sprites and tilemaps are kept in world space and are
+ *culled (by the size of the frame actually drawn) and moved into screen space
+ *only when submitted, so objects are never modified to be rendered.
+ * Each render queue layer has its own parallax factor: a layer with factor 0.5
+ *scrolls at half the speed of the camera, while one with factor 0 stays fixed
+ *on the screen (e.g., a HUD). Zoom is applied from the screen's upper-left
+ *corner.
+ */
+#ifndef __GFRAME_CAMERA_H
+#define __GFRAME_CAMERA_H
+
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_renderqueue.h>
+#include <GFraMe/GFraMe_sprite.h>
+#include <GFraMe/GFraMe_spritepool.h>
+#include <GFraMe/GFraMe_tilemap.h>
+
+/**
+ * Area of the world visible on a layer
+ */
+struct stGFraMe_camera_view {
+	float x;
+	float y;
+	float w;
+	float h;
+};
+typedef struct stGFraMe_camera_view GFraMe_camera_view;
+
+struct stGFraMe_camera {
+	/**
+	 * Horizontal position of the camera's upper-left corner (on layers
+	 *without parallax)
+	 */
+	int x;
+	/**
+	 * Vertical position of the camera's upper-left corner (on layers
+	 *without parallax)
+	 */
+	int y;
+	/**
+	 * View's width, on the screen
+	 */
+	int w;
+	/**
+	 * View's height, on the screen
+	 */
+	int h;
+	/**
+	 * How many screen pixels each world pixel takes
+	 */
+	float zoom;
+	/**
+	 * Horizontal parallax factor of each layer
+	 */
+	float parallax_x[GFRAME_RENDERQUEUE_LAYERS];
+	/**
+	 * Vertical parallax factor of each layer
+	 */
+	float parallax_y[GFRAME_RENDERQUEUE_LAYERS];
+};
+typedef struct stGFraMe_camera GFraMe_camera;
+
+/**
+ * Initialize a camera at the origin, without zoom nor parallax
+ * @param	*cam	Camera to be initialized
+ * @param	w	View's width, on the screen
+ * @param	h	View's height, on the screen
+ */
+void GFraMe_camera_init(GFraMe_camera *cam, int w, int h);
+
+/**
+ * Move the camera's upper-left corner
+ * @param	*cam	The camera
+ * @param	x	Horizontal position
+ * @param	y	Vertical position
+ */
+void GFraMe_camera_set_pos(GFraMe_camera *cam, int x, int y);
+
+/**
+ * Move the camera so a point is on the center of the view (e.g., to follow
+ *the player)
+ * @param	*cam	The camera
+ * @param	x	Horizontal position
+ * @param	y	Vertical position
+ */
+void GFraMe_camera_center(GFraMe_camera *cam, int x, int y);
+
+/**
+ * Set the camera's zoom
+ * @param	*cam	The camera
+ * @param	zoom	How many screen pixels each world pixel takes (must be
+ *		  positive)
+ */
+void GFraMe_camera_set_zoom(GFraMe_camera *cam, float zoom);
+
+/**
+ * Set a layer's parallax factor
+ * @param	*cam	The camera
+ * @param	layer	The layer
+ * @param	px	Horizontal factor (1 moves along the world, 0 stays fixed)
+ * @param	py	Vertical factor
+ */
+void GFraMe_camera_set_parallax(GFraMe_camera *cam, int layer, float px,
+								float py);
+
+/**
+ * Get the area of the world visible on a layer
+ * @param	*view	Returns the area
+ * @param	*cam	The camera
+ * @param	layer	The layer
+ */
+void GFraMe_camera_get_view(GFraMe_camera_view *view, GFraMe_camera *cam,
+							int layer);
+
+/**
+ * Check whether a command (in world space) is visible on a layer
+ * @param	*cam	The camera
+ * @param	layer	The layer
+ * @param	*cmd	The command
+ * @return	1 - Visible; 0 - Otherwise
+ */
+int GFraMe_camera_is_cmd_visible(GFraMe_camera *cam, int layer,
+								 GFraMe_rendercmd *cmd);
+
+/**
+ * Check whether a sprite's current frame is visible on a layer
+ * @param	*cam	The camera
+ * @param	layer	The layer
+ * @param	*spr	The sprite
+ * @return	1 - Visible; 0 - Otherwise
+ */
+int GFraMe_camera_is_visible(GFraMe_camera *cam, int layer,
+							 GFraMe_sprite *spr);
+
+/**
+ * Move a command from world space into screen space
+ * @param	*cam	The camera
+ * @param	layer	The layer
+ * @param	*cmd	The command
+ */
+void GFraMe_camera_transform(GFraMe_camera *cam, int layer,
+							 GFraMe_rendercmd *cmd);
+
+/**
+ * Draw a sprite right away, if it's visible; on the SDL renderer, zoom only
+ *changes the sprite's position (use a render queue to also scale it)
+ * @param	*cam	The camera
+ * @param	layer	Layer whose parallax is used
+ * @param	*spr	The sprite
+ * @return	GFraMe_ret_ok - Success (or culled); Anything else - Failure
+ */
+GFraMe_ret GFraMe_camera_draw_sprite(GFraMe_camera *cam, int layer,
+									 GFraMe_sprite *spr);
+
+/**
+ * Push a sprite into a render queue, if it's visible
+ * @param	*cam	The camera
+ * @param	*queue	The render queue
+ * @param	layer	Layer where the sprite is pushed
+ * @param	depth	Depth within the layer
+ * @param	*spr	The sprite
+ * @param	blend	How the sprite is blended
+ * @return	GFraMe_ret_ok - Success (or culled); Anything else - Failure
+ */
+GFraMe_ret GFraMe_camera_push_sprite(GFraMe_camera *cam,
+									 GFraMe_renderqueue *queue, int layer,
+									 int depth, GFraMe_sprite *spr,
+									 GFraMe_blend blend);
+
+/**
+ * Find every live sprite on a pool that is visible (in a single pass)
+ * @param	*visible	Returns the index of every visible sprite (must fit
+ *			  pool->num indexes)
+ * @param	*cam	The camera
+ * @param	layer	Layer whose parallax is used
+ * @param	*pool	The pool
+ * @return	How many sprites are visible
+ */
+int GFraMe_camera_cull_pool(int *visible, GFraMe_camera *cam, int layer,
+							GFraMe_spritepool *pool);
+
+/**
+ * Push every visible sprite of a pool into a render queue
+ * @param	*cam	The camera
+ * @param	*queue	The render queue
+ * @param	layer	Layer where the sprites are pushed
+ * @param	depth	Depth of every sprite within the layer
+ * @param	*pool	The pool
+ * @param	blend	How the sprites are blended
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_camera_push_pool(GFraMe_camera *cam,
+								   GFraMe_renderqueue *queue, int layer,
+								   int depth, GFraMe_spritepool *pool,
+								   GFraMe_blend blend);
+
+/**
+ * Get which tiles of a tilemap are visible on a layer
+ * @param	*rect	Returns the visible tiles (with no width nor height, if
+ *		  none is visible)
+ * @param	*cam	The camera
+ * @param	layer	The layer
+ * @param	*tmap	The tilemap
+ */
+void GFraMe_camera_get_tiles(GFraMe_tilemap_rect *rect, GFraMe_camera *cam,
+							 int layer, GFraMe_tilemap *tmap);
+
+/**
+ * Draw every visible tile of a tilemap right away; zoom isn't applied (use a
+ *render queue instead)
+ * @param	*cam	The camera
+ * @param	layer	Layer whose parallax is used
+ * @param	*tmap	The tilemap
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_camera_draw_tilemap(GFraMe_camera *cam, int layer,
+									  GFraMe_tilemap *tmap);
+
+/**
+ * Push every visible tile of a tilemap into a render queue
+ * @param	*cam	The camera
+ * @param	*queue	The render queue
+ * @param	layer	Layer where the tiles are pushed
+ * @param	depth	Depth of every tile within the layer
+ * @param	*tmap	The tilemap
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_camera_push_tilemap(GFraMe_camera *cam,
+									  GFraMe_renderqueue *queue, int layer,
+									  int depth, GFraMe_tilemap *tmap);
+
+#endif
+
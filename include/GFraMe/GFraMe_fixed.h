@@ -0,0 +1,74 @@
+/**
+ * @include/GFraMe/GFraMe_fixed.h
+ *
+ * 16.16 fixed point numbers and GFraMe_real, the type used by objects,
+ *hitboxes and tweens. GFraMe_real is a double, unless the framework is built
+ *with GFRAME_FIXED_POINT, in which case it's a GFraMe_fixed (which is faster
+ *on soft-float devices and gives the same results on every compiler).
+ * NOTE since the integer part has only 16 bits, positions must be within
+ *[-32768, 32767]
+ */
+#ifndef __GFRAME_FIXED_H
+#define __GFRAME_FIXED_H
+
+#include <stdint.h>
+
+/**
+ * 16.16 fixed point number
+ */
+typedef int32_t GFraMe_fixed;
+
+#define GFRAME_FIXED_SHIFT 16
+#define GFRAME_FIXED_ONE (1 << GFRAME_FIXED_SHIFT)
+#define GFRAME_FIXED_MAX INT32_MAX
+#define GFRAME_FIXED_MIN INT32_MIN
+
+/**
+ * Convert an integer to fixed point
+ */
+#define GFraMe_fixed_from_int(i) ((GFraMe_fixed)((i) * GFRAME_FIXED_ONE))
+/**
+ * Convert a fixed point to integer, truncating it (just like a cast from
+ *double does)
+ */
+#define GFraMe_fixed_to_int(f) \
+	((int)((f) < 0 ? -((-(int64_t)(f)) >> GFRAME_FIXED_SHIFT) \
+				   : ((f) >> GFRAME_FIXED_SHIFT)))
+/**
+ * Convert a double to fixed point
+ */
+#define GFraMe_fixed_from_double(d) ((GFraMe_fixed)((d) * GFRAME_FIXED_ONE))
+/**
+ * Convert a fixed point to double
+ */
+#define GFraMe_fixed_to_double(f) ((double)(f) / GFRAME_FIXED_ONE)
+/**
+ * Multiply two fixed point numbers
+ */
+#define GFraMe_fixed_mul(a, b) \
+	((GFraMe_fixed)(((int64_t)(a) * (int64_t)(b)) >> GFRAME_FIXED_SHIFT))
+
+#if defined(GFRAME_FIXED_POINT)
+typedef GFraMe_fixed GFraMe_real;
+#  define GFRAME_REAL_MAX GFRAME_FIXED_MAX
+#  define GFRAME_REAL_MIN GFRAME_FIXED_MIN
+#  define GFraMe_real_from_int(i) GFraMe_fixed_from_int(i)
+#  define GFraMe_real_to_int(r) GFraMe_fixed_to_int(r)
+#  define GFraMe_real_from_double(d) GFraMe_fixed_from_double(d)
+#  define GFraMe_real_to_double(r) GFraMe_fixed_to_double(r)
+#  define GFraMe_real_mul(a, b) GFraMe_fixed_mul(a, b)
+#  define GFraMe_real_half(r) ((r) / 2)
+#else
+typedef double GFraMe_real;
+#  define GFRAME_REAL_MAX 1.0e300
+#  define GFRAME_REAL_MIN -1.0e300
+#  define GFraMe_real_from_int(i) ((double)(i))
+#  define GFraMe_real_to_int(r) ((int)(r))
+#  define GFraMe_real_from_double(d) ((double)(d))
+#  define GFraMe_real_to_double(r) ((double)(r))
+#  define GFraMe_real_mul(a, b) ((a) * (b))
+#  define GFraMe_real_half(r) ((r) * 0.5)
+#endif
+
+#endif
+
@@ -4,6 +4,8 @@
 #ifndef __GFRAME_HITBOX_H
 #define __GFRAME_HITBOX_H
 
+#include <GFraMe/GFraMe_fixed.h>
+
 /**
  * Enumeration that defines what the position passed to 'set_hitbox' means
  */
@@ -38,19 +40,19 @@ struct stGFraMe_hitbox {
 	/**
 	 * Offset to horizontal center
 	 */
-	double cx;
+	GFraMe_real cx;
 	/**
 	 * Offset to vertical center
 	 */
-	double cy;
+	GFraMe_real cy;
 	/**
 	 * Half width
 	 */
-	double hw;
+	GFraMe_real hw;
 	/**
 	 * Half height
 	 */
-	double hh;
+	GFraMe_real hh;
 };
 typedef struct stGFraMe_hitbox GFraMe_hitbox;
 
@@ -0,0 +1,215 @@
+/**
+ * @include/GFraMe/GFraMe_nav.h
+ *
+ * Navigation over a tilemap's solid tiles (see GFraMe_tilemap_init). Moves go
+ *to any of the 8 neighbors, but diagonals can't cut corners (both tiles beside
+ *the move must be free); straight moves cost 10 and diagonal ones cost 14.
+ * Single queries use jump-point search (A* that skips over open areas),
+ *reusing the same arena on every query. When many agents share a target
+ *(e.g., every enemy chasing the player), a flow field holds every tile's
+ *distance to the target, computed once for the whole map; each agent then
+ *simply steps toward its lowest neighbor. When the target moves to a
+ *neighboring tile, only the tiles that got closer are updated.
+ * Both must be computed again if the tilemap's tiles change.
+ */
+#ifndef __GFRAME_NAV_H
+#define __GFRAME_NAV_H
+
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_tilemap.h>
+
+/**
+ * Cost of a straight move
+ */
+#define GFRAME_NAV_STRAIGHT 10
+/**
+ * Cost of a diagonal move
+ */
+#define GFRAME_NAV_DIAGONAL 14
+
+/**
+ * An entry on the open list
+ */
+struct stGFraMe_nav_node {
+	/**
+	 * Estimated cost of a path through the tile
+	 */
+	int f;
+	/**
+	 * The tile (y * width + x)
+	 */
+	int tile;
+};
+typedef struct stGFraMe_nav_node GFraMe_nav_node;
+
+/**
+ * Arena reused by every path query on a tilemap
+ */
+struct stGFraMe_nav {
+	/**
+	 * The tilemap
+	 */
+	GFraMe_tilemap *tmap;
+	/**
+	 * Cost from the start to each tile
+	 */
+	int *g;
+	/**
+	 * Previous jump point of each tile
+	 */
+	int *parent;
+	/**
+	 * Query when each tile was reached (so nothing is cleared between
+	 *queries)
+	 */
+	unsigned int *seen;
+	/**
+	 * Query when each tile was closed
+	 */
+	unsigned int *closed;
+	/**
+	 * Current query
+	 */
+	unsigned int query;
+	/**
+	 * Open list, as a binary heap
+	 */
+	GFraMe_nav_node *open;
+	/**
+	 * How many entries are on the open list
+	 */
+	int num_open;
+	/**
+	 * How many entries fit the open list
+	 */
+	int max_open;
+};
+typedef struct stGFraMe_nav GFraMe_nav;
+
+/**
+ * Distance from every tile to a target
+ */
+struct stGFraMe_flowfield {
+	/**
+	 * The tilemap
+	 */
+	GFraMe_tilemap *tmap;
+	/**
+	 * Each tile's distance, minus 'offset' (INT_MAX, if unreachable)
+	 */
+	int *dist;
+	/**
+	 * Added to every distance (so moving the target shifts every tile at
+	 *once)
+	 */
+	int offset;
+	/**
+	 * The target (-1, if none was set)
+	 */
+	int target_x;
+	int target_y;
+	/**
+	 * Tiles waiting to be visited, by distance (modulo the buckets)
+	 */
+	int *buckets[GFRAME_NAV_DIAGONAL + 1];
+	/**
+	 * How many tiles are on each bucket
+	 */
+	int bucket_len[GFRAME_NAV_DIAGONAL + 1];
+	/**
+	 * How many tiles fit each bucket
+	 */
+	int bucket_max[GFRAME_NAV_DIAGONAL + 1];
+};
+typedef struct stGFraMe_flowfield GFraMe_flowfield;
+
+/**
+ * Initialize the arena for path queries on a tilemap
+ * @param	*nav	The arena
+ * @param	*tmap	The tilemap (must be already initialized)
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_nav_init(GFraMe_nav *nav, GFraMe_tilemap *tmap);
+
+/**
+ * Release the arena
+ * @param	*nav	The arena
+ */
+void GFraMe_nav_clear(GFraMe_nav *nav);
+
+/**
+ * Find the shortest path between two tiles; every step between consecutive
+ *points is a straight or diagonal line
+ * @param	*path	Returns the path's points, as (x, y) pairs of tiles, from the
+ *		  start to the goal
+ * @param	*len	Returns how many points there are on the path (even if they
+ *		  didn't fit)
+ * @param	max_len	How many points fit the path
+ * @param	*nav	The arena
+ * @param	sx	Start's horizontal position (in tiles)
+ * @param	sy	Start's vertical position (in tiles)
+ * @param	gx	Goal's horizontal position (in tiles)
+ * @param	gy	Goal's vertical position (in tiles)
+ * @return	GFraMe_ret_ok - Success; GFraMe_buffer_too_small - The path
+ *		  didn't fit; GFraMe_ret_failed - There's no path
+ */
+GFraMe_ret GFraMe_nav_find_path(int *path, int *len, int max_len,
+								GFraMe_nav *nav, int sx, int sy, int gx,
+								int gy);
+
+/**
+ * Initialize a flow field without a target
+ * @param	*field	The field
+ * @param	*tmap	The tilemap (must be already initialized)
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_flowfield_init(GFraMe_flowfield *field,
+								 GFraMe_tilemap *tmap);
+
+/**
+ * Release a flow field
+ * @param	*field	The field
+ */
+void GFraMe_flowfield_clear(GFraMe_flowfield *field);
+
+/**
+ * Move the field's target; if it moved to a neighboring tile, only the tiles
+ *that got closer are updated (otherwise, the whole field is computed again)
+ * @param	*field	The field
+ * @param	tx	Target's horizontal position (in tiles)
+ * @param	ty	Target's vertical position (in tiles)
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_flowfield_set_target(GFraMe_flowfield *field, int tx,
+									   int ty);
+
+/**
+ * Compute the whole field again (e.g., after the tilemap changed)
+ * @param	*field	The field
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_flowfield_compute(GFraMe_flowfield *field);
+
+/**
+ * Get a tile's distance to the target
+ * @param	*field	The field
+ * @param	tx	Tile's horizontal position (in tiles)
+ * @param	ty	Tile's vertical position (in tiles)
+ * @return	The distance (-1, if the target can't be reached)
+ */
+int GFraMe_flowfield_get_dist(GFraMe_flowfield *field, int tx, int ty);
+
+/**
+ * Get the direction of the next step toward the target
+ * @param	*dx	Returns the horizontal direction (-1, 0 or 1)
+ * @param	*dy	Returns the vertical direction (-1, 0 or 1)
+ * @param	*field	The field
+ * @param	tx	Tile's horizontal position (in tiles)
+ * @param	ty	Tile's vertical position (in tiles)
+ * @return	1 - There's a step; 0 - On the target or unreachable
+ */
+int GFraMe_flowfield_get_dir(int *dx, int *dy, GFraMe_flowfield *field,
+							 int tx, int ty);
+
+#endif
+
@@ -5,8 +5,10 @@
 #define __GFRAME_OBJECT_H_
 
 #include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_fixed.h>
 #include <GFraMe/GFraMe_hitbox.h>
 #include <GFraMe/GFraMe_tween.h>
+#include <stdint.h>
 
 #define GAME_HORIZONTAL_COLLISION	1
 #define GAME_VERTICAL_COLLISION		2
@@ -54,6 +56,22 @@ enum enGFraMe_collision_type {
 };
 typedef enum enGFraMe_collision_type GFraMe_collision_type;
 
+/**
+ * Layer of newly cleared objects
+ */
+#define GFRAME_LAYER_DEFAULT	0x00000001u
+/**
+ * Mask that accepts every layer (the default one)
+ */
+#define GFRAME_MASK_ALL			0xffffffffu
+
+/**
+ * Check whether two objects may collide, according to their layers and masks
+ *(i.e., each one's layer is on the other's mask)
+ */
+#define GFraMe_object_layers_match(o1, o2) \
+	(((o1)->layer & (o2)->mask) && ((o2)->layer & (o1)->mask))
+
 struct stGFraMe_object {
 	/**
 	 * Current horizontal position (read only!);
@@ -69,42 +87,52 @@ struct stGFraMe_object {
 	 * Actual horizontal position (read only!);
 	 * should only be used internally
 	 */
-	double dx;
+	GFraMe_real dx;
 	/**
 	 * Actual vertical position (read only!);
 	 * should only be used internally
 	 */
-	double dy;
+	GFraMe_real dy;
 	/**
 	 * Last horizontal possition (read only!);
 	 * used to decide previous position on collision
 	 */
-	double ldx;
+	GFraMe_real ldx;
 	/**
 	 * Last vertical possition (read only!);
 	 * used to decide previous position on collision
 	 */
-	double ldy;
+	GFraMe_real ldy;
 	/**
 	 * Current horizontal velocity
 	 */
-	double vx;
+	GFraMe_real vx;
 	/**
 	 * Current vertical velocity
 	 */
-	double vy;
+	GFraMe_real vy;
 	/**
 	 * Current horizontal acceleration
 	 */
-	double ax;
+	GFraMe_real ax;
 	/**
 	 * Current vertical acceleration
 	 */
-	double ay;
+	GFraMe_real ay;
 	/**
 	 * Just/last collided direction(s)
 	 */
 	GFraMe_direction hit;
+	/**
+	 * Bit mask with the layers the object is on
+	 */
+	uint32_t layer;
+	/**
+	 * Bit mask with the layers the object collides against; bulk overlap
+	 *functions skip (before checking any hitbox) pairs where either object's
+	 *layer isn't on the other's mask
+	 */
+	uint32_t mask;
 	/**
 	 * The object's hitbox
 	 */
@@ -144,6 +172,15 @@ void GFraMe_object_set_y(GFraMe_object *obj, int Y);
  */
 void GFraMe_object_set_pos(GFraMe_object *obj, int X, int Y);
 
+/**
+ * Sets on which layers an object is and which ones it collides against
+ * @param	*obj	The object
+ * @param	layer	Bit mask with the object's layers
+ * @param	mask	Bit mask with the layers it collides against
+ */
+void GFraMe_object_set_layer(GFraMe_object *obj, uint32_t layer,
+							 uint32_t mask);
+
 /**
  * Updates an object's position, velocity and collision state
  * @param	*obj	Object to be update
@@ -152,7 +189,8 @@ void GFraMe_object_set_pos(GFraMe_object *obj, int X, int Y);
 void GFraMe_object_update(GFraMe_object *obj, int ms);
 
 /**
- * Overlaps two objects, according to the mode passed
+ * Overlaps two objects, according to the mode passed; their layers aren't
+ *checked, since they were explicitly requested to overlap
  * @param	*o1	One of the objects to be overlaped
  * @param	*o2	The other object to be overlaped
  * @param	mode	How collision should be handle
@@ -161,6 +199,67 @@ void GFraMe_object_update(GFraMe_object *obj, int ms);
 GFraMe_ret GFraMe_object_overlap(GFraMe_object *o1, GFraMe_object *o2,
 						   GFraMe_collision_type mode);
 
+/**
+ * Overlaps one object against many others; the result is the same as calling
+ * GFraMe_object_overlap(o, others[i], mode) for each one whose layers match
+ * (see GFraMe_object_layers_match), in order, but most objects are rejected a
+ * few at a time (using SIMD, if available)
+ * @param	*o	The object overlapped against every other
+ * @param	**others	Objects to be overlapped
+ * @param	n	How many objects there are
+ * @param	mode	How collision should be handle ('o' is the first object)
+ * @param	*hitmask	Bit array ((n + 63) / 64 words) where every object
+ *			  that overlapped is set; may be NULL
+ * @return	How many objects overlapped
+ */
+int GFraMe_object_overlap_many(GFraMe_object *o, GFraMe_object **others,
+							   int n, GFraMe_collision_type mode,
+							   uint64_t *hitmask);
+
+/**
+ * Find when two objects started touching during their last update, by
+ *sweeping their hitboxes from their last position (ldx, ldy) to the current
+ *one (dx, dy); objects that were already overlapping aren't reported
+ * @param	*o1	One of the objects
+ * @param	*o2	The other object
+ * @param	*time	Returns the fraction of the movement (in [0, 1)) when they
+ *			  touched
+ * @param	*axis	Returns on which axis they touched
+ *			  (GAME_HORIZONTAL_COLLISION and/or GAME_VERTICAL_COLLISION)
+ * @return	Whether they touched (GFraMe_ret_ok) or not (GFraMe_ret_no_overlap)
+ */
+GFraMe_ret GFraMe_object_sweep(GFraMe_object *o1, GFraMe_object *o2,
+							   GFraMe_real *time, int *axis);
+
+/**
+ * Overlaps two objects, just like GFraMe_object_overlap, but also collides
+ *objects that passed through each other during their last update (e.g., fast
+ *bullets and thin platforms)
+ * @param	*o1	One of the objects to be overlaped
+ * @param	*o2	The other object to be overlaped
+ * @param	mode	How collision should be handle
+ * @return	Whether an overlap occured (GFraMe_ret_ok) or not (GFraMe_ret_no_overlap)
+ */
+GFraMe_ret GFraMe_object_overlap_swept(GFraMe_object *o1, GFraMe_object *o2,
+									   GFraMe_collision_type mode);
+
+/**
+ * Collides one object against many others using their swept hitboxes; the
+ *earliest contact is always resolved first (and every other is then checked
+ *again), so an object that hits many others on a single update stops at the
+ *first one; objects whose layers don't match are skipped
+ * @param	*o	The object collided against every other
+ * @param	**others	Objects to be collided
+ * @param	n	How many objects there are
+ * @param	mode	How collision should be handle ('o' is the first object)
+ * @param	*hitmask	Bit array ((n + 63) / 64 words) where every object
+ *			  that overlapped is set; may be NULL
+ * @return	How many contacts were resolved
+ */
+int GFraMe_object_overlap_swept_many(GFraMe_object *o, GFraMe_object **others,
+									 int n, GFraMe_collision_type mode,
+									 uint64_t *hitmask);
+
 GFraMe_hitbox *GFraMe_object_get_hitbox(GFraMe_object *obj);
 
 GFraMe_tween *GFraMe_object_get_tween(GFraMe_object *obj);
@@ -0,0 +1,234 @@
+/**
+ * @include/GFraMe/GFraMe_object_pool.h
+ *
+ * Pool of objects stored as a structure of arrays, so every object can be
+ *integrated at once (using SIMD, if available). Objects are referenced by
+ *handles, which stay valid until the object is removed; GFraMe_object_pool_load
+ *and GFraMe_object_pool_store copy an object from/to a GFraMe_object, so it
+ *can be used by any function that expects one.
+ * NOTE pooled objects don't have tweens
+ */
+#ifndef __GFRAME_OBJECT_POOL_H
+#define __GFRAME_OBJECT_POOL_H
+
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_hitbox.h>
+#include <GFraMe/GFraMe_object.h>
+
+/**
+ * Reference to an object on a pool; the lower 16 bits are the object's slot
+ *and the rest is incremented whenever the slot is reused
+ */
+typedef int GFraMe_object_handle;
+
+/**
+ * Never a valid handle
+ */
+#define GFraMe_object_handle_none (-1)
+
+struct stGFraMe_object_pool {
+	/**
+	 * Actual horizontal positions
+	 */
+	GFraMe_real *dx;
+	/**
+	 * Actual vertical positions
+	 */
+	GFraMe_real *dy;
+	/**
+	 * Last horizontal positions
+	 */
+	GFraMe_real *ldx;
+	/**
+	 * Last vertical positions
+	 */
+	GFraMe_real *ldy;
+	/**
+	 * Horizontal velocities
+	 */
+	GFraMe_real *vx;
+	/**
+	 * Vertical velocities
+	 */
+	GFraMe_real *vy;
+	/**
+	 * Horizontal accelerations
+	 */
+	GFraMe_real *ax;
+	/**
+	 * Vertical accelerations
+	 */
+	GFraMe_real *ay;
+	/**
+	 * Horizontal (integer) positions
+	 */
+	int *x;
+	/**
+	 * Vertical (integer) positions
+	 */
+	int *y;
+	/**
+	 * Just/last collided direction(s)
+	 */
+	int *hit;
+	/**
+	 * Objects' layers
+	 */
+	uint32_t *layer;
+	/**
+	 * Layers each object collides against
+	 */
+	uint32_t *mask;
+	/**
+	 * Objects' hitboxes
+	 */
+	GFraMe_hitbox *hitbox;
+	/**
+	 * Slot of the object at each index
+	 */
+	int *slot;
+	/**
+	 * Index of the object on each slot (or, for free slots, the next free
+	 *slot)
+	 */
+	int *index;
+	/**
+	 * Current generation of each slot
+	 */
+	int *generation;
+	/**
+	 * First free slot (-1 if none)
+	 */
+	int free_slot;
+	/**
+	 * How many objects there are (always stored on the first indexes)
+	 */
+	int num;
+	/**
+	 * How many objects fit on the pool
+	 */
+	int max;
+	/**
+	 * Memory where every array is stored
+	 */
+	void *mem;
+};
+typedef struct stGFraMe_object_pool GFraMe_object_pool;
+
+/**
+ * Initialize a pool
+ * @param	*pool	Pool to be initialized
+ * @param	max	How many objects fit on the pool (at most 65536)
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_object_pool_init(GFraMe_object_pool *pool, int max);
+
+/**
+ * Release every memory used by the pool
+ * @param	*pool	The pool
+ */
+void GFraMe_object_pool_clear(GFraMe_object_pool *pool);
+
+/**
+ * Add an object to the pool
+ * @param	*pool	The pool
+ * @param	*obj	Object whose state is copied into the pool; if NULL, the
+ *			  new object is cleared
+ * @param	*handle	Returns the new object's handle
+ * @return	GFraMe_ret_ok - Success; GFraMe_buffer_too_small - Pool is full
+ */
+GFraMe_ret GFraMe_object_pool_add(GFraMe_object_pool *pool, GFraMe_object *obj,
+								  GFraMe_object_handle *handle);
+
+/**
+ * Remove an object from the pool; the last object is moved to its index
+ * @param	*pool	The pool
+ * @param	handle	The object
+ * @return	GFraMe_ret_ok - Success; GFraMe_ret_bad_param - Invalid handle
+ */
+GFraMe_ret GFraMe_object_pool_remove(GFraMe_object_pool *pool,
+									 GFraMe_object_handle handle);
+
+/**
+ * Get where an object is stored, so its arrays can be accessed directly; the
+ *index changes whenever an object is removed
+ * @param	*pool	The pool
+ * @param	handle	The object
+ * @return	The object's index or -1, if the handle is invalid
+ */
+int GFraMe_object_pool_get_index(GFraMe_object_pool *pool,
+								 GFraMe_object_handle handle);
+
+/**
+ * Get the handle of the object at an index
+ * @param	*pool	The pool
+ * @param	index	The object's index
+ * @return	The object's handle
+ */
+GFraMe_object_handle GFraMe_object_pool_get_handle(GFraMe_object_pool *pool,
+												   int index);
+
+/**
+ * Copy an object from the pool
+ * @param	*pool	The pool
+ * @param	handle	The object
+ * @param	*obj	Where the object is copied to (its tween is cleared)
+ * @return	GFraMe_ret_ok - Success; GFraMe_ret_bad_param - Invalid handle
+ */
+GFraMe_ret GFraMe_object_pool_load(GFraMe_object_pool *pool,
+								   GFraMe_object_handle handle,
+								   GFraMe_object *obj);
+
+/**
+ * Copy an object back into the pool (e.g., after being overlapped)
+ * @param	*pool	The pool
+ * @param	handle	The object
+ * @param	*obj	Object to be copied (its tween is ignored)
+ * @return	GFraMe_ret_ok - Success; GFraMe_ret_bad_param - Invalid handle
+ */
+GFraMe_ret GFraMe_object_pool_store(GFraMe_object_pool *pool,
+									GFraMe_object_handle handle,
+									GFraMe_object *obj);
+
+/**
+ * Sets an object position
+ * @param	*pool	The pool
+ * @param	handle	The object
+ * @param	X	New horizontal position
+ * @param	Y	New vertical position
+ */
+void GFraMe_object_pool_set_pos(GFraMe_object_pool *pool,
+								GFraMe_object_handle handle, int X, int Y);
+
+/**
+ * Sets an object velocity
+ * @param	*pool	The pool
+ * @param	handle	The object
+ * @param	vx	New horizontal velocity
+ * @param	vy	New vertical velocity
+ */
+void GFraMe_object_pool_set_velocity(GFraMe_object_pool *pool,
+									 GFraMe_object_handle handle,
+									 GFraMe_real vx, GFraMe_real vy);
+
+/**
+ * Sets an object acceleration
+ * @param	*pool	The pool
+ * @param	handle	The object
+ * @param	ax	New horizontal acceleration
+ * @param	ay	New vertical acceleration
+ */
+void GFraMe_object_pool_set_acceleration(GFraMe_object_pool *pool,
+										 GFraMe_object_handle handle,
+										 GFraMe_real ax, GFraMe_real ay);
+
+/**
+ * Updates every object's position, velocity and collision state, just like
+ *GFraMe_object_update
+ * @param	*pool	The pool
+ * @param	ms	How long this frame took
+ */
+void GFraMe_object_pool_update(GFraMe_object_pool *pool, int ms);
+
+#endif
+
@@ -19,9 +19,38 @@ void GFraMe_opengl_prepareRender();
 void GFraMe_opengl_setRotation(float rotation);
 void GFraMe_opengl_setScale(float sX, float sY);
 void GFraMe_opengl_setAlpha(float alpha);
+/**
+ * Set how sprites are blended
+ * @param	mode	A GFraMe_blend (from GFraMe_renderqueue.h)
+ */
+void GFraMe_opengl_setBlend(int mode);
 
 void GFraMe_opengl_renderSprite(int x, int y, int dx, int dy, int tx, int ty);
 
 void GFraMe_opengl_doRender();
 
+/**
+ * Get the renderer's counters (since the last reset)
+ * @param	*issued	Returns how many state changes reached the driver
+ * @param	*elided	Returns how many state changes were skipped, as they
+ *		  wouldn't change anything
+ * @param	*draws	Returns how many draw calls were made
+ */
+void GFraMe_opengl_getStats(int *issued, int *elided, int *draws);
+
+/**
+ * Zero the renderer's counters
+ */
+void GFraMe_opengl_resetStats();
+
+/**
+ * Forget every GL state the renderer expects to be set (the bound program,
+ *textures, buffers, blend mode, viewport...), so it's all set again. Call it
+ *whenever anything other than GFraMe makes GL calls (e.g., another library
+ *drawing its own interface), after those calls and before the next
+ *GFraMe_opengl_prepareRender; since sprites are only drawn on
+ *GFraMe_opengl_doRender, no GL call should be made in between
+ */
+void GFraMe_opengl_invalidateState();
+
 #endif
@@ -0,0 +1,170 @@
+/**
+ * @include/GFraMe/GFraMe_quadtree.h
+ *
+ * Quadtree for objects that never move (e.g., level geometry and pickups).
+ *It's built only once and then queried for every object on a region, on a
+ *point or along a ray. Objects that cross a node's center are kept on that
+ *node, so each object is stored (and reported) only once.
+ */
+#ifndef __GFRAME_QUADTREE_H
+#define __GFRAME_QUADTREE_H
+
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_object.h>
+#include <GFraMe/GFraMe_tilemap.h>
+
+/**
+ * Axis aligned box, in world space
+ */
+struct stGFraMe_quadtree_box {
+	double x0;
+	double y0;
+	double x1;
+	double y1;
+};
+typedef struct stGFraMe_quadtree_box GFraMe_quadtree_box;
+
+struct stGFraMe_quadtree_node {
+	/**
+	 * Area covered by the node
+	 */
+	GFraMe_quadtree_box bounds;
+	/**
+	 * Index of the first of its four children (-1, if it's a leaf)
+	 */
+	int child;
+	/**
+	 * Index of the node's first object
+	 */
+	int first;
+	/**
+	 * How many objects are on this node (not counting its children)
+	 */
+	int count;
+};
+typedef struct stGFraMe_quadtree_node GFraMe_quadtree_node;
+
+struct stGFraMe_quadtree {
+	/**
+	 * Every node; the first one is the root
+	 */
+	GFraMe_quadtree_node *nodes;
+	/**
+	 * How many nodes are in use
+	 */
+	int num_nodes;
+	/**
+	 * How many nodes fit on the array
+	 */
+	int max_nodes;
+	/**
+	 * Every object, sorted by node
+	 */
+	GFraMe_object **objs;
+	/**
+	 * Each object's hitbox, when the quadtree was built
+	 */
+	GFraMe_quadtree_box *boxes;
+	/**
+	 * How many objects there are
+	 */
+	int num_objs;
+	/**
+	 * A node is only split if it has more objects than this
+	 */
+	int max_per_node;
+	/**
+	 * How deep the quadtree may get
+	 */
+	int max_depth;
+};
+typedef struct stGFraMe_quadtree GFraMe_quadtree;
+
+/**
+ * Build a quadtree from some objects; they mustn't move nor be released
+ *until the quadtree is cleared
+ * @param	*qt	Quadtree to be initialized
+ * @param	**objs	The objects
+ * @param	num	How many objects there are
+ * @param	max_per_node	Nodes with more objects than this are split
+ * @param	max_depth	How deep the quadtree may get
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_quadtree_init(GFraMe_quadtree *qt, GFraMe_object **objs,
+								int num, int max_per_node, int max_depth);
+
+/**
+ * Build a quadtree from a tilemap's boxes; it must be built again whenever
+ *a tile is changed
+ * @param	*qt	Quadtree to be initialized
+ * @param	*tmap	The tilemap
+ * @param	max_per_node	Nodes with more objects than this are split
+ * @param	max_depth	How deep the quadtree may get
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_quadtree_init_tilemap(GFraMe_quadtree *qt,
+										GFraMe_tilemap *tmap,
+										int max_per_node, int max_depth);
+
+/**
+ * Release every memory used by the quadtree
+ * @param	*qt	The quadtree
+ */
+void GFraMe_quadtree_clear(GFraMe_quadtree *qt);
+
+/**
+ * Retrieve every object that overlaps a rectangle
+ * @param	*qt	The quadtree
+ * @param	x	Rectangle's left position
+ * @param	y	Rectangle's top position
+ * @param	w	Rectangle's width
+ * @param	h	Rectangle's height
+ * @param	**out	Array where the objects are returned
+ * @param	max	How many objects fit on the array
+ * @return	How many objects were found (may be greater than max)
+ */
+int GFraMe_quadtree_query_rect(GFraMe_quadtree *qt, double x, double y,
+							   double w, double h, GFraMe_object **out,
+							   int max);
+
+/**
+ * Retrieve every object that contains a point (e.g., the pointer, after
+ *GFraMe_screen_point_to_world)
+ * @param	*qt	The quadtree
+ * @param	x	Point's horizontal position
+ * @param	y	Point's vertical position
+ * @param	**out	Array where the objects are returned
+ * @param	max	How many objects fit on the array
+ * @return	How many objects were found (may be greater than max)
+ */
+int GFraMe_quadtree_query_point(GFraMe_quadtree *qt, double x, double y,
+								GFraMe_object **out, int max);
+
+/**
+ * Find the first object hit by a segment
+ * @param	*qt	The quadtree
+ * @param	x0	Segment's starting horizontal position
+ * @param	y0	Segment's starting vertical position
+ * @param	x1	Segment's ending horizontal position
+ * @param	y1	Segment's ending vertical position
+ * @param	*time	Returns the fraction of the segment (in [0, 1]) where the
+ *			  object was hit (may be NULL)
+ * @return	The object hit or NULL, if none
+ */
+GFraMe_object* GFraMe_quadtree_raycast(GFraMe_quadtree *qt, double x0,
+									   double y0, double x1, double y1,
+									   double *time);
+
+/**
+ * Overlap (through GFraMe_object_overlap) an object against every object on
+ *the quadtree that it may touch and whose layers match its own
+ * @param	*qt	The quadtree
+ * @param	*obj	The object
+ * @param	mode	How collision should be handle ('obj' is the first object)
+ * @return	How many objects overlapped
+ */
+int GFraMe_quadtree_overlap(GFraMe_quadtree *qt, GFraMe_object *obj,
+							GFraMe_collision_type mode);
+
+#endif
+
@@ -0,0 +1,215 @@
+/**
+ * @include/GFraMe/GFraMe_renderqueue.h
+ *
+ * Queue of draw commands. Instead of drawing as soon as game code asks for it,
+ *commands are pushed with a layer and a depth and, at the end of the frame,
+ *they are sorted (by a 64 bit key) and flushed; consecutive commands with the
+ *same state (texture, blend mode, alpha, scale and rotation) are drawn without
+ *setting it again.
+ * Layers are drawn from the lowest to the highest and, by default, keep the
+ *painter's order: commands are drawn by depth and, on the same depth, in the
+ *order they were pushed. Layers whose commands don't overlap (or whose order
+ *doesn't matter, e.g. particles) may be set as sorted, so their commands are
+ *grouped by state instead.
+ */
+#ifndef __GFRAME_RENDERQUEUE_H
+#define __GFRAME_RENDERQUEUE_H
+
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_sprite.h>
+#include <GFraMe/GFraMe_spriteset.h>
+#include <GFraMe/GFraMe_texture.h>
+#include <stdint.h>
+
+/**
+ * How many layers there are
+ */
+#define GFRAME_RENDERQUEUE_LAYERS 256
+/**
+ * How many different textures may be used on a single frame
+ */
+#define GFRAME_RENDERQUEUE_TEXTURES 4096
+/**
+ * Range of depths (lower ones are drawn first)
+ */
+#define GFRAME_RENDERQUEUE_DEPTH_MIN (-32768)
+#define GFRAME_RENDERQUEUE_DEPTH_MAX 32767
+
+/**
+ * How a command is blended into what was already drawn
+ */
+enum enGFraMe_blend {
+	GFraMe_blend_alpha = 0,
+	GFraMe_blend_add,
+	GFraMe_blend_mod,
+	GFraMe_blend_none,
+	GFraMe_blend_max
+};
+typedef enum enGFraMe_blend GFraMe_blend;
+
+/**
+ * A single tile to be drawn
+ */
+struct stGFraMe_rendercmd {
+	/**
+	 * Spriteset used to render
+	 */
+	GFraMe_spriteset *sset;
+	/**
+	 * Index from the spriteset to be used
+	 */
+	int tile;
+	/**
+	 * Horizontal position, on the screen
+	 */
+	int x;
+	/**
+	 * Vertical position, on the screen
+	 */
+	int y;
+	/**
+	 * Whether the tile should be drawn flipped or not
+	 */
+	int flipped;
+	float scale_x;
+	float scale_y;
+	float angle;
+	float alpha;
+	GFraMe_blend blend;
+};
+typedef struct stGFraMe_rendercmd GFraMe_rendercmd;
+
+/**
+ * A texture used on the current frame, and the state last set on it
+ */
+struct stGFraMe_renderqueue_tex {
+	GFraMe_texture *tex;
+	GFraMe_blend blend;
+	float alpha;
+};
+typedef struct stGFraMe_renderqueue_tex GFraMe_renderqueue_tex;
+
+struct stGFraMe_renderqueue {
+	/**
+	 * Every command pushed on this frame
+	 */
+	GFraMe_rendercmd *cmds;
+	/**
+	 * Sort key of each command
+	 */
+	uint64_t *keys;
+	/**
+	 * Index of the command of each key
+	 */
+	int *order;
+	/**
+	 * Buffers used while sorting
+	 */
+	uint64_t *tmp_keys;
+	int *tmp_order;
+	/**
+	 * How many commands were pushed
+	 */
+	int num;
+	/**
+	 * How many commands fit on the queue
+	 */
+	int max;
+	/**
+	 * Textures used on this frame (the index is used on the keys)
+	 */
+	GFraMe_renderqueue_tex *textures;
+	/**
+	 * How many textures were used
+	 */
+	int num_textures;
+	/**
+	 * Texture found on the last lookup
+	 */
+	int last_texture;
+	/**
+	 * Whether each layer is sorted by state (instead of by painter's order)
+	 */
+	unsigned char sorted[GFRAME_RENDERQUEUE_LAYERS];
+};
+typedef struct stGFraMe_renderqueue GFraMe_renderqueue;
+
+/**
+ * Initialize a queue
+ * @param	*queue	Queue to be initialized
+ * @param	max	How many commands may be pushed on a frame (at most 2^24)
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_renderqueue_init(GFraMe_renderqueue *queue, int max);
+
+/**
+ * Release every memory used by the queue
+ * @param	*queue	The queue
+ */
+void GFraMe_renderqueue_clear(GFraMe_renderqueue *queue);
+
+/**
+ * Drop every command without drawing them
+ * @param	*queue	The queue
+ */
+void GFraMe_renderqueue_reset(GFraMe_renderqueue *queue);
+
+/**
+ * Set whether a layer is sorted by state or drawn on painter's order; only
+ *affects commands pushed afterward
+ * @param	*queue	The queue
+ * @param	layer	The layer
+ * @param	sorted	1 - Group commands by state; 0 - Keep painter's order
+ */
+void GFraMe_renderqueue_set_layer_sorted(GFraMe_renderqueue *queue,
+										 int layer, int sorted);
+
+/**
+ * Push a command
+ * @param	*queue	The queue
+ * @param	layer	Layer, in [0, GFRAME_RENDERQUEUE_LAYERS)
+ * @param	depth	Depth within the layer (clamped to the valid range)
+ * @param	*cmd	The command (copied into the queue)
+ * @return	GFraMe_ret_ok - Success; GFraMe_buffer_too_small - Queue is full
+ *		  (or too many textures); GFraMe_ret_bad_param - Invalid layer
+ */
+GFraMe_ret GFraMe_renderqueue_push(GFraMe_renderqueue *queue, int layer,
+								   int depth, GFraMe_rendercmd *cmd);
+
+/**
+ * Set a command to draw a sprite at its current position, as
+ *GFraMe_sprite_draw would draw it
+ * NOTE unlike GFraMe_sprite_draw, the sprite's scale and alpha are also
+ *applied when not using OpenGL (its angle still isn't)
+ * @param	*cmd	The command
+ * @param	*spr	The sprite
+ * @param	blend	How the sprite is blended
+ */
+void GFraMe_rendercmd_set_sprite(GFraMe_rendercmd *cmd, GFraMe_sprite *spr,
+								 GFraMe_blend blend);
+
+/**
+ * Push a sprite at its current position, as GFraMe_sprite_draw would draw it
+ * NOTE unlike GFraMe_sprite_draw, the sprite's scale and alpha are also
+ *applied when not using OpenGL (its angle still isn't)
+ * @param	*queue	The queue
+ * @param	layer	Layer, in [0, GFRAME_RENDERQUEUE_LAYERS)
+ * @param	depth	Depth within the layer (clamped to the valid range)
+ * @param	*spr	The sprite
+ * @param	blend	How the sprite is blended
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_renderqueue_push_sprite(GFraMe_renderqueue *queue,
+										  int layer, int depth,
+										  GFraMe_sprite *spr,
+										  GFraMe_blend blend);
+
+/**
+ * Sort every command, draw them and empty the queue
+ * @param	*queue	The queue
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_renderqueue_flush(GFraMe_renderqueue *queue);
+
+#endif
+
@@ -0,0 +1,208 @@
+/**
+ * @include/GFraMe/GFraMe_spatialhash.h
+ *
+ * Uniform grid broad phase. Objects are registered once and, after being
+ *updated, the grid is rebuilt from their hitboxes; only objects that share a
+ *cell are then overlapped against each other.
+ */
+#ifndef __GFRAME_SPATIALHASH_H
+#define __GFRAME_SPATIALHASH_H
+
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_object.h>
+
+/**
+ * Called for every pair that overlapped on GFraMe_spatialhash_collide
+ * @param	*o1	One of the objects that overlapped
+ * @param	*o2	The other object
+ * @param	*ctx	Pointer passed to GFraMe_spatialhash_collide
+ */
+typedef void (*GFraMe_spatialhash_callback)(GFraMe_object *o1,
+											GFraMe_object *o2, void *ctx);
+
+/**
+ * An object inside a cell; cells are stored contiguously per bucket
+ */
+struct stGFraMe_spatialhash_node {
+	/**
+	 * Index of the object on the objs array (-1, if it was removed)
+	 */
+	int obj;
+	/**
+	 * Horizontal cell position
+	 */
+	int cx;
+	/**
+	 * Vertical cell position
+	 */
+	int cy;
+};
+typedef struct stGFraMe_spatialhash_node GFraMe_spatialhash_node;
+
+/**
+ * Cells touched by an object, as of the last update
+ */
+struct stGFraMe_spatialhash_range {
+	int x0;
+	int y0;
+	int x1;
+	int y1;
+};
+typedef struct stGFraMe_spatialhash_range GFraMe_spatialhash_range;
+
+struct stGFraMe_spatialhash {
+	/**
+	 * Width of each cell, in pixels
+	 */
+	int cell_w;
+	/**
+	 * Height of each cell, in pixels
+	 */
+	int cell_h;
+	/**
+	 * How many buckets there are (always a power of two)
+	 */
+	int num_buckets;
+	/**
+	 * Where each bucket starts on the nodes array (num_buckets + 1 entries)
+	 */
+	int *bucket_start;
+	/**
+	 * Every object/cell pair, sorted by bucket
+	 */
+	GFraMe_spatialhash_node *nodes;
+	/**
+	 * How many nodes were used on the last update
+	 */
+	int num_nodes;
+	/**
+	 * How many nodes fit on the nodes array
+	 */
+	int max_nodes;
+	/**
+	 * Every registered object
+	 */
+	GFraMe_object **objs;
+	/**
+	 * Cells touched by each registered object
+	 */
+	GFraMe_spatialhash_range *ranges;
+	/**
+	 * Last query that reported each object (avoids duplicated neighbours)
+	 */
+	unsigned int *stamps;
+	/**
+	 * Current query number
+	 */
+	unsigned int cur_stamp;
+	/**
+	 * How many objects are registered
+	 */
+	int num_objs;
+	/**
+	 * How many objects can be registered
+	 */
+	int max_objs;
+	/**
+	 * How many objects were registered on the last update (only those have
+	 *nodes)
+	 */
+	int num_indexed;
+};
+typedef struct stGFraMe_spatialhash GFraMe_spatialhash;
+
+/**
+ * Initialize a spatial hash; a good cell size is about twice the size of the
+ *usual object
+ * @param	*sh	Spatial hash to be initialized
+ * @param	cell_w	Width of each cell
+ * @param	cell_h	Height of each cell
+ * @param	num_buckets	How many buckets to use (rounded up to a power of two)
+ * @param	max_objs	How many objects may be registered
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_spatialhash_init(GFraMe_spatialhash *sh, int cell_w,
+								   int cell_h, int num_buckets, int max_objs);
+
+/**
+ * Release every memory used by the spatial hash
+ * @param	*sh	The spatial hash
+ */
+void GFraMe_spatialhash_clear(GFraMe_spatialhash *sh);
+
+/**
+ * Remove every registered object
+ * @param	*sh	The spatial hash
+ */
+void GFraMe_spatialhash_reset(GFraMe_spatialhash *sh);
+
+/**
+ * Register an object; it will only be found after the next update
+ * @param	*sh	The spatial hash
+ * @param	*obj	Object to be registered
+ * @return	GFraMe_ret_ok - Success; GFraMe_buffer_too_small - Too many objects
+ */
+GFraMe_ret GFraMe_spatialhash_add(GFraMe_spatialhash *sh, GFraMe_object *obj);
+
+/**
+ * Unregister an object (the last registered object takes its place); it's
+ *immediately removed from the grid, so queries won't find it anymore
+ * @param	*sh	The spatial hash
+ * @param	*obj	Object to be removed
+ * @return	GFraMe_ret_ok - Success; GFraMe_ret_failed - Object not found
+ */
+GFraMe_ret GFraMe_spatialhash_remove(GFraMe_spatialhash *sh,
+									 GFraMe_object *obj);
+
+/**
+ * Rebuild the grid from the objects' current hitboxes; call this after every
+ *registered object was updated
+ * @param	*sh	The spatial hash
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_spatialhash_update(GFraMe_spatialhash *sh);
+
+/**
+ * Retrieve every object that shares a cell with the given rectangle; each
+ *object is reported only once
+ * @param	*sh	The spatial hash
+ * @param	x	Rectangle's left position
+ * @param	y	Rectangle's top position
+ * @param	w	Rectangle's width
+ * @param	h	Rectangle's height
+ * @param	**out	Array where the objects are returned
+ * @param	max	How many objects fit on the array
+ * @return	How many objects were found (may be greater than max)
+ */
+int GFraMe_spatialhash_query_rect(GFraMe_spatialhash *sh, double x, double y,
+								  double w, double h, GFraMe_object **out,
+								  int max);
+
+/**
+ * Retrieve every object that shares a cell with another (which is itself
+ *skipped, as are objects whose layers don't match its own); each object is
+ *reported only once
+ * @param	*sh	The spatial hash
+ * @param	*obj	The object
+ * @param	**out	Array where the objects are returned
+ * @param	max	How many objects fit on the array
+ * @return	How many objects were found (may be greater than max)
+ */
+int GFraMe_spatialhash_query(GFraMe_spatialhash *sh, GFraMe_object *obj,
+							 GFraMe_object **out, int max);
+
+/**
+ * Overlap (through GFraMe_object_overlap) every pair of objects that share a
+ *cell and whose layers match; each pair is tested only once
+ * @param	*sh	The spatial hash
+ * @param	mode	How collision should be handle
+ * @param	cb	Called for every pair that overlapped (may be NULL)
+ * @param	*ctx	Passed to the callback
+ * @return	How many pairs overlapped
+ */
+int GFraMe_spatialhash_collide(GFraMe_spatialhash *sh,
+							   GFraMe_collision_type mode,
+							   GFraMe_spatialhash_callback cb, void *ctx);
+
+#endif
+
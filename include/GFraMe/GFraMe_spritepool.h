@@ -0,0 +1,192 @@
+/**
+ * @include/GFraMe/GFraMe_spritepool.h
+ *
+ * Pool of sprites (e.g., enemies or bullets). Live sprites are packed on the
+ *first indexes of the array, so updating and drawing only touches those; a
+ *free list makes spawning and despawning constant time. Since despawning moves
+ *the last sprite into the removed one's place, sprites should be kept by
+ *handle (which stays valid until the sprite is despawned) instead of by
+ *pointer.
+ * Each sprite also has an animation player (see GFraMe_spritepool_play), which
+ *are all updated at once and only change the sprite's tile when a new one is
+ *issued.
+ */
+#ifndef __GFRAME_SPRITEPOOL_H
+#define __GFRAME_SPRITEPOOL_H
+
+#include <GFraMe/GFraMe_animation.h>
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_renderqueue.h>
+#include <GFraMe/GFraMe_sprite.h>
+
+/**
+ * Reference to a sprite on a pool; the lower 16 bits are the sprite's slot
+ *and the rest is incremented whenever the slot is reused
+ */
+typedef int GFraMe_sprite_handle;
+
+/**
+ * Never a valid handle
+ */
+#define GFraMe_sprite_handle_none (-1)
+
+struct stGFraMe_spritepool {
+	/**
+	 * Every sprite; only the first 'num' are alive
+	 */
+	GFraMe_sprite *sprites;
+	/**
+	 * Animation player of each sprite (on the same index)
+	 */
+	GFraMe_animplayer *players;
+	/**
+	 * Buffer with the sprites whose tile changed on an update
+	 */
+	int *changed;
+	/**
+	 * Slot of the sprite at each index
+	 */
+	int *slot;
+	/**
+	 * Index of the sprite on each slot (or, for free slots, the next free
+	 *slot)
+	 */
+	int *index;
+	/**
+	 * Current generation of each slot
+	 */
+	int *generation;
+	/**
+	 * First free slot (-1 if none)
+	 */
+	int free_slot;
+	/**
+	 * How many sprites are alive
+	 */
+	int num;
+	/**
+	 * How many sprites fit on the pool
+	 */
+	int max;
+};
+typedef struct stGFraMe_spritepool GFraMe_spritepool;
+
+/**
+ * Initialize a pool
+ * @param	*pool	Pool to be initialized
+ * @param	max	How many sprites fit on the pool (at most 65536)
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_spritepool_init(GFraMe_spritepool *pool, int max);
+
+/**
+ * Release every memory used by the pool
+ * @param	*pool	The pool
+ */
+void GFraMe_spritepool_clear(GFraMe_spritepool *pool);
+
+/**
+ * Despawn every sprite (invalidating their handles)
+ * @param	*pool	The pool
+ */
+void GFraMe_spritepool_reset(GFraMe_spritepool *pool);
+
+/**
+ * Get a new sprite from the pool; it must be initialized (e.g., with
+ *GFraMe_sprite_init) by the caller
+ * @param	*pool	The pool
+ * @param	*handle	Returns the sprite's handle (may be NULL)
+ * @return	The new sprite (only valid until some sprite is despawned) or
+ *		  NULL, if the pool is full
+ */
+GFraMe_sprite* GFraMe_spritepool_spawn(GFraMe_spritepool *pool,
+									   GFraMe_sprite_handle *handle);
+
+/**
+ * Return a sprite to the pool; the last sprite is moved to its index
+ * @param	*pool	The pool
+ * @param	handle	The sprite
+ * @return	GFraMe_ret_ok - Success; GFraMe_ret_bad_param - Invalid handle
+ */
+GFraMe_ret GFraMe_spritepool_despawn(GFraMe_spritepool *pool,
+									 GFraMe_sprite_handle handle);
+
+/**
+ * Return the sprite at an index to the pool; when despawning while iterating,
+ *iterate from the last index to the first, so no sprite is skipped
+ * @param	*pool	The pool
+ * @param	index	The sprite's index
+ * @return	GFraMe_ret_ok - Success; GFraMe_ret_bad_param - Invalid index
+ */
+GFraMe_ret GFraMe_spritepool_despawn_index(GFraMe_spritepool *pool,
+										   int index);
+
+/**
+ * Get a sprite by its handle
+ * @param	*pool	The pool
+ * @param	handle	The sprite
+ * @return	The sprite (only valid until some sprite is despawned) or NULL, if
+ *		  the handle is invalid
+ */
+GFraMe_sprite* GFraMe_spritepool_get(GFraMe_spritepool *pool,
+									 GFraMe_sprite_handle handle);
+
+/**
+ * Get the handle of the sprite at an index
+ * @param	*pool	The pool
+ * @param	index	The sprite's index
+ * @return	The sprite's handle
+ */
+GFraMe_sprite_handle GFraMe_spritepool_get_handle(GFraMe_spritepool *pool,
+												  int index);
+
+/**
+ * Play an animation on a sprite (from its first frame)
+ * @param	*pool	The pool
+ * @param	handle	The sprite
+ * @param	*def	Animation to be played (NULL stops the current one)
+ * @return	GFraMe_ret_ok - Success; GFraMe_ret_bad_param - Invalid handle
+ */
+GFraMe_ret GFraMe_spritepool_play(GFraMe_spritepool *pool,
+								  GFraMe_sprite_handle handle,
+								  GFraMe_animdef const *def);
+
+/**
+ * Get a sprite's animation player
+ * @param	*pool	The pool
+ * @param	handle	The sprite
+ * @return	The player (only valid until some sprite is despawned) or NULL, if
+ *		  the handle is invalid
+ */
+GFraMe_animplayer* GFraMe_spritepool_get_player(GFraMe_spritepool *pool,
+												GFraMe_sprite_handle handle);
+
+/**
+ * Update every live sprite that is active, then every sprite's animation
+ *player (even if the sprite is inactive)
+ * @param	*pool	The pool
+ * @param	ms	Elapsed time from previous frame (in milliseconds)
+ */
+void GFraMe_spritepool_update_all(GFraMe_spritepool *pool, int ms);
+
+/**
+ * Draw every live sprite that is visible
+ * @param	*pool	The pool
+ */
+void GFraMe_spritepool_draw_all(GFraMe_spritepool *pool);
+
+/**
+ * Push every live sprite that is visible into a render queue
+ * @param	*pool	The pool
+ * @param	*queue	The render queue
+ * @param	layer	Layer where the sprites are pushed
+ * @param	depth	Depth of every sprite within the layer
+ * @param	blend	How the sprites are blended
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_spritepool_submit(GFraMe_spritepool *pool,
+									GFraMe_renderqueue *queue, int layer,
+									int depth, GFraMe_blend blend);
+
+#endif
+
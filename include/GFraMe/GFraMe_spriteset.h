@@ -7,6 +7,11 @@
 #include <GFraMe/GFraMe_error.h>
 #include <GFraMe/GFraMe_texture.h>
 
+/**
+ * Index of a tile on a spriteset, as stored on tilemaps
+ */
+typedef unsigned short GFraMe_tile;
+
 /**
  * Helper struct to enable rendering from an index (the tile)
  */
@@ -89,5 +94,18 @@ GFraMe_ret GFraMe_spriteset_draw(GFraMe_spriteset *sset, int tile, int x,
 GFraMe_ret GFraMe_spriteset_draw_ex(GFraMe_spriteset *sset, int tile,
 	GFraMe_ssetRenderCtx *ctx);
 
+/**
+ * Render a horizontal run of tiles, next to each other, to the screen
+ * @param	*sset	Spriteset used to render
+ * @param	*tiles	Index of each tile
+ * @param	num	How many tiles there are
+ * @param	x	Horizontal position of the first tile, on the screen
+ * @param	y	Vertical position, on the screen
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_spriteset_draw_span(GFraMe_spriteset *sset,
+									  GFraMe_tile const *tiles, int num,
+									  int x, int y);
+
 #endif
 
@@ -0,0 +1,203 @@
+/**
+ * @include/GFraMe/GFraMe_sweepprune.h
+ *
+ * Sweep and prune broad phase. The objects' horizontal bounds are kept sorted
+ *between frames, so (as objects usually move only a little each frame) the
+ *insertion sort done on every update is almost linear. Every pair whose bounds
+ *started/stopped overlapping is found while sorting, and its vertical bounds
+ *are checked afterwards.
+ */
+#ifndef __GFRAME_SWEEPPRUNE_H
+#define __GFRAME_SWEEPPRUNE_H
+
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_object.h>
+
+/**
+ * What happened to a pair of objects
+ */
+enum enGFraMe_sweepprune_event {
+	/**
+	 * The objects just started overlapping
+	 */
+	GFraMe_sweepprune_begin = 0,
+	/**
+	 * The objects were already overlapping on the previous update
+	 */
+	GFraMe_sweepprune_persist,
+	/**
+	 * The objects stopped overlapping
+	 */
+	GFraMe_sweepprune_end
+};
+typedef enum enGFraMe_sweepprune_event GFraMe_sweepprune_event;
+
+/**
+ * Called for every reported pair on GFraMe_sweepprune_update
+ * @param	*o1	The object added first
+ * @param	*o2	The object added last
+ * @param	ev	What happened to the pair
+ * @param	*ctx	Pointer passed to GFraMe_sweepprune_update
+ */
+typedef void (*GFraMe_sweepprune_callback)(GFraMe_object *o1,
+										   GFraMe_object *o2,
+										   GFraMe_sweepprune_event ev,
+										   void *ctx);
+
+/**
+ * Either the left or the right bound of an object
+ */
+struct stGFraMe_sweepprune_endpoint {
+	/**
+	 * Horizontal position
+	 */
+	GFraMe_real val;
+	/**
+	 * Object's slot, shifted left by one, OR'ed with whether it's the right
+	 *bound
+	 */
+	int data;
+};
+typedef struct stGFraMe_sweepprune_endpoint GFraMe_sweepprune_endpoint;
+
+/**
+ * Pair of objects whose horizontal bounds overlap
+ */
+struct stGFraMe_sweepprune_pair {
+	/**
+	 * Smaller slot
+	 */
+	int a;
+	/**
+	 * Greater slot
+	 */
+	int b;
+	/**
+	 * Whether the objects were overlapping on both axis on the last update
+	 */
+	int touching;
+};
+typedef struct stGFraMe_sweepprune_pair GFraMe_sweepprune_pair;
+
+/**
+ * Touching pair that was removed and must still be reported
+ */
+struct stGFraMe_sweepprune_ended {
+	GFraMe_object *o1;
+	GFraMe_object *o2;
+};
+typedef struct stGFraMe_sweepprune_ended GFraMe_sweepprune_ended;
+
+struct stGFraMe_sweepprune {
+	/**
+	 * Every object, by slot (NULL for free slots)
+	 */
+	GFraMe_object **objs;
+	/**
+	 * Order in which each slot was added (used to order reported pairs)
+	 */
+	unsigned int *order;
+	/**
+	 * Counter used to set order
+	 */
+	unsigned int next_order;
+	/**
+	 * How many slots there are
+	 */
+	int max_objs;
+	/**
+	 * Sorted endpoints
+	 */
+	GFraMe_sweepprune_endpoint *endpoints;
+	/**
+	 * How many endpoints are in use
+	 */
+	int num_endpoints;
+	/**
+	 * Every pair that overlaps horizontally
+	 */
+	GFraMe_sweepprune_pair *pairs;
+	/**
+	 * How many pairs are in use
+	 */
+	int num_pairs;
+	/**
+	 * How many pairs fit on the array
+	 */
+	int max_pairs;
+	/**
+	 * Hash table (with linear probing) of indexes into pairs (-1 if empty)
+	 */
+	int *table;
+	/**
+	 * Length of the table (always a power of two)
+	 */
+	int table_len;
+	/**
+	 * Touching pairs removed since the last update, still to be reported
+	 */
+	GFraMe_sweepprune_ended *ended;
+	/**
+	 * How many ended pairs there are
+	 */
+	int num_ended;
+	/**
+	 * How many ended pairs fit on the array
+	 */
+	int max_ended;
+};
+typedef struct stGFraMe_sweepprune GFraMe_sweepprune;
+
+/**
+ * Initialize a sweep and prune
+ * @param	*sap	Sweep and prune to be initialized
+ * @param	max_objs	How many objects may be added
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_sweepprune_init(GFraMe_sweepprune *sap, int max_objs);
+
+/**
+ * Release every memory used by the sweep and prune
+ * @param	*sap	The sweep and prune
+ */
+void GFraMe_sweepprune_clear(GFraMe_sweepprune *sap);
+
+/**
+ * Add an object; it's sorted into place on the next update
+ * @param	*sap	The sweep and prune
+ * @param	*obj	Object to be added
+ * @return	GFraMe_ret_ok - Success; GFraMe_buffer_too_small - Too many objects
+ */
+GFraMe_ret GFraMe_sweepprune_add(GFraMe_sweepprune *sap, GFraMe_object *obj);
+
+/**
+ * Remove an object; every pair it was touching is reported as ended on the
+ *next update
+ * @param	*sap	The sweep and prune
+ * @param	*obj	Object to be removed
+ * @return	GFraMe_ret_ok - Success; GFraMe_ret_failed - Object not found;
+ *		  GFraMe_ret_memory_error - Failed to store an ended pair (the object
+ *		  is kept, so it may be removed again)
+ */
+GFraMe_ret GFraMe_sweepprune_remove(GFraMe_sweepprune *sap,
+									GFraMe_object *obj);
+
+/**
+ * Re-sort every object's bounds and report what happened to every pair of
+ *overlapping objects; call it after every object was updated
+ * NOTE the callback shouldn't add nor remove objects
+ * NOTE pairs whose layers don't match are never reported; layers are only
+ *checked when a pair starts overlapping horizontally
+ * @param	*sap	The sweep and prune
+ * @param	cb	Called for every pair that began, persisted or ended
+ *			  overlapping (may be NULL)
+ * @param	*ctx	Passed to the callback
+ * @return	How many pairs are overlapping; negative on failure (the bounds are
+ *		  still sorted, but a pair that couldn't be stored is only found
+ *		  after it stops overlapping and overlaps again)
+ */
+int GFraMe_sweepprune_update(GFraMe_sweepprune *sap,
+							 GFraMe_sweepprune_callback cb, void *ctx);
+
+#endif
+
@@ -0,0 +1,181 @@
+/**
+ * @include/GFraMe/GFraMe_tilecache.h
+ *
+ * Opt-in cache for tilemaps that rarely change (e.g., backgrounds). The map
+ *is split into chunks, which are rendered into textures the first time they
+ *are seen; afterward, each visible chunk is drawn with a single copy. Tiles
+ *must be changed through the cache (GFraMe_tilecache_set_tile), so only the
+ *chunk that was touched is rendered again.
+ * At most 'max_chunks' textures are kept; when a new chunk is needed, the one
+ *that was drawn the longest time ago is reused, so huge maps only keep the
+ *area around the camera in memory.
+ * Animated tiles (see GFraMe_tilemap_add_anim) must be advanced through the
+ *cache (GFraMe_tilecache_update): only the chunks with a type whose frame
+ *actually changed are rendered again. Animating a type after the cache was
+ *created renders every chunk again.
+ * The cache only works on the SDL renderer. On the OpenGL backend nothing is
+ *cached (no texture is created) and drawing through the cache is exactly the
+ *same as GFraMe_tilemap_draw_camera, so it brings no benefit there; tiles are
+ *still batched into a few draw calls by the backend itself.
+ */
+#ifndef __GFRAME_TILECACHE_H
+#define __GFRAME_TILECACHE_H
+
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_texture.h>
+#include <GFraMe/GFraMe_tilemap.h>
+
+/**
+ * A texture with a rendered chunk
+ */
+struct stGFraMe_tilecache_slot {
+	/**
+	 * The texture
+	 */
+	GFraMe_texture tex;
+	/**
+	 * Chunk rendered into the texture
+	 */
+	int chunk;
+	/**
+	 * Last frame when the texture was drawn
+	 */
+	unsigned int last_frame;
+	/**
+	 * Animations on the chunk (bit 'i' is tmap->anims[i])
+	 */
+	unsigned int anims;
+};
+typedef struct stGFraMe_tilecache_slot GFraMe_tilecache_slot;
+
+struct stGFraMe_tilecache {
+	/**
+	 * Cached tilemap
+	 */
+	GFraMe_tilemap *tmap;
+	/**
+	 * Textures already created
+	 */
+	GFraMe_tilecache_slot *slots;
+	/**
+	 * How many textures were created
+	 */
+	int num_slots;
+	/**
+	 * How many textures may be created
+	 */
+	int max_slots;
+	/**
+	 * Texture with each chunk (or -1, if it isn't cached)
+	 */
+	int *chunk_slot;
+	/**
+	 * Whether each chunk must be rendered again
+	 */
+	unsigned char *dirty;
+	/**
+	 * Width of a chunk, in tiles
+	 */
+	int chunk_w;
+	/**
+	 * Height of a chunk, in tiles
+	 */
+	int chunk_h;
+	/**
+	 * How many chunks there are horizontally
+	 */
+	int chunks_x;
+	/**
+	 * How many chunks there are vertically
+	 */
+	int chunks_y;
+	/**
+	 * Incremented on every draw
+	 */
+	unsigned int frame;
+	/**
+	 * How many types were animated when the chunks were last checked
+	 */
+	int num_anims;
+	/**
+	 * Tilemap's anim_gen when the chunks were last checked
+	 */
+	unsigned int anim_gen;
+};
+typedef struct stGFraMe_tilecache GFraMe_tilecache;
+
+/**
+ * Initialize a cache; no texture is created until a chunk is drawn
+ * @param	*cache	Cache to be initialized
+ * @param	*tmap	Tilemap to be cached (must be already initialized)
+ * @param	chunk_w	Width of a chunk, in tiles
+ * @param	chunk_h	Height of a chunk, in tiles
+ * @param	max_chunks	How many chunks may be kept at once (0 keeps every
+ *			  chunk)
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_tilecache_init(GFraMe_tilecache *cache,
+								 GFraMe_tilemap *tmap, int chunk_w,
+								 int chunk_h, int max_chunks);
+
+/**
+ * Release every texture and memory used by the cache
+ * @param	*cache	The cache
+ */
+void GFraMe_tilecache_clear(GFraMe_tilecache *cache);
+
+/**
+ * Mark the chunk with a tile to be rendered again
+ * @param	*cache	The cache
+ * @param	tx	Tile's horizontal position (in tiles)
+ * @param	ty	Tile's vertical position (in tiles)
+ */
+void GFraMe_tilecache_invalidate(GFraMe_tilecache *cache, int tx, int ty);
+
+/**
+ * Mark every chunk to be rendered again
+ * @param	*cache	The cache
+ */
+void GFraMe_tilecache_invalidate_all(GFraMe_tilecache *cache);
+
+/**
+ * Change a tile on the cached tilemap (see GFraMe_tilemap_set_tile) and mark
+ *its chunk to be rendered again
+ * @param	*cache	The cache
+ * @param	tx	Tile's horizontal position (in tiles)
+ * @param	ty	Tile's vertical position (in tiles)
+ * @param	tile	The new tile
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_tilecache_set_tile(GFraMe_tilecache *cache, int tx, int ty,
+									 GFraMe_tile tile);
+
+/**
+ * Advance the tilemap's animations, marking only the chunks whose tiles
+ *changed to be rendered again
+ * @param	*cache	The cache
+ * @param	ms	Time elapsed, in milliseconds
+ */
+void GFraMe_tilecache_update(GFraMe_tilecache *cache, int ms);
+
+/**
+ * Draw the chunks visible by a camera, from world space into screen space
+ * @param	*cache	The cache
+ * @param	cam_x	The camera's horizontal position
+ * @param	cam_y	The camera's vertical position
+ * @param	cam_w	The camera's width
+ * @param	cam_h	The camera's height
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_tilecache_draw_camera(GFraMe_tilecache *cache, int cam_x,
+										int cam_y, int cam_w, int cam_h);
+
+/**
+ * Draw every chunk that is visible on the screen
+ * @param	*cache	The cache
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_tilecache_draw(GFraMe_tilecache *cache);
+
+#endif
+
@@ -0,0 +1,157 @@
+/**
+ * @include/GFraMe/GFraMe_tilefile.h
+ *
+ * Tilemaps stored on disk, memory-mapped when opened. The map is split into
+ *chunks and each chunk is RLE-compressed on its own; a chunk is only
+ *decompressed the first time one of its tiles is accessed, so opening a huge
+ *map is instant and only the regions actually used take memory. A region is
+ *usually copied into a buffer (GFraMe_tilefile_read) and used as a regular
+ *tilemap's data.
+ * On mobile, where assets can't be mapped, the (still compressed) file is read
+ *into memory instead.
+ *
+ * File layout (every field is little-endian):
+ *   0	"GFTM"
+ *   4	uint16 version (1)
+ *   6	uint16 chunk's width, in tiles
+ *   8	uint16 chunk's height, in tiles
+ *  10	uint16 reserved (0)
+ *  12	uint32 map's width, in tiles
+ *  16	uint32 map's height, in tiles
+ *  20	uint32 offset (from the start of the file) and uint32 size, in bytes,
+ *	  of each chunk, row by row
+ * Each chunk is a sequence of runs (uint16 count, uint16 tile) covering its
+ *tiles row by row; chunks on the right and bottom borders may be smaller.
+ */
+#ifndef __GFRAME_TILEFILE_H
+#define __GFRAME_TILEFILE_H
+
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_spriteset.h>
+#include <GFraMe/GFraMe_tilemap.h>
+
+/**
+ * Version of the file layout
+ */
+#define GFRAME_TILEFILE_VERSION 1
+
+struct stGFraMe_tilefile {
+	/**
+	 * The file's contents
+	 */
+	unsigned char const *buf;
+	/**
+	 * The file's size, in bytes
+	 */
+	unsigned long len;
+	/**
+	 * Whether the contents were mapped (or read into memory)
+	 */
+	int is_mapped;
+	/**
+	 * How many tiles there are horizontally
+	 */
+	int width_in_tiles;
+	/**
+	 * How many tiles there are vertically
+	 */
+	int height_in_tiles;
+	/**
+	 * Width of a chunk, in tiles
+	 */
+	int chunk_w;
+	/**
+	 * Height of a chunk, in tiles
+	 */
+	int chunk_h;
+	/**
+	 * How many chunks there are horizontally
+	 */
+	int chunks_x;
+	/**
+	 * How many chunks there are vertically
+	 */
+	int chunks_y;
+	/**
+	 * Every chunk already decompressed (NULL, if it wasn't accessed)
+	 */
+	GFraMe_tile **chunks;
+	/**
+	 * How many chunks are decompressed
+	 */
+	int num_loaded;
+};
+typedef struct stGFraMe_tilefile GFraMe_tilefile;
+
+/**
+ * Open a tilemap file (from the assets folder); only the chunk table is read
+ * @param	*file	File to be initialized
+ * @param	*filename	The file's name
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_tilefile_open(GFraMe_tilefile *file, char *filename);
+
+/**
+ * Unmap a file and release every decompressed chunk
+ * @param	*file	The file
+ */
+void GFraMe_tilefile_close(GFraMe_tilefile *file);
+
+/**
+ * Get a chunk's tiles, decompressing it on its first access
+ * @param	**tiles	Returns the chunk's tiles, row by row (a chunk on the
+ *		  borders is only as wide as the tiles within the map)
+ * @param	*file	The file
+ * @param	cx	Chunk's horizontal position (in chunks)
+ * @param	cy	Chunk's vertical position (in chunks)
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_tilefile_get_chunk(GFraMe_tile **tiles,
+									 GFraMe_tilefile *file, int cx, int cy);
+
+/**
+ * Release a decompressed chunk (it's decompressed again if accessed later)
+ * @param	*file	The file
+ * @param	cx	Chunk's horizontal position (in chunks)
+ * @param	cy	Chunk's vertical position (in chunks)
+ */
+void GFraMe_tilefile_release_chunk(GFraMe_tilefile *file, int cx, int cy);
+
+/**
+ * Get a single tile; tiles outside the map are empty
+ * @param	*tile	Returns the tile
+ * @param	*file	The file
+ * @param	tx	Tile's horizontal position (in tiles)
+ * @param	ty	Tile's vertical position (in tiles)
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_tilefile_get_tile(GFraMe_tile *tile, GFraMe_tilefile *file,
+									int tx, int ty);
+
+/**
+ * Copy a rectangle of tiles into a buffer, decompressing only the chunks it
+ *touches; tiles outside the map are empty
+ * @param	*dst	Buffer with (at least) rect->w * rect->h tiles
+ * @param	*file	The file
+ * @param	*rect	The tiles
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_tilefile_read(GFraMe_tile *dst, GFraMe_tilefile *file,
+								GFraMe_tilemap_rect *rect);
+
+/**
+ * Compress a tilemap into a file
+ * @param	*filename	The file's name (not within the assets folder)
+ * @param	*data	Every tile, row by row
+ * @param	width_in_tiles	How many tiles there are horizontally
+ * @param	height_in_tiles	How many tiles there are vertically
+ * @param	chunk_w	Width of a chunk, in tiles
+ * @param	chunk_h	Height of a chunk, in tiles
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_tilefile_write(char *filename, GFraMe_tile const *data,
+								 int width_in_tiles, int height_in_tiles,
+								 int chunk_w, int chunk_h);
+
+#endif
+
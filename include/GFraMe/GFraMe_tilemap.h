@@ -4,17 +4,117 @@
 #ifndef __GFRAME_TILEMAP_H
 #define __GFRAME_TILEMAP_H
 
+#include <GFraMe/GFraMe_animation.h>
 #include <GFraMe/GFraMe_object.h>
 #include <GFraMe/GFraMe_spriteset.h>
 
+/**
+ * How many tile types may be animated (so a mask with the animations on a
+ *region fits a single word)
+ */
+#define GFRAME_TILEMAP_ANIMS 32
+
+/**
+ * Area covered by a collision box, in tiles
+ */
+struct stGFraMe_tilemap_rect {
+	int x;
+	int y;
+	int w;
+	int h;
+};
+typedef struct stGFraMe_tilemap_rect GFraMe_tilemap_rect;
+
+/**
+ * Animation shared by every tile of a type
+ */
+struct stGFraMe_tilemap_anim {
+	/**
+	 * Animated tile type
+	 */
+	GFraMe_tile type;
+	/**
+	 * Animation played (its frames are the tiles drawn instead of the type)
+	 */
+	GFraMe_animdef const *def;
+	/**
+	 * Time since the animation started, in milliseconds
+	 */
+	int time;
+	/**
+	 * Value of the tilemap's anim_gen when this animation was last set
+	 */
+	unsigned int gen;
+};
+typedef struct stGFraMe_tilemap_anim GFraMe_tilemap_anim;
+
 struct stGFraMe_tilemap {
 	int x;
 	int y;
-	char *data;
+	/**
+	 * Every tile, row by row (tile 0 is empty)
+	 */
+	GFraMe_tile *data;
 	int width_in_tiles;
 	int height_in_tiles;
+	/**
+	 * Boxes covering every solid tile (static objects, so they can be
+	 *overlapped against); changing a tile may reorder them
+	 */
 	GFraMe_object *boxes;
+	/**
+	 * Tiles covered by each box
+	 */
+	GFraMe_tilemap_rect *rects;
+	/**
+	 * How many boxes there are
+	 */
+	int num_boxes;
+	/**
+	 * How many boxes fit on the arrays
+	 */
+	int max_boxes;
+	/**
+	 * Buffer used while merging tiles into boxes
+	 */
+	int *mesh_buf;
 	GFraMe_spriteset *sset;
+	/**
+	 * Bit table with which tile types are solid (32 types per word), only
+	 *as long as the greatest solid type requires
+	 */
+	unsigned int *solid;
+	/**
+	 * How many words there are on the solid table (types past it aren't
+	 *solid)
+	 */
+	int solid_len;
+	/**
+	 * Animated tile types; every tile of a type shares the same clock
+	 */
+	GFraMe_tilemap_anim anims[GFRAME_TILEMAP_ANIMS];
+	/**
+	 * How many tile types are animated
+	 */
+	int num_anims;
+	/**
+	 * Incremented every time an animation is set (so caches know which
+	 *chunks must be rendered again)
+	 */
+	unsigned int anim_gen;
+	/**
+	 * Tile currently drawn for each type (NULL, if no type is animated)
+	 */
+	GFraMe_tile *anim_tiles;
+	/**
+	 * Animation of each type, plus one (0, if the type isn't animated)
+	 */
+	unsigned char *anim_index;
+	/**
+	 * How many types fit on anim_tiles and anim_index (types past them
+	 *aren't animated)
+	 */
+	int anim_len;
 };
 typedef struct stGFraMe_tilemap GFraMe_tilemap;
 
@@ -23,20 +123,127 @@ typedef struct stGFraMe_tilemap GFraMe_tilemap;
  * @param	*tmap	Tilemap to be initialized
  * @param	width_in_tiles	How many tiles there are horizontally
  * @param	height_in_tiles	How many tiles there are vertically
- * @param	*data	Array of bytes with the tiles
+ * @param	*data	Array with the tiles
  * @param	*sset	Spriteset used to render the tilemap
- * @param	*collideable	Array with which tile types are solid
+ * @param	*collideable	Array with which tile types are solid (may be NULL)
  * @param	col_len	Length of the collideable array
  */
 GFraMe_ret GFraMe_tilemap_init(GFraMe_tilemap *tmap, int width_in_tiles,
-							   int height_in_tiles, char *data,
-							   GFraMe_spriteset *sset, char *collideable, 
+							   int height_in_tiles, GFraMe_tile *data,
+							   GFraMe_spriteset *sset, GFraMe_tile *collideable,
 							   int col_len);
 
 void GFraMe_tilemap_clear(GFraMe_tilemap *tmap);
 
+/**
+ * Set the tilemap's position, moving its boxes along
+ * @param	*tmap	The tilemap
+ * @param	X	New horizontal position
+ * @param	Y	New vertical position
+ */
+void GFraMe_tilemap_set_pos(GFraMe_tilemap *tmap, int X, int Y);
+
+/**
+ * Change a tile; if its solidity changed, only the boxes on the rows around it
+ *are rebuilt
+ * @param	*tmap	The tilemap
+ * @param	tx	Tile's horizontal position (in tiles)
+ * @param	ty	Tile's vertical position (in tiles)
+ * @param	tile	The new tile
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_tilemap_set_tile(GFraMe_tilemap *tmap, int tx, int ty,
+								   GFraMe_tile tile);
+
+/**
+ * Animate every tile of a type; only the drawn tile changes (collision still
+ *uses the type). Animating a type again restarts its clock
+ * @param	*tmap	The tilemap
+ * @param	type	The tile type
+ * @param	*def	Animation whose frames are drawn instead of the type (must
+ *		  outlive the tilemap)
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_tilemap_add_anim(GFraMe_tilemap *tmap, GFraMe_tile type,
+								   GFraMe_animdef const *def);
+
+/**
+ * Advance the clock of every animated type
+ * @param	*tmap	The tilemap
+ * @param	ms	Time elapsed, in milliseconds
+ * @return	Mask with the animations (bit 'i' is tmap->anims[i]) whose tile
+ *		  changed
+ */
+unsigned int GFraMe_tilemap_update_anims(GFraMe_tilemap *tmap, int ms);
+
+/**
+ * Find which animated types are on a rectangle of tiles
+ * @param	*tmap	The tilemap
+ * @param	*rect	The tiles (must be within the tilemap)
+ * @return	Mask with the animations (bit 'i' is tmap->anims[i]) found
+ */
+unsigned int GFraMe_tilemap_get_anims(GFraMe_tilemap *tmap,
+									  GFraMe_tilemap_rect *rect);
+
+/**
+ * Get the tile currently drawn for a type
+ * @param	*tmap	The tilemap
+ * @param	type	The tile type
+ * @return	The type's current frame (or the type itself, if not animated)
+ */
+int GFraMe_tilemap_get_drawn(GFraMe_tilemap *tmap, GFraMe_tile type);
+
+/**
+ * Draw every tile that is visible on the screen
+ * @param	*tmap	The tilemap
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
 GFraMe_ret GFraMe_tilemap_draw(GFraMe_tilemap *tmap);
 
+/**
+ * Draw a rectangle of tiles, row by row; each run of non-empty tiles is drawn
+ *at once (with the current frame of animated types)
+ * @param	*tmap	The tilemap
+ * @param	*rect	The tiles (must be within the tilemap)
+ * @param	x	Horizontal position of the rectangle's first tile, on the
+ *		  screen
+ * @param	y	Vertical position of the rectangle's first tile, on the screen
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_tilemap_draw_rect(GFraMe_tilemap *tmap,
+									GFraMe_tilemap_rect *rect, int x, int y);
+
+/**
+ * Draw the tiles visible by a camera, from world space into screen space; only
+ *the visible rows and columns are visited (row by row), and each run of
+ *non-empty tiles is drawn at once
+ * @param	*tmap	The tilemap
+ * @param	cam_x	The camera's horizontal position
+ * @param	cam_y	The camera's vertical position
+ * @param	cam_w	The camera's width
+ * @param	cam_h	The camera's height
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_tilemap_draw_camera(GFraMe_tilemap *tmap, int cam_x,
+									  int cam_y, int cam_w, int cam_h);
+
+/**
+ * Check whether a tile is solid; tiles outside the tilemap aren't
+ * @param	*tmap	The tilemap
+ * @param	tx	Tile's horizontal position (in tiles)
+ * @param	ty	Tile's vertical position (in tiles)
+ * @return	1 - Tile is solid; 0 - Otherwise
+ */
+int GFraMe_tilemap_is_solid(GFraMe_tilemap *tmap, int tx, int ty);
+
+/**
+ * Collide an object against the solid tiles it touched since its last update;
+ *only the object is moved (as on GFraMe_second_fixed) and edges shared by two
+ *solid tiles are ignored, so objects don't get stuck between tiles
+ * @param	*tmap	The tilemap
+ * @param	*obj	The object
+ * @return	GFraMe_ret_ok - Overlapped; GFraMe_ret_no_overlap - Otherwise
+ */
 GFraMe_ret GFraMe_tilemap_overlap(GFraMe_tilemap *tmap,GFraMe_object *obj);
 
 #endif
@@ -0,0 +1,249 @@
+/**
+ * @include/GFraMe/GFraMe_tilestream.h
+ *
+ * Tilemap too big to be kept in memory, streamed from a tilemap file (see
+ *GFraMe_tilefile). The world is split into regions and only the ones around
+ *the camera are resident; each one is a regular GFraMe_tilemap (with its own
+ *collision boxes), so it's drawn and collided through the usual tilemap
+ *functions.
+ * A background thread decodes the regions (and builds their boxes) nearest to
+ *the camera first; the main thread only swaps finished regions in, so loading
+ *never stalls a frame. Regions up to 'radius' regions away from the view are
+ *loaded, but they're only evicted (and their memory reused) once more than
+ *'radius' + 1 regions away, so regions on the edge aren't reloaded as the
+ *camera moves back and forth.
+ * Collision is resolved by each region separately, so edges shared by solid
+ *tiles on different regions aren't merged.
+ */
+#ifndef __GFRAME_TILESTREAM_H
+#define __GFRAME_TILESTREAM_H
+
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_object.h>
+#include <GFraMe/GFraMe_spriteset.h>
+#include <GFraMe/GFraMe_tilefile.h>
+#include <GFraMe/GFraMe_tilemap.h>
+#include <SDL2/SDL_mutex.h>
+#include <SDL2/SDL_thread.h>
+
+/**
+ * State of a region's slot
+ */
+enum enGFraMe_tilestream_state {
+	/**
+	 * Unused
+	 */
+	GFraMe_tilestream_free = 0,
+	/**
+	 * Waiting for the loader thread
+	 */
+	GFraMe_tilestream_queued,
+	/**
+	 * Being decoded by the loader thread
+	 */
+	GFraMe_tilestream_loading,
+	/**
+	 * Decoded, waiting to be swapped in by the main thread
+	 */
+	GFraMe_tilestream_ready,
+	/**
+	 * Swapped in (drawn and collided)
+	 */
+	GFraMe_tilestream_resident,
+	/**
+	 * Failed to be decoded (it's counted once, on num_failures, and only
+	 *retried after being evicted)
+	 */
+	GFraMe_tilestream_failed
+};
+typedef enum enGFraMe_tilestream_state GFraMe_tilestream_state;
+
+/**
+ * Memory for a single region; slots are reused as regions are evicted
+ */
+struct stGFraMe_tilestream_slot {
+	/**
+	 * The region's tilemap, on the world
+	 */
+	GFraMe_tilemap tmap;
+	/**
+	 * The region's tiles (as big as any region)
+	 */
+	GFraMe_tile *data;
+	/**
+	 * Region on the slot (-1, if free)
+	 */
+	int region;
+	/**
+	 * The slot's state (only accessed with the stream locked)
+	 */
+	GFraMe_tilestream_state state;
+};
+typedef struct stGFraMe_tilestream_slot GFraMe_tilestream_slot;
+
+struct stGFraMe_tilestream {
+	/**
+	 * File the regions are decoded from (only accessed by the loader)
+	 */
+	GFraMe_tilefile file;
+	/**
+	 * Spriteset used to render the regions
+	 */
+	GFraMe_spriteset *sset;
+	/**
+	 * Solid tile types
+	 */
+	GFraMe_tile *collideable;
+	/**
+	 * How many solid types there are
+	 */
+	int col_len;
+	/**
+	 * Width of a region, in tiles
+	 */
+	int region_w;
+	/**
+	 * Height of a region, in tiles
+	 */
+	int region_h;
+	/**
+	 * How many regions there are horizontally
+	 */
+	int regions_x;
+	/**
+	 * How many regions there are vertically
+	 */
+	int regions_y;
+	/**
+	 * How many regions around the view are loaded (they're kept until more
+	 *than radius + 1 regions away)
+	 */
+	int radius;
+	/**
+	 * Slot with each region (or -1, if it isn't loaded)
+	 */
+	int *region_slot;
+	/**
+	 * Every slot created
+	 */
+	GFraMe_tilestream_slot **slots;
+	/**
+	 * How many slots were created
+	 */
+	int num_slots;
+	/**
+	 * How many slots fit the array
+	 */
+	int max_slots;
+	/**
+	 * Region at the center of the view (so the nearest ones load first)
+	 */
+	int center_x;
+	int center_y;
+	/**
+	 * Loader thread
+	 */
+	SDL_Thread *thread;
+	/**
+	 * Guards the slots' states and the fields above
+	 */
+	SDL_mutex *mutex;
+	/**
+	 * Signaled whenever a region is queued (or the stream is cleared)
+	 */
+	SDL_cond *cond;
+	/**
+	 * Whether the loader should stop
+	 */
+	int quit;
+	/**
+	 * How many regions were loaded
+	 */
+	int num_loads;
+	/**
+	 * How many regions were evicted
+	 */
+	int num_evictions;
+	/**
+	 * How many updates had a visible region that wasn't resident yet (i.e.,
+	 *the camera moved faster than the loader; should stay 0); regions that
+	 *failed to load aren't counted
+	 */
+	int num_misses;
+	/**
+	 * How many regions failed to load
+	 */
+	int num_failures;
+};
+typedef struct stGFraMe_tilestream GFraMe_tilestream;
+
+/**
+ * Open a tilemap file and start the loader thread; no region is loaded until
+ *the first update
+ * @param	*stream	Stream to be initialized
+ * @param	*filename	The tilemap file (from the assets folder)
+ * @param	region_w	Width of a region, in tiles
+ * @param	region_h	Height of a region, in tiles
+ * @param	radius	How many regions around the view are loaded (they're kept
+ *		  until more than radius + 1 regions away)
+ * @param	*sset	Spriteset used to render the tilemap
+ * @param	*collideable	Array with which tile types are solid (may be NULL)
+ * @param	col_len	Length of the collideable array
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_tilestream_init(GFraMe_tilestream *stream, char *filename,
+								  int region_w, int region_h, int radius,
+								  GFraMe_spriteset *sset,
+								  GFraMe_tile *collideable, int col_len);
+
+/**
+ * Stop the loader thread and release every region
+ * @param	*stream	The stream
+ */
+void GFraMe_tilestream_clear(GFraMe_tilestream *stream);
+
+/**
+ * Swap in every region already decoded, evict the far away ones and queue the
+ *ones around the view; never waits for the loader
+ * @param	*stream	The stream
+ * @param	cam_x	The camera's horizontal position
+ * @param	cam_y	The camera's vertical position
+ * @param	cam_w	The camera's width
+ * @param	cam_h	The camera's height
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_tilestream_update(GFraMe_tilestream *stream, int cam_x,
+									int cam_y, int cam_w, int cam_h);
+
+/**
+ * Draw every resident region (see GFraMe_tilemap_draw)
+ * @param	*stream	The stream
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_tilestream_draw(GFraMe_tilestream *stream);
+
+/**
+ * Draw the resident regions visible by a camera (see
+ *GFraMe_tilemap_draw_camera)
+ * @param	*stream	The stream
+ * @param	cam_x	The camera's horizontal position
+ * @param	cam_y	The camera's vertical position
+ * @param	cam_w	The camera's width
+ * @param	cam_h	The camera's height
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_tilestream_draw_camera(GFraMe_tilestream *stream, int cam_x,
+										 int cam_y, int cam_w, int cam_h);
+
+/**
+ * Collide an object against every resident region (see
+ *GFraMe_tilemap_overlap)
+ * @param	*stream	The stream
+ * @param	*obj	The object
+ * @return	GFraMe_ret_ok - Overlapped; GFraMe_ret_no_overlap - Otherwise
+ */
+GFraMe_ret GFraMe_tilestream_overlap(GFraMe_tilestream *stream,
+									 GFraMe_object *obj);
+
+#endif
+
@@ -4,6 +4,8 @@
 #ifndef __GFRAME_TWEEN_H
 #define __GFRAME_TWEEN_H
 
+#include <GFraMe/GFraMe_fixed.h>
+
 // Forward declaration
 struct stGFraMe_object;
 typedef struct stGFraMe_object GFraMe_object;
@@ -27,15 +29,15 @@ struct stGFraMe_tween {
 	int toX;
 	int toY;
 	GFraMe_tween_type type;
-	double time;
-	double maxTime;
+	GFraMe_real time;
+	GFraMe_real maxTime;
 };
 typedef struct stGFraMe_tween GFraMe_tween;
 
 void GFraMe_tween_clear(GFraMe_tween *tw);
 void GFraMe_tween_init(GFraMe_tween *tw, int fromX, int fromY, int toX,
-					   int toY, double time, GFraMe_tween_type type);
-GFraMe_tween_ret GFraMe_tween_update(GFraMe_tween *tw, double elapsed);
+					   int toY, GFraMe_real time, GFraMe_tween_type type);
+GFraMe_tween_ret GFraMe_tween_update(GFraMe_tween *tw, GFraMe_real elapsed);
 
 GFraMe_tween_ret GFraMe_tween_set_obj(GFraMe_tween *tw, GFraMe_object *obj);
 
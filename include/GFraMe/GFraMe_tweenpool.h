@@ -0,0 +1,174 @@
+/**
+ * @include/GFraMe/GFraMe_tweenpool.h
+ *
+ * Manager for every running tween. Instead of each object carrying its own
+ *tween, tweens are added to a pool (targeting either an object's position or
+ *any float, e.g. a sprite's alpha or scale) and are all updated at once; so
+ *objects that aren't tweening cost nothing. Easing curves are sampled from
+ *tables built when the first pool is initialized.
+ */
+#ifndef __GFRAME_TWEENPOOL_H
+#define __GFRAME_TWEENPOOL_H
+
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_object.h>
+
+/**
+ * Easing curves
+ */
+enum enGFraMe_ease {
+	GFraMe_ease_linear = 0,
+	GFraMe_ease_quad_in,
+	GFraMe_ease_quad_out,
+	GFraMe_ease_quad_inout,
+	GFraMe_ease_cubic_in,
+	GFraMe_ease_cubic_out,
+	GFraMe_ease_cubic_inout,
+	GFraMe_ease_elastic_in,
+	GFraMe_ease_elastic_out,
+	GFraMe_ease_back_in,
+	GFraMe_ease_back_out,
+	GFraMe_ease_max
+};
+typedef enum enGFraMe_ease GFraMe_ease;
+
+/**
+ * How many samples each easing table has (besides the last one, at t = 1)
+ */
+#define GFRAME_EASE_LUT_SIZE 256
+
+/**
+ * A running tween
+ */
+struct stGFraMe_tweenpool_entry {
+	/**
+	 * Object whose position is tweened (NULL, if tweening a float)
+	 */
+	GFraMe_object *obj;
+	/**
+	 * Float that is tweened (NULL, if tweening an object)
+	 */
+	float *value;
+	/**
+	 * Initial horizontal position (or initial value)
+	 */
+	float from_x;
+	/**
+	 * Initial vertical position
+	 */
+	float from_y;
+	/**
+	 * Final horizontal position (or final value)
+	 */
+	float to_x;
+	/**
+	 * Final vertical position
+	 */
+	float to_y;
+	/**
+	 * How long, in milliseconds, the tween has been running
+	 */
+	int elapsed;
+	/**
+	 * How long, in milliseconds, the tween lasts
+	 */
+	int duration;
+	/**
+	 * Easing curve
+	 */
+	GFraMe_ease ease;
+};
+typedef struct stGFraMe_tweenpool_entry GFraMe_tweenpool_entry;
+
+struct stGFraMe_tweenpool {
+	/**
+	 * Every running tween (packed on the first indexes)
+	 */
+	GFraMe_tweenpool_entry *tweens;
+	/**
+	 * How many tweens are running
+	 */
+	int num;
+	/**
+	 * How many tweens fit on the pool
+	 */
+	int max;
+};
+typedef struct stGFraMe_tweenpool GFraMe_tweenpool;
+
+/**
+ * Sample an easing curve
+ * @param	ease	The curve (invalid ones are sampled as GFraMe_ease_linear)
+ * @param	t	Time, in [0, 1]
+ * @return	The eased value (0 at t = 0 and 1 at t = 1, but may overshoot)
+ */
+float GFraMe_ease_sample(GFraMe_ease ease, float t);
+
+/**
+ * Initialize a pool
+ * @param	*pool	Pool to be initialized
+ * @param	max	How many tweens may run at once
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_tweenpool_init(GFraMe_tweenpool *pool, int max);
+
+/**
+ * Release every memory used by the pool
+ * @param	*pool	The pool
+ */
+void GFraMe_tweenpool_clear(GFraMe_tweenpool *pool);
+
+/**
+ * Stop every tween (leaving their targets as they are)
+ * @param	*pool	The pool
+ */
+void GFraMe_tweenpool_reset(GFraMe_tweenpool *pool);
+
+/**
+ * Tween an object from its current position to another one
+ * @param	*pool	The pool
+ * @param	*obj	The object
+ * @param	to_x	Final horizontal position
+ * @param	to_y	Final vertical position
+ * @param	duration	How long, in milliseconds, the tween lasts
+ * @param	ease	Easing curve
+ * @return	GFraMe_ret_ok - Success; GFraMe_buffer_too_small - Pool is full
+ */
+GFraMe_ret GFraMe_tweenpool_add_obj(GFraMe_tweenpool *pool, GFraMe_object *obj,
+									int to_x, int to_y, int duration,
+									GFraMe_ease ease);
+
+/**
+ * Tween a float from its current value to another one
+ * @param	*pool	The pool
+ * @param	*value	The float (must stay valid while tweening)
+ * @param	to	Final value
+ * @param	duration	How long, in milliseconds, the tween lasts
+ * @param	ease	Easing curve
+ * @return	GFraMe_ret_ok - Success; GFraMe_buffer_too_small - Pool is full
+ */
+GFraMe_ret GFraMe_tweenpool_add_float(GFraMe_tweenpool *pool, float *value,
+									  float to, int duration,
+									  GFraMe_ease ease);
+
+/**
+ * Stop every tween on a target (leaving it as it is)
+ * @param	*pool	The pool
+ * @param	*target	Either an object or a float
+ * @return	How many tweens were stopped
+ */
+int GFraMe_tweenpool_stop(GFraMe_tweenpool *pool, void *target);
+
+/**
+ * Update every running tween; finished tweens are set to their final value
+ *and removed
+ * NOTE objects should be updated before this, so their last position is kept
+ *(for collision)
+ * @param	*pool	The pool
+ * @param	ms	Elapsed time from previous frame (in milliseconds)
+ * @return	How many tweens finished
+ */
+int GFraMe_tweenpool_update(GFraMe_tweenpool *pool, int ms);
+
+#endif
+
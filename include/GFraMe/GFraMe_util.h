@@ -5,6 +5,8 @@
 #define __GFRAME_UTIL_H
 
 #include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_fixed.h>
+#include <GFraMe/GFraMe_spriteset.h>
 
 /**
  * Super complex integration routine
@@ -61,7 +63,7 @@ char* GFraMe_util_strcat(char *dst, char *src, int *len);
  * @param	first_tile	First ASCII character ('!') posiiton on the spriteset
  * @return	First position, on the buffer, after the string.
  */
-char* GFraMe_str2tiles(char *data, char *str, int first_tile);
+GFraMe_tile* GFraMe_str2tiles(GFraMe_tile *data, char *str, int first_tile);
 
 /**
  * Open an browser on the desired webpage.
@@ -76,6 +78,59 @@ GFraMe_ret GFraMe_util_open_browser(char *url);
  */
 double GFraMe_util_lerp(int a, int b, double time);
 
+/**
+ * Divide two integers, rounding toward negative infinity (instead of toward
+ *zero, as '/' does)
+ * @param	n	The dividend
+ * @param	d	The divisor (must be positive)
+ * @return	The quotient
+ */
+int GFraMe_util_floor_div(int n, int d);
+
+/**
+ * Super complex integration routine, in fixed point
+ * @param	val	Value to be integrated
+ * @param	time	Time the value should be integrated
+ */
+GFraMe_fixed GFraMe_util_integratex(GFraMe_fixed val, GFraMe_fixed time);
+
+/**
+ * Return the absolute of a fixed point
+ * @param	val	Value to have its absolute computed
+ * @return	Absolute value computed
+ */
+GFraMe_fixed GFraMe_util_absx(GFraMe_fixed val);
+
+/**
+ * Divide two fixed points; the result is saturated, if it doesn't fit
+ * @param	a	The dividend
+ * @param	b	The divisor (mustn't be 0)
+ * @return	The quotient
+ */
+GFraMe_fixed GFraMe_util_divx(GFraMe_fixed a, GFraMe_fixed b);
+
+/**
+ * Interpolate linearly between two number, in fixed point
+ */
+GFraMe_fixed GFraMe_util_lerpx(int a, int b, GFraMe_fixed time);
+
+/**
+ * Routines that work on GFraMe_real (i.e., either double or fixed point)
+ */
+#if defined(GFRAME_FIXED_POINT)
+#  define GFraMe_util_integrate_real(val, time) \
+	GFraMe_util_integratex(val, time)
+#  define GFraMe_util_absr(val) GFraMe_util_absx(val)
+#  define GFraMe_util_divr(a, b) GFraMe_util_divx(a, b)
+#  define GFraMe_util_lerp_real(a, b, time) GFraMe_util_lerpx(a, b, time)
+#else
+#  define GFraMe_util_integrate_real(val, time) \
+	GFraMe_util_integrate(val, time)
+#  define GFraMe_util_absr(val) GFraMe_util_absd(val)
+#  define GFraMe_util_divr(a, b) ((a) / (b))
+#  define GFraMe_util_lerp_real(a, b, time) GFraMe_util_lerp(a, b, time)
+#endif
+
 /**
  * Get the directory to this application's local files. It's set according to
  *the organization and title set when initializing the game. The actual
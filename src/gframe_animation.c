@@ -3,6 +3,7 @@
  */
 #include <GFraMe/GFraMe_animation.h>
 #include <GFraMe/GFraMe_error.h>
+#include <stdlib.h>
 
 /**
  * Initialize an animation
@@ -93,3 +94,296 @@ void GFraMe_animation_reset(GFraMe_animation *anim) {
     anim->tile = anim->frames[0];
 }
 
+/**
+ * Initialize an animation definition
+ * @param *def Animation definition to be initialized
+ * @param fps At how many frames per second it should run
+ * @param *frames Array of frames (int)
+ * @param num_frames How many frames there are in the animation
+ * @param do_loop Whether it should loop (1) or not (0)
+ */
+void GFraMe_animdef_init(GFraMe_animdef *def, int fps, int const *frames,
+                         int num_frames, int do_loop) {
+    def->frames = frames;
+    def->num_frames = num_frames;
+    def->do_loop = do_loop;
+    // Calculate how long each frame should take, in milliseconds
+    if (fps > 0)
+        def->frame_duration = 1000 / fps;
+    else
+        def->frame_duration = 0;
+    def->times = NULL;
+    def->total = def->frame_duration * num_frames;
+}
+
+/**
+ * Initialize an animation definition where each frame has its own duration
+ * @param *def Animation definition to be initialized
+ * @param *frames Array of frames (int)
+ * @param *durations How long, in milliseconds, each frame lasts
+ * @param num_frames How many frames there are in the animation
+ * @param do_loop Whether it should loop (1) or not (0)
+ * @return GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_animdef_init_durations(GFraMe_animdef *def,
+                                         int const *frames,
+                                         int const *durations, int num_frames,
+                                         int do_loop) {
+    GFraMe_ret rv = GFraMe_ret_ok;
+    int i;
+
+    def->frames = frames;
+    def->num_frames = num_frames;
+    def->do_loop = do_loop;
+    def->frame_duration = 0;
+    def->total = 0;
+    def->times = NULL;
+    GFraMe_assertRV(num_frames > 0, "Animation without frames",
+                    rv = GFraMe_ret_bad_param, _ret);
+    def->times = (int*)malloc(sizeof(int) * num_frames);
+    GFraMe_assertRV(def->times, "Failed to alloc frame times",
+                    rv = GFraMe_ret_memory_error, _ret);
+    // Accumulate when each frame ends
+    i = 0;
+    while (i < num_frames) {
+        GFraMe_assertRV(durations[i] > 0, "Invalid frame duration",
+                        rv = GFraMe_ret_bad_param, _ret);
+        def->total += durations[i];
+        def->times[i] = def->total;
+        i++;
+    }
+_ret:
+    if (rv != GFraMe_ret_ok)
+        GFraMe_animdef_clear(def);
+    return rv;
+}
+
+/**
+ * Release every memory used by an animation definition
+ * @param *def The animation definition
+ */
+void GFraMe_animdef_clear(GFraMe_animdef *def) {
+    if (def->times)
+        free(def->times);
+    def->times = NULL;
+    def->total = 0;
+}
+
+/**
+ * Get how long a frame lasts
+ */
+static int GFraMe_animdef_get_duration(GFraMe_animdef const *def, int i) {
+    if (!def->times)
+        return def->frame_duration;
+    else if (i == 0)
+        return def->times[0];
+    return def->times[i] - def->times[i - 1];
+}
+
+/**
+ * Find which frame is displayed at a time within the first run of the
+ *animation
+ * @param *def The animation definition
+ * @param t Time, in [0, total)
+ * @return The frame's index
+ */
+static int GFraMe_animdef_find_frame(GFraMe_animdef const *def, int t) {
+    int lo, hi;
+
+    if (!def->times)
+        return t / def->frame_duration;
+    // Look for the first frame that ends after t
+    lo = 0;
+    hi = def->num_frames - 1;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (def->times[mid] > t)
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+    return lo;
+}
+
+/**
+ * Find the state of an animation at a given time, without playing through it
+ *(in constant time, if every frame has the same duration, or logarithmic,
+ *otherwise)
+ * @param *def The animation definition
+ * @param t_ms Time since the animation started, in milliseconds
+ * @param *index Returns the frame's index in the frames array (may be NULL)
+ * @param *num_finished Returns how many times the animation finished (may be
+ *                      NULL)
+ * @return The tile displayed at that time
+ */
+int GFraMe_animation_sample(GFraMe_animdef const *def, int t_ms, int *index,
+                            int *num_finished) {
+    int i, loops;
+
+    if (t_ms < 0)
+        t_ms = 0;
+    if (def->total <= 0) {
+        // Animations without duration never leave their first frame
+        i = 0;
+        loops = 0;
+    }
+    else if (t_ms >= def->total && !def->do_loop) {
+        // Stopped at the last frame
+        i = def->num_frames - 1;
+        loops = 1;
+    }
+    else {
+        loops = t_ms / def->total;
+        i = GFraMe_animdef_find_frame(def, t_ms - loops * def->total);
+    }
+
+    if (index)
+        *index = i;
+    if (num_finished)
+        *num_finished = loops;
+    return def->frames[i];
+}
+
+/**
+ * Set an instance to the state its animation would be in after some time
+ *(e.g., to rewind it or to catch up after a stall)
+ * @param *player The instance
+ * @param t_ms Time since the animation started, in milliseconds
+ */
+void GFraMe_animplayer_seek(GFraMe_animplayer *player, int t_ms) {
+    GFraMe_animdef const *def = player->def;
+    int end;
+
+    if (!def)
+        return;
+    if (t_ms < 0)
+        t_ms = 0;
+    GFraMe_animation_sample(def, t_ms, &player->index, &player->num_finished);
+    if (def->total <= 0 || (t_ms >= def->total && !def->do_loop)) {
+        // Either it never runs or it already finished
+        player->acc = 0;
+        return;
+    }
+    // Set how long until the current frame ends
+    if (def->times)
+        end = def->times[player->index];
+    else
+        end = def->frame_duration * (player->index + 1);
+    player->acc = end - (t_ms - player->num_finished * def->total);
+}
+
+/**
+ * Start playing an animation from its first frame
+ * @param *player The instance
+ * @param *def Animation to be played (NULL stops the current one)
+ */
+void GFraMe_animplayer_play(GFraMe_animplayer *player,
+                            GFraMe_animdef const *def) {
+    player->def = def;
+    player->index = 0;
+    player->num_finished = 0;
+    if (def)
+        player->acc = GFraMe_animdef_get_duration(def, 0);
+    else
+        player->acc = 0;
+}
+
+/**
+ * Get the tile currently displayed by an instance
+ * @param *player The instance
+ * @return The tile (-1, if there's no animation)
+ */
+int GFraMe_animplayer_get_tile(GFraMe_animplayer *player) {
+    if (!player->def)
+        return -1;
+    return player->def->frames[player->index];
+}
+
+/**
+ * Advance an instance that is still running through every frame that
+ *should have been issued
+ * @return Whether the animation finished
+ */
+static int GFraMe_animplayer_advance(GFraMe_animplayer *player,
+                                     GFraMe_animdef const *def) {
+    // Skip every whole loop at once
+    if (def->do_loop && -player->acc >= def->total) {
+        int loops = -player->acc / def->total;
+        player->num_finished += loops;
+        player->acc += loops * def->total;
+    }
+    while (player->acc <= 0) {
+        if (player->index + 1 < def->num_frames)
+            player->index++;
+        else {
+            player->num_finished++;
+            // Stop at the last frame (with no time left), if not looping
+            if (!def->do_loop) {
+                player->acc = 0;
+                return 1;
+            }
+            player->index = 0;
+        }
+        player->acc += GFraMe_animdef_get_duration(def, player->index);
+    }
+    return 0;
+}
+
+/**
+ * Updates an instance, changing the frame (as many times as needed)
+ * @param *player The instance
+ * @param ms Time elapsed, in milliseconds
+ * @return GFraMe_ret_ok - if nothing happened; GFraMe_ret_anim_new_frame - if a new frame was issued; GFraMe_ret_anim_finished - if the animation finished running
+ */
+GFraMe_ret GFraMe_animplayer_update(GFraMe_animplayer *player, int ms) {
+    // Check if the animation already finished (or there's none)
+    if (player->acc <= 0)
+        return GFraMe_ret_anim_finished;
+    player->acc -= ms;
+    if (player->acc > 0)
+        return GFraMe_ret_ok;
+    if (GFraMe_animplayer_advance(player, player->def))
+        return GFraMe_ret_anim_finished;
+    return GFraMe_ret_anim_new_frame;
+}
+
+/**
+ * Updates many instances at once
+ * @param *players The instances
+ * @param num How many instances there are
+ * @param ms Time elapsed, in milliseconds
+ * @param *changed Returns the index of every instance whose tile changed
+ *                 (must fit 'num' indexes)
+ * @return How many instances had their tile changed
+ */
+int GFraMe_animation_update_many(GFraMe_animplayer *players, int num, int ms,
+                                 int *changed) {
+    int i, count;
+
+    count = 0;
+    i = 0;
+    while (i < num) {
+        GFraMe_animplayer *player = players + i;
+
+        // Most instances only have their timer decreased (finished ones and
+        // the ones without animation have no time left, so they are skipped)
+        if (player->acc > 0) {
+            player->acc -= ms;
+            if (player->acc <= 0) {
+                GFraMe_animdef const *def = player->def;
+                int prev;
+
+                prev = def->frames[player->index];
+                GFraMe_animplayer_advance(player, def);
+                if (def->frames[player->index] != prev) {
+                    changed[count] = i;
+                    count++;
+                }
+            }
+        }
+        i++;
+    }
+
+    return count;
+}
+
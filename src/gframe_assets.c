@@ -26,10 +26,14 @@
 #include <string.h>
 
 /**
- * SDL already considers assets on a mobile device to be on a 'assets/'
- * folder, so this function removes it (if it was compiled for mobile)
- * @param	*filename	Original filename, that may begin with 'assets/'
- * @retrun	Filename with 'assets/' removed.
+ * Get the path of an asset; on desktop, it's within the 'assets/' folder (which
+ *is on the game's path, on release builds). SDL already looks for assets on a
+ *mobile device within 'assets/', so the name is copied as is
+ * @param	*dst	Buffer that receives the path
+ * @param	*src	Asset's name, relative to the 'assets/' folder
+ * @param	*len	Size of 'dst', in characters; returns how many characters
+ *		  were left unused (if 0, the path was truncated)
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
  */
 GFraMe_ret GFraMe_assets_clean_filename(char *dst, char *src, int *len) {
 	GFraMe_ret rv;
@@ -0,0 +1,422 @@
+/**
+ * @src/gframe_camera.c
+ */
+#include <GFraMe/GFraMe_camera.h>
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_fixed.h>
+#include <GFraMe/GFraMe_renderqueue.h>
+#include <GFraMe/GFraMe_sprite.h>
+#include <GFraMe/GFraMe_spritepool.h>
+#include <GFraMe/GFraMe_spriteset.h>
+#include <GFraMe/GFraMe_tilemap.h>
+#include <math.h>
+
+/**
+ * Initialize a camera at the origin, without zoom nor parallax
+ * @param	*cam	Camera to be initialized
+ * @param	w	View's width, on the screen
+ * @param	h	View's height, on the screen
+ */
+void GFraMe_camera_init(GFraMe_camera *cam, int w, int h) {
+	int i;
+
+	cam->x = 0;
+	cam->y = 0;
+	cam->w = w;
+	cam->h = h;
+	cam->zoom = 1.0f;
+	i = 0;
+	while (i < GFRAME_RENDERQUEUE_LAYERS) {
+		cam->parallax_x[i] = 1.0f;
+		cam->parallax_y[i] = 1.0f;
+		i++;
+	}
+}
+
+/**
+ * Move the camera's upper-left corner
+ * @param	*cam	The camera
+ * @param	x	Horizontal position
+ * @param	y	Vertical position
+ */
+void GFraMe_camera_set_pos(GFraMe_camera *cam, int x, int y) {
+	cam->x = x;
+	cam->y = y;
+}
+
+/**
+ * Move the camera so a point is on the center of the view (e.g., to follow
+ *the player)
+ * @param	*cam	The camera
+ * @param	x	Horizontal position
+ * @param	y	Vertical position
+ */
+void GFraMe_camera_center(GFraMe_camera *cam, int x, int y) {
+	cam->x = x - (int)((float)cam->w / cam->zoom) / 2;
+	cam->y = y - (int)((float)cam->h / cam->zoom) / 2;
+}
+
+/**
+ * Set the camera's zoom
+ * @param	*cam	The camera
+ * @param	zoom	How many screen pixels each world pixel takes (must be
+ *		  positive)
+ */
+void GFraMe_camera_set_zoom(GFraMe_camera *cam, float zoom) {
+	if (zoom > 0.0f)
+		cam->zoom = zoom;
+}
+
+/**
+ * Set a layer's parallax factor
+ * @param	*cam	The camera
+ * @param	layer	The layer
+ * @param	px	Horizontal factor (1 moves along the world, 0 stays fixed)
+ * @param	py	Vertical factor
+ */
+void GFraMe_camera_set_parallax(GFraMe_camera *cam, int layer, float px,
+								float py) {
+	if (layer < 0 || layer >= GFRAME_RENDERQUEUE_LAYERS)
+		return;
+	cam->parallax_x[layer] = px;
+	cam->parallax_y[layer] = py;
+}
+
+/**
+ * Get the area of the world visible on a layer
+ * @param	*view	Returns the area
+ * @param	*cam	The camera
+ * @param	layer	The layer
+ */
+void GFraMe_camera_get_view(GFraMe_camera_view *view, GFraMe_camera *cam,
+							int layer) {
+	if (layer < 0 || layer >= GFRAME_RENDERQUEUE_LAYERS) {
+		view->x = (float)cam->x;
+		view->y = (float)cam->y;
+	}
+	else {
+		view->x = (float)cam->x * cam->parallax_x[layer];
+		view->y = (float)cam->y * cam->parallax_y[layer];
+	}
+	view->w = (float)cam->w / cam->zoom;
+	view->h = (float)cam->h / cam->zoom;
+}
+
+/**
+ * Check whether a tile at a position (scaled around its center) overlaps a
+ *view
+ */
+static int GFraMe_camera_overlaps(GFraMe_camera_view *view, int x, int y,
+								  int tw, int th, float sx, float sy) {
+	float cx, cy, hw, hh;
+
+	hw = (float)tw * fabsf(sx) * 0.5f;
+	hh = (float)th * fabsf(sy) * 0.5f;
+	cx = (float)x + (float)tw * 0.5f;
+	cy = (float)y + (float)th * 0.5f;
+	return cx + hw > view->x && cx - hw < view->x + view->w
+		&& cy + hh > view->y && cy - hh < view->y + view->h;
+}
+
+/**
+ * Move a command into screen space, given the visible area
+ */
+static void GFraMe_camera_apply(GFraMe_camera_view *view, float zoom,
+								GFraMe_rendercmd *cmd) {
+	float hw, hh, cx, cy;
+
+	// Keep the tile's center in place, since it's scaled around it
+	hw = (float)cmd->sset->tw * 0.5f;
+	hh = (float)cmd->sset->th * 0.5f;
+	cx = ((float)cmd->x + hw - view->x) * zoom;
+	cy = ((float)cmd->y + hh - view->y) * zoom;
+	cmd->x = (int)floorf(cx - hw + 0.5f);
+	cmd->y = (int)floorf(cy - hh + 0.5f);
+	cmd->scale_x *= zoom;
+	cmd->scale_y *= zoom;
+}
+
+/**
+ * Check whether a command (in world space) is visible on a layer
+ * @param	*cam	The camera
+ * @param	layer	The layer
+ * @param	*cmd	The command
+ * @return	1 - Visible; 0 - Otherwise
+ */
+int GFraMe_camera_is_cmd_visible(GFraMe_camera *cam, int layer,
+								 GFraMe_rendercmd *cmd) {
+	GFraMe_camera_view view;
+
+	GFraMe_camera_get_view(&view, cam, layer);
+	return GFraMe_camera_overlaps(&view, cmd->x, cmd->y, cmd->sset->tw,
+								  cmd->sset->th, cmd->scale_x, cmd->scale_y);
+}
+
+/**
+ * Check whether a sprite's current frame is visible on a layer
+ * @param	*cam	The camera
+ * @param	layer	The layer
+ * @param	*spr	The sprite
+ * @return	1 - Visible; 0 - Otherwise
+ */
+int GFraMe_camera_is_visible(GFraMe_camera *cam, int layer,
+							 GFraMe_sprite *spr) {
+	GFraMe_rendercmd cmd;
+
+	GFraMe_rendercmd_set_sprite(&cmd, spr, GFraMe_blend_alpha);
+	return GFraMe_camera_is_cmd_visible(cam, layer, &cmd);
+}
+
+/**
+ * Move a command from world space into screen space
+ * @param	*cam	The camera
+ * @param	layer	The layer
+ * @param	*cmd	The command
+ */
+void GFraMe_camera_transform(GFraMe_camera *cam, int layer,
+							 GFraMe_rendercmd *cmd) {
+	GFraMe_camera_view view;
+
+	GFraMe_camera_get_view(&view, cam, layer);
+	GFraMe_camera_apply(&view, cam->zoom, cmd);
+}
+
+/**
+ * Draw a sprite right away, if it's visible; on the SDL renderer, zoom only
+ *changes the sprite's position (use a render queue to also scale it)
+ * @param	*cam	The camera
+ * @param	layer	Layer whose parallax is used
+ * @param	*spr	The sprite
+ * @return	GFraMe_ret_ok - Success (or culled); Anything else - Failure
+ */
+GFraMe_ret GFraMe_camera_draw_sprite(GFraMe_camera *cam, int layer,
+									 GFraMe_sprite *spr) {
+	GFraMe_rendercmd cmd;
+#if defined(GFRAME_OPENGL)
+	GFraMe_ssetRenderCtx ctx;
+#endif
+
+	GFraMe_rendercmd_set_sprite(&cmd, spr, GFraMe_blend_alpha);
+	if (!GFraMe_camera_is_cmd_visible(cam, layer, &cmd))
+		return GFraMe_ret_ok;
+	GFraMe_camera_transform(cam, layer, &cmd);
+#if defined(GFRAME_OPENGL)
+	ctx.x = cmd.x;
+	ctx.y = cmd.y;
+	ctx.angle = cmd.angle;
+	ctx.sX = cmd.flipped ? -cmd.scale_x : cmd.scale_x;
+	ctx.sY = cmd.scale_y;
+	ctx.alpha = cmd.alpha;
+	return GFraMe_spriteset_draw_ex(cmd.sset, cmd.tile, &ctx);
+#else
+	return GFraMe_spriteset_draw(cmd.sset, cmd.tile, cmd.x, cmd.y,
+								 cmd.flipped);
+#endif
+}
+
+/**
+ * Push a sprite into a render queue, if it's visible
+ * @param	*cam	The camera
+ * @param	*queue	The render queue
+ * @param	layer	Layer where the sprite is pushed
+ * @param	depth	Depth within the layer
+ * @param	*spr	The sprite
+ * @param	blend	How the sprite is blended
+ * @return	GFraMe_ret_ok - Success (or culled); Anything else - Failure
+ */
+GFraMe_ret GFraMe_camera_push_sprite(GFraMe_camera *cam,
+									 GFraMe_renderqueue *queue, int layer,
+									 int depth, GFraMe_sprite *spr,
+									 GFraMe_blend blend) {
+	GFraMe_rendercmd cmd;
+
+	GFraMe_rendercmd_set_sprite(&cmd, spr, blend);
+	if (!GFraMe_camera_is_cmd_visible(cam, layer, &cmd))
+		return GFraMe_ret_ok;
+	GFraMe_camera_transform(cam, layer, &cmd);
+	return GFraMe_renderqueue_push(queue, layer, depth, &cmd);
+}
+
+/**
+ * Find every live sprite on a pool that is visible (in a single pass)
+ * @param	*visible	Returns the index of every visible sprite (must fit
+ *			  pool->num indexes)
+ * @param	*cam	The camera
+ * @param	layer	Layer whose parallax is used
+ * @param	*pool	The pool
+ * @return	How many sprites are visible
+ */
+int GFraMe_camera_cull_pool(int *visible, GFraMe_camera *cam, int layer,
+							GFraMe_spritepool *pool) {
+	GFraMe_camera_view view;
+	int i, count;
+
+	// The view is calculated only once for the whole pool
+	GFraMe_camera_get_view(&view, cam, layer);
+	count = 0;
+	i = 0;
+	while (i < pool->num) {
+		GFraMe_sprite *spr = pool->sprites + i;
+		int x;
+
+		if (spr->is_visible) {
+			if (!spr->flipped)
+				x = spr->obj.x + spr->offset_x;
+			else
+				x = spr->obj.x - (spr->sset->tw
+						- GFraMe_real_to_int(spr->obj.hitbox.hw) * 2)
+					- spr->offset_x;
+			if (GFraMe_camera_overlaps(&view, x, spr->obj.y + spr->offset_y,
+									   spr->sset->tw, spr->sset->th,
+									   spr->scale_x, spr->scale_y)) {
+				visible[count] = i;
+				count++;
+			}
+		}
+		i++;
+	}
+	return count;
+}
+
+/**
+ * Push every visible sprite of a pool into a render queue
+ * @param	*cam	The camera
+ * @param	*queue	The render queue
+ * @param	layer	Layer where the sprites are pushed
+ * @param	depth	Depth of every sprite within the layer
+ * @param	*pool	The pool
+ * @param	blend	How the sprites are blended
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_camera_push_pool(GFraMe_camera *cam,
+								   GFraMe_renderqueue *queue, int layer,
+								   int depth, GFraMe_spritepool *pool,
+								   GFraMe_blend blend) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	GFraMe_camera_view view;
+	int i, num;
+
+	// Reuse the pool's buffer, since it's only used while updating
+	num = GFraMe_camera_cull_pool(pool->changed, cam, layer, pool);
+	GFraMe_camera_get_view(&view, cam, layer);
+	i = 0;
+	while (i < num) {
+		GFraMe_rendercmd cmd;
+
+		GFraMe_rendercmd_set_sprite(&cmd, pool->sprites + pool->changed[i],
+									blend);
+		GFraMe_camera_apply(&view, cam->zoom, &cmd);
+		rv = GFraMe_renderqueue_push(queue, layer, depth, &cmd);
+		GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to push sprite", _ret);
+		i++;
+	}
+_ret:
+	return rv;
+}
+
+/**
+ * Get which tiles of a tilemap are visible on a layer
+ * @param	*rect	Returns the visible tiles (with no width nor height, if
+ *		  none is visible)
+ * @param	*cam	The camera
+ * @param	layer	The layer
+ * @param	*tmap	The tilemap
+ */
+void GFraMe_camera_get_tiles(GFraMe_tilemap_rect *rect, GFraMe_camera *cam,
+							 int layer, GFraMe_tilemap *tmap) {
+	GFraMe_camera_view view;
+	int x0, y0, x1, y1;
+
+	GFraMe_camera_get_view(&view, cam, layer);
+	// Convert the view into tiles (the last ones are exclusive)
+	x0 = (int)floorf((view.x - (float)tmap->x) / (float)tmap->sset->tw);
+	y0 = (int)floorf((view.y - (float)tmap->y) / (float)tmap->sset->th);
+	x1 = (int)ceilf((view.x + view.w - (float)tmap->x)
+					/ (float)tmap->sset->tw);
+	y1 = (int)ceilf((view.y + view.h - (float)tmap->y)
+					/ (float)tmap->sset->th);
+	if (x0 < 0)
+		x0 = 0;
+	if (y0 < 0)
+		y0 = 0;
+	if (x1 > tmap->width_in_tiles)
+		x1 = tmap->width_in_tiles;
+	if (y1 > tmap->height_in_tiles)
+		y1 = tmap->height_in_tiles;
+
+	rect->x = x0;
+	rect->y = y0;
+	rect->w = (x1 > x0) ? x1 - x0 : 0;
+	rect->h = (y1 > y0) ? y1 - y0 : 0;
+}
+
+/**
+ * Draw every visible tile of a tilemap right away; zoom isn't applied (use a
+ *render queue instead)
+ * @param	*cam	The camera
+ * @param	layer	Layer whose parallax is used
+ * @param	*tmap	The tilemap
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_camera_draw_tilemap(GFraMe_camera *cam, int layer,
+									  GFraMe_tilemap *tmap) {
+	GFraMe_camera_view view;
+
+	GFraMe_camera_get_view(&view, cam, layer);
+	return GFraMe_tilemap_draw_camera(tmap, (int)floorf(view.x),
+									  (int)floorf(view.y), cam->w, cam->h);
+}
+
+/**
+ * Push every visible tile of a tilemap into a render queue
+ * @param	*cam	The camera
+ * @param	*queue	The render queue
+ * @param	layer	Layer where the tiles are pushed
+ * @param	depth	Depth of every tile within the layer
+ * @param	*tmap	The tilemap
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_camera_push_tilemap(GFraMe_camera *cam,
+									  GFraMe_renderqueue *queue, int layer,
+									  int depth, GFraMe_tilemap *tmap) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	GFraMe_tilemap_rect rect;
+	GFraMe_camera_view view;
+	GFraMe_rendercmd cmd;
+	int i, j;
+
+	GFraMe_camera_get_tiles(&rect, cam, layer, tmap);
+	GFraMe_camera_get_view(&view, cam, layer);
+	cmd.sset = tmap->sset;
+	cmd.flipped = 0;
+	cmd.angle = 0.0f;
+	cmd.alpha = 1.0f;
+	cmd.blend = GFraMe_blend_alpha;
+	// Go through the visible tiles in memory order
+	j = rect.y;
+	while (j < rect.y + rect.h) {
+		GFraMe_tile *row;
+
+		row = tmap->data + j * tmap->width_in_tiles;
+		i = rect.x;
+		while (i < rect.x + rect.w) {
+			// Tile 0 is empty
+			if (row[i] != 0) {
+				cmd.tile = GFraMe_tilemap_get_drawn(tmap, row[i]);
+				cmd.x = tmap->x + i * tmap->sset->tw;
+				cmd.y = tmap->y + j * tmap->sset->th;
+				cmd.scale_x = 1.0f;
+				cmd.scale_y = 1.0f;
+				GFraMe_camera_apply(&view, cam->zoom, &cmd);
+				rv = GFraMe_renderqueue_push(queue, layer, depth, &cmd);
+				GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to push tile",
+								 _ret);
+			}
+			i++;
+		}
+		j++;
+	}
+_ret:
+	return rv;
+}
+
@@ -0,0 +1,703 @@
+/**
+ * @src/gframe_nav.c
+ */
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_nav.h>
+#include <GFraMe/GFraMe_tilemap.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Distance of tiles that can't reach the target
+ */
+#define GFRAME_NAV_UNREACHABLE INT_MAX
+
+/**
+ * Number of buckets on a flow field (one more than the most expensive move)
+ */
+#define GFRAME_NAV_BUCKETS (GFRAME_NAV_DIAGONAL + 1)
+
+/**
+ * Check whether a tile can be walked over
+ */
+static int GFraMe_nav_is_free(GFraMe_tilemap *tmap, int x, int y) {
+	if (x < 0 || y < 0 || x >= tmap->width_in_tiles
+			|| y >= tmap->height_in_tiles)
+		return 0;
+	return !GFraMe_tilemap_is_solid(tmap, x, y);
+}
+
+/**
+ * Check whether a tile can be moved into from a neighbor (diagonals can't cut
+ *corners)
+ */
+static int GFraMe_nav_can_step(GFraMe_tilemap *tmap, int x, int y, int dx,
+							   int dy) {
+	if (!GFraMe_nav_is_free(tmap, x + dx, y + dy))
+		return 0;
+	if (dx != 0 && dy != 0)
+		return GFraMe_nav_is_free(tmap, x + dx, y)
+			&& GFraMe_nav_is_free(tmap, x, y + dy);
+	return 1;
+}
+
+/**
+ * Cost of moving between two tiles over straight and diagonal lines
+ */
+static int GFraMe_nav_octile(int x0, int y0, int x1, int y1) {
+	int dx, dy;
+
+	dx = (x0 > x1) ? x0 - x1 : x1 - x0;
+	dy = (y0 > y1) ? y0 - y1 : y1 - y0;
+	if (dx < dy)
+		return GFRAME_NAV_DIAGONAL * dx + GFRAME_NAV_STRAIGHT * (dy - dx);
+	return GFRAME_NAV_DIAGONAL * dy + GFRAME_NAV_STRAIGHT * (dx - dy);
+}
+
+/**
+ * Initialize the arena for path queries on a tilemap
+ * @param	*nav	The arena
+ * @param	*tmap	The tilemap (must be already initialized)
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_nav_init(GFraMe_nav *nav, GFraMe_tilemap *tmap) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	int num;
+
+	memset(nav, 0x0, sizeof(GFraMe_nav));
+	nav->tmap = tmap;
+	num = tmap->width_in_tiles * tmap->height_in_tiles;
+	nav->g = (int*)malloc(sizeof(int) * num);
+	GFraMe_assertRV(nav->g, "Failed to alloc navigation",
+					rv = GFraMe_ret_memory_error, _ret);
+	nav->parent = (int*)malloc(sizeof(int) * num);
+	GFraMe_assertRV(nav->parent, "Failed to alloc navigation",
+					rv = GFraMe_ret_memory_error, _ret);
+	nav->seen = (unsigned int*)calloc(num, sizeof(unsigned int));
+	GFraMe_assertRV(nav->seen, "Failed to alloc navigation",
+					rv = GFraMe_ret_memory_error, _ret);
+	nav->closed = (unsigned int*)calloc(num, sizeof(unsigned int));
+	GFraMe_assertRV(nav->closed, "Failed to alloc navigation",
+					rv = GFraMe_ret_memory_error, _ret);
+	// Start small; the open list grows as needed and is kept
+	nav->max_open = 64;
+	nav->open = (GFraMe_nav_node*)malloc(sizeof(GFraMe_nav_node)
+										 * nav->max_open);
+	GFraMe_assertRV(nav->open, "Failed to alloc open list",
+					rv = GFraMe_ret_memory_error, _ret);
+_ret:
+	if (rv != GFraMe_ret_ok)
+		GFraMe_nav_clear(nav);
+	return rv;
+}
+
+/**
+ * Release the arena
+ * @param	*nav	The arena
+ */
+void GFraMe_nav_clear(GFraMe_nav *nav) {
+	if (nav->g)
+		free(nav->g);
+	if (nav->parent)
+		free(nav->parent);
+	if (nav->seen)
+		free(nav->seen);
+	if (nav->closed)
+		free(nav->closed);
+	if (nav->open)
+		free(nav->open);
+	memset(nav, 0x0, sizeof(GFraMe_nav));
+}
+
+/**
+ * Push a tile into the open list
+ */
+static GFraMe_ret GFraMe_nav_push(GFraMe_nav *nav, int f, int tile) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	int i;
+
+	if (nav->num_open == nav->max_open) {
+		GFraMe_nav_node *tmp;
+
+		tmp = (GFraMe_nav_node*)realloc(nav->open, sizeof(GFraMe_nav_node)
+										* nav->max_open * 2);
+		GFraMe_assertRV(tmp, "Failed to expand open list",
+						rv = GFraMe_ret_memory_error, _ret);
+		nav->open = tmp;
+		nav->max_open *= 2;
+	}
+	// Sift up
+	i = nav->num_open;
+	nav->num_open++;
+	while (i > 0 && nav->open[(i - 1) / 2].f > f) {
+		nav->open[i] = nav->open[(i - 1) / 2];
+		i = (i - 1) / 2;
+	}
+	nav->open[i].f = f;
+	nav->open[i].tile = tile;
+_ret:
+	return rv;
+}
+
+/**
+ * Pop the tile with the lowest estimate from the open list
+ */
+static int GFraMe_nav_pop(GFraMe_nav *nav) {
+	GFraMe_nav_node last;
+	int tile, i;
+
+	tile = nav->open[0].tile;
+	nav->num_open--;
+	last = nav->open[nav->num_open];
+	// Sift the last entry down from the root
+	i = 0;
+	while (2 * i + 1 < nav->num_open) {
+		int c = 2 * i + 1;
+
+		if (c + 1 < nav->num_open && nav->open[c + 1].f < nav->open[c].f)
+			c++;
+		if (nav->open[c].f >= last.f)
+			break;
+		nav->open[i] = nav->open[c];
+		i = c;
+	}
+	nav->open[i] = last;
+	return tile;
+}
+
+/**
+ * Move straight from a tile until a jump point (a tile with a forced neighbor,
+ *or the goal) is found
+ * @return	1 - Found (on *jx, *jy); 0 - Hit a wall
+ */
+static int GFraMe_nav_jump_straight(int *jx, int *jy, GFraMe_tilemap *tmap,
+									int x, int y, int dx, int dy, int gx,
+									int gy) {
+	while (1) {
+		if (!GFraMe_nav_is_free(tmap, x, y))
+			return 0;
+		if (x == gx && y == gy)
+			break;
+		// A wall that ends beside the path opens a diagonal, which must be
+		//considered from here
+		if (dx != 0 && ((GFraMe_nav_is_free(tmap, x, y - 1)
+					&& !GFraMe_nav_is_free(tmap, x - dx, y - 1))
+				|| (GFraMe_nav_is_free(tmap, x, y + 1)
+					&& !GFraMe_nav_is_free(tmap, x - dx, y + 1))))
+			break;
+		if (dy != 0 && ((GFraMe_nav_is_free(tmap, x - 1, y)
+					&& !GFraMe_nav_is_free(tmap, x - 1, y - dy))
+				|| (GFraMe_nav_is_free(tmap, x + 1, y)
+					&& !GFraMe_nav_is_free(tmap, x + 1, y - dy))))
+			break;
+		x += dx;
+		y += dy;
+	}
+	*jx = x;
+	*jy = y;
+	return 1;
+}
+
+/**
+ * Move from a tile in a direction until a jump point is found; moving
+ *diagonally, every tile that has a jump point straight ahead is one
+ * @return	1 - Found (on *jx, *jy); 0 - Hit a wall
+ */
+static int GFraMe_nav_jump(int *jx, int *jy, GFraMe_tilemap *tmap, int x,
+						   int y, int dx, int dy, int gx, int gy) {
+	int tmp_x, tmp_y;
+
+	if (dx == 0 || dy == 0)
+		return GFraMe_nav_jump_straight(jx, jy, tmap, x, y, dx, dy, gx, gy);
+	while (1) {
+		if (!GFraMe_nav_is_free(tmap, x, y))
+			return 0;
+		if ((x == gx && y == gy)
+				|| GFraMe_nav_jump_straight(&tmp_x, &tmp_y, tmap, x + dx, y,
+											dx, 0, gx, gy)
+				|| GFraMe_nav_jump_straight(&tmp_x, &tmp_y, tmap, x, y + dy,
+											0, dy, gx, gy))
+			break;
+		// Diagonals can't cut corners
+		if (!GFraMe_nav_is_free(tmap, x + dx, y)
+				|| !GFraMe_nav_is_free(tmap, x, y + dy))
+			return 0;
+		x += dx;
+		y += dy;
+	}
+	*jx = x;
+	*jy = y;
+	return 1;
+}
+
+/**
+ * Find the shortest path between two tiles; every step between consecutive
+ *points is a straight or diagonal line
+ * @param	*path	Returns the path's points, as (x, y) pairs of tiles, from the
+ *		  start to the goal
+ * @param	*len	Returns how many points there are on the path (even if they
+ *		  didn't fit)
+ * @param	max_len	How many points fit the path
+ * @param	*nav	The arena
+ * @param	sx	Start's horizontal position (in tiles)
+ * @param	sy	Start's vertical position (in tiles)
+ * @param	gx	Goal's horizontal position (in tiles)
+ * @param	gy	Goal's vertical position (in tiles)
+ * @return	GFraMe_ret_ok - Success; GFraMe_buffer_too_small - The path
+ *		  didn't fit; GFraMe_ret_failed - There's no path
+ */
+GFraMe_ret GFraMe_nav_find_path(int *path, int *len, int max_len,
+								GFraMe_nav *nav, int sx, int sy, int gx,
+								int gy) {
+	GFraMe_ret rv = GFraMe_ret_failed;
+	GFraMe_tilemap *tmap;
+	int w, start, goal, tile, n;
+
+	tmap = nav->tmap;
+	w = tmap->width_in_tiles;
+	*len = 0;
+	if (!GFraMe_nav_is_free(tmap, sx, sy) || !GFraMe_nav_is_free(tmap, gx, gy))
+		goto _ret;
+	// A new query invalidates every tile at once
+	nav->query++;
+	if (nav->query == 0) {
+		int num = w * tmap->height_in_tiles;
+
+		memset(nav->seen, 0x0, sizeof(unsigned int) * num);
+		memset(nav->closed, 0x0, sizeof(unsigned int) * num);
+		nav->query = 1;
+	}
+	nav->num_open = 0;
+
+	start = sy * w + sx;
+	goal = gy * w + gx;
+	nav->g[start] = 0;
+	nav->parent[start] = -1;
+	nav->seen[start] = nav->query;
+	rv = GFraMe_nav_push(nav, GFraMe_nav_octile(sx, sy, gx, gy), start);
+	GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to search path", _ret);
+	rv = GFraMe_ret_failed;
+
+	while (nav->num_open > 0) {
+		int x, y, px, py, dirs[16], num_dirs, i;
+
+		tile = GFraMe_nav_pop(nav);
+		if (nav->closed[tile] == nav->query)
+			continue;
+		nav->closed[tile] = nav->query;
+		if (tile == goal) {
+			rv = GFraMe_ret_ok;
+			break;
+		}
+		x = tile % w;
+		y = tile / w;
+
+		// Prune the directions that a shorter path would already cover
+		num_dirs = 0;
+		if (nav->parent[tile] < 0) {
+			int dx, dy;
+
+			dy = -1;
+			while (dy <= 1) {
+				dx = -1;
+				while (dx <= 1) {
+					if ((dx != 0 || dy != 0)
+							&& GFraMe_nav_can_step(tmap, x, y, dx, dy)) {
+						dirs[num_dirs++] = dx;
+						dirs[num_dirs++] = dy;
+					}
+					dx++;
+				}
+				dy++;
+			}
+		}
+		else {
+			int dx, dy;
+
+			px = nav->parent[tile] % w;
+			py = nav->parent[tile] / w;
+			dx = (x > px) - (x < px);
+			dy = (y > py) - (y < py);
+			if (dx != 0 && dy != 0) {
+				int free_x, free_y;
+
+				free_x = GFraMe_nav_is_free(tmap, x + dx, y);
+				free_y = GFraMe_nav_is_free(tmap, x, y + dy);
+				if (free_y) {
+					dirs[num_dirs++] = 0;
+					dirs[num_dirs++] = dy;
+				}
+				if (free_x) {
+					dirs[num_dirs++] = dx;
+					dirs[num_dirs++] = 0;
+				}
+				if (free_x && free_y) {
+					dirs[num_dirs++] = dx;
+					dirs[num_dirs++] = dy;
+				}
+			}
+			else {
+				int side;
+
+				// Straight ahead and to both sides (and diagonally, past
+				//walls that ended)
+				side = -1;
+				while (side <= 1) {
+					int sdx, sdy;
+
+					sdx = (dx != 0) ? 0 : side;
+					sdy = (dx != 0) ? side : 0;
+					if (side == 0) {
+						dirs[num_dirs++] = dx;
+						dirs[num_dirs++] = dy;
+					}
+					else if (GFraMe_nav_is_free(tmap, x + sdx, y + sdy)) {
+						dirs[num_dirs++] = sdx;
+						dirs[num_dirs++] = sdy;
+						if (GFraMe_nav_is_free(tmap, x + dx, y + dy)) {
+							dirs[num_dirs++] = dx + sdx;
+							dirs[num_dirs++] = dy + sdy;
+						}
+					}
+					side++;
+				}
+			}
+		}
+
+		i = 0;
+		while (i < num_dirs) {
+			int jx, jy, jump, ng;
+
+			if (GFraMe_nav_jump(&jx, &jy, tmap, x + dirs[i], y + dirs[i + 1],
+								dirs[i], dirs[i + 1], gx, gy)) {
+				jump = jy * w + jx;
+				ng = nav->g[tile] + GFraMe_nav_octile(x, y, jx, jy);
+				if (nav->closed[jump] != nav->query
+						&& (nav->seen[jump] != nav->query
+							|| ng < nav->g[jump])) {
+					nav->g[jump] = ng;
+					nav->parent[jump] = tile;
+					nav->seen[jump] = nav->query;
+					rv = GFraMe_nav_push(nav, ng
+										 + GFraMe_nav_octile(jx, jy, gx, gy),
+										 jump);
+					GFraMe_assertRet(rv == GFraMe_ret_ok,
+									 "Failed to search path", _ret);
+					rv = GFraMe_ret_failed;
+				}
+			}
+			i += 2;
+		}
+	}
+	if (rv != GFraMe_ret_ok)
+		goto _ret;
+
+	// Count the points, then write them from the goal backward
+	n = 0;
+	tile = goal;
+	while (tile >= 0) {
+		n++;
+		tile = nav->parent[tile];
+	}
+	*len = n;
+	GFraMe_assertRV(n <= max_len, "Path doesn't fit",
+					rv = GFraMe_buffer_too_small, _ret);
+	tile = goal;
+	while (tile >= 0) {
+		n--;
+		path[2 * n] = tile % w;
+		path[2 * n + 1] = tile / w;
+		tile = nav->parent[tile];
+	}
+_ret:
+	return rv;
+}
+
+/**
+ * Initialize a flow field without a target
+ * @param	*field	The field
+ * @param	*tmap	The tilemap (must be already initialized)
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_flowfield_init(GFraMe_flowfield *field,
+								 GFraMe_tilemap *tmap) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	int num, i;
+
+	memset(field, 0x0, sizeof(GFraMe_flowfield));
+	field->tmap = tmap;
+	field->target_x = -1;
+	field->target_y = -1;
+	num = tmap->width_in_tiles * tmap->height_in_tiles;
+	field->dist = (int*)malloc(sizeof(int) * num);
+	GFraMe_assertRV(field->dist, "Failed to alloc flow field",
+					rv = GFraMe_ret_memory_error, _ret);
+	i = 0;
+	while (i < num) {
+		field->dist[i] = GFRAME_NAV_UNREACHABLE;
+		i++;
+	}
+_ret:
+	if (rv != GFraMe_ret_ok)
+		GFraMe_flowfield_clear(field);
+	return rv;
+}
+
+/**
+ * Release a flow field
+ * @param	*field	The field
+ */
+void GFraMe_flowfield_clear(GFraMe_flowfield *field) {
+	int i;
+
+	if (field->dist)
+		free(field->dist);
+	i = 0;
+	while (i < GFRAME_NAV_BUCKETS) {
+		if (field->buckets[i])
+			free(field->buckets[i]);
+		i++;
+	}
+	memset(field, 0x0, sizeof(GFraMe_flowfield));
+}
+
+/**
+ * Queue a tile to be visited at a distance
+ */
+static GFraMe_ret GFraMe_flowfield_push(GFraMe_flowfield *field, int dist,
+										int tile) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	int b;
+
+	b = dist % GFRAME_NAV_BUCKETS;
+	if (field->bucket_len[b] == field->bucket_max[b]) {
+		int *tmp, max;
+
+		max = field->bucket_max[b] * 2;
+		if (max == 0)
+			max = 256;
+		tmp = (int*)realloc(field->buckets[b], sizeof(int) * max);
+		GFraMe_assertRV(tmp, "Failed to expand flow field",
+						rv = GFraMe_ret_memory_error, _ret);
+		field->buckets[b] = tmp;
+		field->bucket_max[b] = max;
+	}
+	field->buckets[b][field->bucket_len[b]] = tile;
+	field->bucket_len[b]++;
+_ret:
+	return rv;
+}
+
+/**
+ * Spread distances from the target (which must have been queued at 0), only
+ *lowering them; since moves cost at most GFRAME_NAV_DIAGONAL, the tiles are
+ *visited in order from a few buckets (i.e., Dial's algorithm)
+ */
+static GFraMe_ret GFraMe_flowfield_spread(GFraMe_flowfield *field) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	GFraMe_tilemap *tmap;
+	int w, d, pending, b;
+
+	tmap = field->tmap;
+	w = tmap->width_in_tiles;
+	pending = field->bucket_len[0];
+	d = 0;
+	while (pending > 0) {
+		b = d % GFRAME_NAV_BUCKETS;
+		// Tiles queued on this bucket (while it's visited) are further ahead
+		while (field->bucket_len[b] > 0) {
+			int tile, x, y, dx, dy, i, is_free[9];
+
+			field->bucket_len[b]--;
+			pending--;
+			tile = field->buckets[b][field->bucket_len[b]];
+			// Skip tiles that were lowered after being queued
+			if (field->dist[tile] + field->offset != d)
+				continue;
+			x = tile % w;
+			y = tile / w;
+			// Check each neighbor once (diagonals depend on the straight ones)
+			i = 0;
+			dy = -1;
+			while (dy <= 1) {
+				dx = -1;
+				while (dx <= 1) {
+					is_free[i] = GFraMe_nav_is_free(tmap, x + dx, y + dy);
+					i++;
+					dx++;
+				}
+				dy++;
+			}
+			i = 0;
+			dy = -1;
+			while (dy <= 1) {
+				dx = -1;
+				while (dx <= 1) {
+					int n, nd;
+
+					// Neighbors are indexed as 3 * (dy + 1) + dx + 1
+					if (!is_free[i] || (dx == 0 && dy == 0)
+							|| (dx != 0 && dy != 0 && (!is_free[4 + dx]
+								|| !is_free[4 + 3 * dy]))) {
+						i++;
+						dx++;
+						continue;
+					}
+					n = tile + dy * w + dx;
+					nd = d + ((dx != 0 && dy != 0) ? GFRAME_NAV_DIAGONAL
+							  : GFRAME_NAV_STRAIGHT);
+					if (field->dist[n] == GFRAME_NAV_UNREACHABLE
+							|| nd < field->dist[n] + field->offset) {
+						field->dist[n] = nd - field->offset;
+						rv = GFraMe_flowfield_push(field, nd, n);
+						GFraMe_assertRet(rv == GFraMe_ret_ok,
+										 "Failed to spread flow field", _ret);
+						pending++;
+					}
+					i++;
+					dx++;
+				}
+				dy++;
+			}
+		}
+		d++;
+	}
+_ret:
+	if (rv != GFraMe_ret_ok)
+		memset(field->bucket_len, 0x0, sizeof(field->bucket_len));
+	return rv;
+}
+
+/**
+ * Compute the whole field again (e.g., after the tilemap changed)
+ * @param	*field	The field
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_flowfield_compute(GFraMe_flowfield *field) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	int num, i, target;
+
+	num = field->tmap->width_in_tiles * field->tmap->height_in_tiles;
+	i = 0;
+	while (i < num) {
+		field->dist[i] = GFRAME_NAV_UNREACHABLE;
+		i++;
+	}
+	field->offset = 0;
+	if (field->target_x < 0 || !GFraMe_nav_is_free(field->tmap,
+			field->target_x, field->target_y))
+		goto _ret;
+	target = field->target_y * field->tmap->width_in_tiles + field->target_x;
+	field->dist[target] = 0;
+	rv = GFraMe_flowfield_push(field, 0, target);
+	GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to compute flow field",
+					 _ret);
+	rv = GFraMe_flowfield_spread(field);
+_ret:
+	return rv;
+}
+
+/**
+ * Move the field's target; if it moved to a neighboring tile, only the tiles
+ *that got closer are updated (otherwise, the whole field is computed again)
+ * @param	*field	The field
+ * @param	tx	Target's horizontal position (in tiles)
+ * @param	ty	Target's vertical position (in tiles)
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_flowfield_set_target(GFraMe_flowfield *field, int tx,
+									   int ty) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	int dx, dy, target;
+
+	GFraMe_assertRV(tx >= 0 && ty >= 0 && tx < field->tmap->width_in_tiles
+					&& ty < field->tmap->height_in_tiles,
+					"Invalid target", rv = GFraMe_ret_bad_param, _ret);
+	dx = tx - field->target_x;
+	dy = ty - field->target_y;
+	if (dx == 0 && dy == 0 && field->target_x >= 0)
+		goto _ret;
+	if (field->target_x < 0 || dx < -1 || dx > 1 || dy < -1 || dy > 1
+			|| !GFraMe_nav_is_free(field->tmap, field->target_x,
+								   field->target_y)
+			|| !GFraMe_nav_can_step(field->tmap, field->target_x,
+									field->target_y, dx, dy)
+			|| field->offset > INT_MAX / 2) {
+		field->target_x = tx;
+		field->target_y = ty;
+		rv = GFraMe_flowfield_compute(field);
+		goto _ret;
+	}
+	// Going through the old target, every tile is at most one step further
+	//than it was; shift them all, then lower the ones that got closer
+	field->offset += (dx != 0 && dy != 0) ? GFRAME_NAV_DIAGONAL
+		: GFRAME_NAV_STRAIGHT;
+	field->target_x = tx;
+	field->target_y = ty;
+	target = ty * field->tmap->width_in_tiles + tx;
+	field->dist[target] = -field->offset;
+	rv = GFraMe_flowfield_push(field, 0, target);
+	GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to move flow field", _ret);
+	rv = GFraMe_flowfield_spread(field);
+_ret:
+	return rv;
+}
+
+/**
+ * Get a tile's distance to the target
+ * @param	*field	The field
+ * @param	tx	Tile's horizontal position (in tiles)
+ * @param	ty	Tile's vertical position (in tiles)
+ * @return	The distance (-1, if the target can't be reached)
+ */
+int GFraMe_flowfield_get_dist(GFraMe_flowfield *field, int tx, int ty) {
+	int d;
+
+	if (tx < 0 || ty < 0 || tx >= field->tmap->width_in_tiles
+			|| ty >= field->tmap->height_in_tiles)
+		return -1;
+	d = field->dist[ty * field->tmap->width_in_tiles + tx];
+	if (d == GFRAME_NAV_UNREACHABLE)
+		return -1;
+	return d + field->offset;
+}
+
+/**
+ * Get the direction of the next step toward the target
+ * @param	*dx	Returns the horizontal direction (-1, 0 or 1)
+ * @param	*dy	Returns the vertical direction (-1, 0 or 1)
+ * @param	*field	The field
+ * @param	tx	Tile's horizontal position (in tiles)
+ * @param	ty	Tile's vertical position (in tiles)
+ * @return	1 - There's a step; 0 - On the target or unreachable
+ */
+int GFraMe_flowfield_get_dir(int *dx, int *dy, GFraMe_flowfield *field,
+							 int tx, int ty) {
+	int best, i, j;
+
+	*dx = 0;
+	*dy = 0;
+	best = GFraMe_flowfield_get_dist(field, tx, ty);
+	if (best <= 0)
+		return 0;
+	j = -1;
+	while (j <= 1) {
+		i = -1;
+		while (i <= 1) {
+			if ((i != 0 || j != 0)
+					&& GFraMe_nav_can_step(field->tmap, tx, ty, i, j)) {
+				int d = GFraMe_flowfield_get_dist(field, tx + i, ty + j);
+
+				if (d >= 0 && d < best) {
+					best = d;
+					*dx = i;
+					*dy = j;
+				}
+			}
+			i++;
+		}
+		j++;
+	}
+	return *dx != 0 || *dy != 0;
+}
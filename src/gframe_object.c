@@ -6,6 +6,16 @@
 #include <GFraMe/GFraMe_object.h>
 #include <GFraMe/GFraMe_tween.h>
 #include <GFraMe/GFraMe_util.h>
+#include <stdint.h>
+#include <string.h>
+// SIMD is only used for doubles
+#if !defined(GFRAME_FIXED_POINT) && defined(__AVX__)
+#  define GFRAME_OVERLAP_AVX
+#  include <immintrin.h>
+#elif !defined(GFRAME_FIXED_POINT) && defined(__SSE2__)
+#  define GFRAME_OVERLAP_SSE2
+#  include <emmintrin.h>
+#endif
 
 /**
  * Clear every one of the object's attribute
@@ -16,13 +26,15 @@ void GFraMe_object_clear(GFraMe_object *obj) {
 	GFraMe_object_set_x(obj, 0);
 	GFraMe_object_set_y(obj, 0);
 	// Reset its velocity
-	obj->vx = 0.0;
-	obj->vy = 0.0;
+	obj->vx = 0;
+	obj->vy = 0;
 	// Reset its acceleration
-	obj->ax = 0.0;
-	obj->ay = 0.0;
+	obj->ax = 0;
+	obj->ay = 0;
 	// Reset collision
 	obj->hit = GFraMe_direction_none;
+	obj->layer = GFRAME_LAYER_DEFAULT;
+	obj->mask = GFRAME_MASK_ALL;
 	// Reset the hitbox
 	GFraMe_hitbox_set(GFraMe_object_get_hitbox(obj), GFraMe_hitbox_center, 
 					  0, 0, 0, 0);
@@ -30,6 +42,18 @@ void GFraMe_object_clear(GFraMe_object *obj) {
 	GFraMe_tween_clear(GFraMe_object_get_tween(obj));
 }
 
+/**
+ * Sets on which layers an object is and which ones it collides against
+ * @param	*obj	The object
+ * @param	layer	Bit mask with the object's layers
+ * @param	mask	Bit mask with the layers it collides against
+ */
+void GFraMe_object_set_layer(GFraMe_object *obj, uint32_t layer,
+							 uint32_t mask) {
+	obj->layer = layer;
+	obj->mask = mask;
+}
+
 /**
  * Sets an object horizontal position
  * @param	*obj	The object
@@ -38,9 +62,9 @@ void GFraMe_object_clear(GFraMe_object *obj) {
 void GFraMe_object_set_x(GFraMe_object *obj, int X) {
 	// Set the horizontal position
 	obj->x = X;
-	obj->dx = (double)X;
+	obj->dx = GFraMe_real_from_int(X);
 	// Setting this avoids glitches on collision
-	obj->ldx = (double)X;
+	obj->ldx = GFraMe_real_from_int(X);
 }
 
 /**
@@ -51,9 +75,9 @@ void GFraMe_object_set_x(GFraMe_object *obj, int X) {
 void GFraMe_object_set_y(GFraMe_object *obj, int Y) {
 	// Set the vertical position
 	obj->y = Y;
-	obj->dy = (double)Y;
+	obj->dy = GFraMe_real_from_int(Y);
 	// Setting this avoids glitches on collision
-	obj->ldy = (double)Y;
+	obj->ldy = GFraMe_real_from_int(Y);
 }
 
 /**
@@ -77,36 +101,188 @@ void GFraMe_object_set_pos(GFraMe_object *obj, int X, int Y) {
 void GFraMe_object_update(GFraMe_object *obj, int ms) {
 	GFraMe_tween *tw;
 	// Get the time in a nicer way to the integration
-	double time = ((double)ms) / 1000.0;
+	GFraMe_real time = GFraMe_util_divr(GFraMe_real_from_int(ms),
+										GFraMe_real_from_int(1000));
 	// Update last position (really important to collision)
 	obj->ldx = obj->dx;
 	obj->ldy = obj->dy;
-	// Try to update the position by tweening
+	// Try to update the position by tweening (objects that aren't tweening
+	// skip it right away)
 	tw = GFraMe_object_get_tween(obj);
-	if (GFraMe_tween_update(tw, time) == GFraMe_tween_ret_ok) {
+	if (tw->time < tw->maxTime &&
+		GFraMe_tween_update(tw, time) == GFraMe_tween_ret_ok) {
 		GFraMe_tween_set_obj(tw, obj);
 	}
 	else {
 		// Integrate the speed horizontally
-		if (obj->ax != 0.0)
-			obj->vx += GFraMe_util_integrate(obj->ax, time);
+		if (obj->ax != 0)
+			obj->vx += GFraMe_util_integrate_real(obj->ax, time);
 		// Integrate the position horizontally
-		if (obj->vx != 0.0)
-			obj->dx += GFraMe_util_integrate(obj->vx, time);
+		if (obj->vx != 0)
+			obj->dx += GFraMe_util_integrate_real(obj->vx, time);
 		// Integrate the velocity vertically
-		if (obj->ay != 0.0)
-			obj->vy += GFraMe_util_integrate(obj->ay, time);
+		if (obj->ay != 0)
+			obj->vy += GFraMe_util_integrate_real(obj->ay, time);
 		// Integrate the position vertically
-		if (obj->vy != 0.0)
-			obj->dy += GFraMe_util_integrate(obj->vy, time);
+		if (obj->vy != 0)
+			obj->dy += GFraMe_util_integrate_real(obj->vy, time);
 		// Set the actual display position
-		obj->x = (int)obj->dx;
-		obj->y = (int)obj->dy;
+		obj->x = GFraMe_real_to_int(obj->dx);
+		obj->y = GFraMe_real_to_int(obj->dy);
 	}
 	// Update the direction hit/that was hit
 	obj->hit = (obj->hit << GFM_LAST_BITS) & GFraMe_direction_last;
 }
 
+/**
+ * Check on which axis two overlapping objects weren't overlapping on the
+ * previous frame (i.e., on which axis they actually collided)
+ * @param	*o1	One of the objects
+ * @param	*o2	The other object
+ * @param	hmax	Maximum horizontal distance for overlap
+ * @param	vmax	Maximum vertical distance for overlap
+ * @param	*hcol	Returns whether they collided horizontally
+ * @param	*vcol	Returns whether they collided vertically
+ */
+static void GFraMe_object_get_collision(GFraMe_object *o1, GFraMe_object *o2,
+										GFraMe_real hmax, GFraMe_real vmax,
+										int *hcol, int *vcol) {
+	// Set overlap as having happened this frame only
+	*vcol = 1;
+	*hcol = 1;
+	//==============================================================//
+	// Note about my overlap implementation                         //
+	//==============================================================//
+	// If last frame they were already overlaping, then they aren't //
+	// actually overlapping on that "direction" (two objects may    //
+	// intersect vertically but not horizontally, e.g.:             //
+	//==============================================================//
+	//            time 0           -->           time 1             //
+	//==============================|===============================//
+	//             ----             |                               //
+	//             |  |             |                               //
+	//             ----             |             ----              //
+	//           --------           |           --|--|--            //
+	//           |      |           |           | ---- |            //
+	//           --------           |           --------            //
+	//==============================================================//
+	
+	// Check if it was already overlaping horizontally and clear it
+	if (GFraMe_util_absr(o2->ldx + o2->hitbox.cx - 
+						  o1->ldx - o1->hitbox.cx) < hmax) {
+		*hcol = 0;
+	}
+	// Check if it was already overlaping vertically and clear it
+	if (GFraMe_util_absr(o2->ldy + o2->hitbox.cy -
+						 o1->ldy - o1->hitbox.cy) < vmax) {
+		*vcol = 0;
+	}
+}
+
+/**
+ * Separate two objects, moving both by the same amount
+ */
+static void GFraMe_object_separate_full(GFraMe_object *o1, GFraMe_object *o2,
+										GFraMe_real hdist, GFraMe_real vdist,
+										int hcol, int vcol) {
+	// Don't use the set function because it only works for integers!!
+	
+	// If they weren't overlapping horizontally, separate it
+	if (hcol) {
+		// Move them by the same amount
+		o1->dx -= GFraMe_real_half(hdist);
+		o2->dx += GFraMe_real_half(hdist);
+		// Update the actual position!!
+		o1->x = GFraMe_real_to_int(o1->dx);
+		o2->x = GFraMe_real_to_int(o2->dx);
+	}
+	// If they weren't overlapping vertically, separate it
+	if (vcol) {
+		// Move them by the same amount
+		o1->dy -= GFraMe_real_half(vdist);
+		o2->dy += GFraMe_real_half(vdist);
+		// Update the actual position!!
+		o1->y = GFraMe_real_to_int(o1->dy);
+		o2->y = GFraMe_real_to_int(o2->dy);
+	}
+}
+
+/**
+ * Separate two objects, moving only one of them
+ * @param	*cur	Object that will be moved
+ * @param	*other	The static one
+ */
+static void GFraMe_object_separate_fixed(GFraMe_object *cur,
+										 GFraMe_object *other, GFraMe_real hmax,
+										 GFraMe_real vmax, int hcol, int vcol) {
+	// If they weren't overlapping horizontally, separate it
+	if (hcol) {
+		// Position it exactly grazing horizontally
+		cur->dx = other->dx + other->hitbox.cx - cur->hitbox.cx;
+		if (cur->ldx + cur->hitbox.cx > other->ldx + other->hitbox.cx) {
+            // GFraMe_log("right");
+			cur->dx += hmax;
+        }
+		else {
+            // GFraMe_log("left");
+			cur->dx -= hmax;
+        }
+		// Update the actual position!!
+		cur->x = GFraMe_real_to_int(cur->dx);
+	}
+	// If they weren't overlapping vertically, separate it
+	if (vcol) {
+		// Position it exactly grazing vertically
+		cur->dy = other->dy + other->hitbox.cy - cur->hitbox.cy;
+		if (cur->ldy + cur->hitbox.cy > other->ldy + other->hitbox.cy) {
+            // GFraMe_log("bellow");
+			cur->dy += vmax;
+        }
+		else {
+            // GFraMe_log("above");
+			cur->dy -= vmax;
+        }
+		// Update the actual position!!
+		cur->y = GFraMe_real_to_int(cur->dy);
+	}
+}
+
+/**
+ * Set the directions on which both objects collided
+ */
+static void GFraMe_object_set_hit(GFraMe_object *o1, GFraMe_object *o2,
+								  GFraMe_real hdist, GFraMe_real vdist,
+								  int hcol, int vcol) {
+	// TODO this will probably clear overlap after one frame...
+	// is it a problem?
+	
+	// Now, set all the flags
+	// If they are overlapping horizontally
+	if (hcol) {
+		// Check which was farther to the right/left
+		if (hdist > 0) {
+			o1->hit |= GFraMe_direction_right;
+			o2->hit |= GFraMe_direction_left;
+		}
+		else {
+			o1->hit |= GFraMe_direction_left;
+			o2->hit |= GFraMe_direction_right;
+		}
+	}
+	// If they are overlapping vertically
+	if (vcol) {
+		// Check which was higher/lower
+		if (vdist > 0) {
+			o1->hit |= GFraMe_direction_down;
+			o2->hit |= GFraMe_direction_up;
+		}
+		else {
+			o1->hit |= GFraMe_direction_up;
+			o2->hit |= GFraMe_direction_down;
+		}
+	}
+}
+
 /**
  * Overlaps two objects, according to the mode passed
  * @param	*o1	One of the objects to be overlaped
@@ -118,10 +294,10 @@ void GFraMe_object_update(GFraMe_object *obj, int ms) {
  */
 GFraMe_ret GFraMe_object_overlap(GFraMe_object *o1, GFraMe_object *o2,
 						   GFraMe_collision_type mode) {
-	double hdist;
-	double hmax;
-	double vdist;
-	double vmax;
+	GFraMe_real hdist;
+	GFraMe_real hmax;
+	GFraMe_real vdist;
+	GFraMe_real vmax;
 	GFraMe_ret rv = GFraMe_ret_no_overlap;
 	
 	// Compute horizontal distance
@@ -133,136 +309,443 @@ GFraMe_ret GFraMe_object_overlap(GFraMe_object *o1, GFraMe_object *o2,
 	// Compute maximum vertical distance for overlap
 	vmax = o2->hitbox.hh + o1->hitbox.hh;
 	// Check if the centers are closer than the maximum distances
-	if (GFraMe_util_absd(hdist) < hmax && GFraMe_util_absd(vdist) < vmax) {
-		// Set overlap as having happened this frame only
-		int vcol = 1;
-		int hcol = 1;
-		//==============================================================//
-		// Note about my overlap implementation                         //
-		//==============================================================//
-		// If last frame they were already overlaping, then they aren't //
-		// actually overlapping on that "direction" (two objects may    //
-		// intersect vertically but not horizontally, e.g.:             //
-		//==============================================================//
-		//            time 0           -->           time 1             //
-		//==============================|===============================//
-		//             ----             |                               //
-		//             |  |             |                               //
-		//             ----             |             ----              //
-		//           --------           |           --|--|--            //
-		//           |      |           |           | ---- |            //
-		//           --------           |           --------            //
-		//==============================================================//
-		
-		// Check if it was already overlaping horizontally and clear it
-		if (GFraMe_util_absd(o2->ldx + o2->hitbox.cx - 
-							  o1->ldx - o1->hitbox.cx) < hmax) {
-			hcol = 0;
-		}
-		// Check if it was already overlaping vertically and clear it
-		if (GFraMe_util_absd(o2->ldy + o2->hitbox.cy -
-							 o1->ldy - o1->hitbox.cy) < vmax) {
-			vcol = 0;
-		}
-		
-		// Don't use the set function because it only works for integers!!
+	if (GFraMe_util_absr(hdist) < hmax && GFraMe_util_absr(vdist) < vmax) {
+		int vcol;
+		int hcol;
 		
+		GFraMe_object_get_collision(o1, o2, hmax, vmax, &hcol, &vcol);
 		// If both objects should be moved to avoid visual collision
-		if (mode == GFraMe_collision_full) {
-			// If they weren't overlapping horizontally, separate it
-			if (hcol) {
-				// Move them by the same amount
-				o1->dx -= hdist * 0.5;
-				o2->dx += hdist * 0.5;
-				// Update the actual position!!
-				o1->x = (int)o1->dx;
-				o2->x = (int)o2->dx;
-			}
-			// If they weren't overlapping vertically, separate it
-			if (vcol) {
-				// Move them by the same amount
-				o1->dy -= vdist * 0.5;
-				o2->dy += vdist * 0.5;
-				// Update the actual position!!
-				o1->y = (int)o1->dy;
-				o2->y = (int)o2->dy;
-			}
-		}
+		if (mode == GFraMe_collision_full)
+			GFraMe_object_separate_full(o1, o2, hdist, vdist, hcol, vcol);
 		// Otherwise, if should actually collide (instead of only flag it)
 		else if (mode != GFraMe_dont_collide) {
-			GFraMe_object *cur, *other;
 			// Decide which object should be moved (cur) and
 			// which is the static one (other)
 			switch (mode) {
-				case GFraMe_first_fixed:  cur = o2; other = o1; break;
-				case GFraMe_second_fixed: cur = o1; other = o2; break;
-				default: goto _aftercol; // Avoids accessing null objects
+				case GFraMe_first_fixed:
+					GFraMe_object_separate_fixed(o2, o1, hmax, vmax, hcol,
+												 vcol);
+				break;
+				case GFraMe_second_fixed:
+					GFraMe_object_separate_fixed(o1, o2, hmax, vmax, hcol,
+												 vcol);
+				break;
+				default: break; // Avoids accessing null objects
 			}
-			// If they weren't overlapping horizontally, separate it
+		}
+		GFraMe_object_set_hit(o1, o2, hdist, vdist, hcol, vcol);
+		// Signal as overlap happening
+		rv = GFraMe_ret_ok;
+	}
+	// Return result
+	return rv;
+}
+
+/**
+ * How many objects are tested at once by GFraMe_object_overlap_many
+ */
+#define GFRAME_OVERLAP_LANES 4
+
+/**
+ * Check which of (up to) four objects overlap another one; this does the
+ * exact same math as GFraMe_object_overlap, so no false positive/negative
+ * is ever reported; objects whose layers don't match are never hit
+ * @param	*o	The object
+ * @param	**others	Objects tested against it
+ * @param	n	How many objects there are (at most GFRAME_OVERLAP_LANES)
+ * @return	Bit mask with every object that overlapped
+ */
+static int GFraMe_object_overlap_lanes(GFraMe_object *o,
+									   GFraMe_object **others, int n) {
+	GFraMe_real px[GFRAME_OVERLAP_LANES], py[GFRAME_OVERLAP_LANES];
+	GFraMe_real hw[GFRAME_OVERLAP_LANES], hh[GFRAME_OVERLAP_LANES];
+	int i, mask;
+	
+	// Gather the objects into lanes; unused lanes (and objects on other
+	// layers) are never hit
+	i = 0;
+	while (i < GFRAME_OVERLAP_LANES) {
+		if (i < n && GFraMe_object_layers_match(o, others[i])) {
+			px[i] = others[i]->dx + others[i]->hitbox.cx;
+			py[i] = others[i]->dy + others[i]->hitbox.cy;
+			hw[i] = others[i]->hitbox.hw;
+			hh[i] = others[i]->hitbox.hh;
+		}
+		else {
+			px[i] = 0;
+			py[i] = 0;
+			hw[i] = -o->hitbox.hw;
+			hh[i] = -o->hitbox.hh;
+		}
+		i++;
+	}
+	
+#if defined(GFRAME_OVERLAP_AVX)
+	{
+		__m256d sign, dist, max, ok;
+		
+		sign = _mm256_set1_pd(-0.0);
+		// |(other.x + other.cx) - o.x - o.cx| < other.hw + o.hw
+		dist = _mm256_sub_pd(_mm256_loadu_pd(px), _mm256_set1_pd(o->dx));
+		dist = _mm256_sub_pd(dist, _mm256_set1_pd(o->hitbox.cx));
+		max = _mm256_add_pd(_mm256_loadu_pd(hw), _mm256_set1_pd(o->hitbox.hw));
+		ok = _mm256_cmp_pd(_mm256_andnot_pd(sign, dist), max, _CMP_LT_OQ);
+		// Same thing, vertically
+		dist = _mm256_sub_pd(_mm256_loadu_pd(py), _mm256_set1_pd(o->dy));
+		dist = _mm256_sub_pd(dist, _mm256_set1_pd(o->hitbox.cy));
+		max = _mm256_add_pd(_mm256_loadu_pd(hh), _mm256_set1_pd(o->hitbox.hh));
+		ok = _mm256_and_pd(ok, _mm256_cmp_pd(_mm256_andnot_pd(sign, dist),
+											 max, _CMP_LT_OQ));
+		mask = _mm256_movemask_pd(ok);
+	}
+#elif defined(GFRAME_OVERLAP_SSE2)
+	{
+		__m128d sign, dist, max, ok;
+		
+		sign = _mm_set1_pd(-0.0);
+		mask = 0;
+		i = 0;
+		while (i < GFRAME_OVERLAP_LANES) {
+			// |(other.x + other.cx) - o.x - o.cx| < other.hw + o.hw
+			dist = _mm_sub_pd(_mm_loadu_pd(px + i), _mm_set1_pd(o->dx));
+			dist = _mm_sub_pd(dist, _mm_set1_pd(o->hitbox.cx));
+			max = _mm_add_pd(_mm_loadu_pd(hw + i), _mm_set1_pd(o->hitbox.hw));
+			ok = _mm_cmplt_pd(_mm_andnot_pd(sign, dist), max);
+			// Same thing, vertically
+			dist = _mm_sub_pd(_mm_loadu_pd(py + i), _mm_set1_pd(o->dy));
+			dist = _mm_sub_pd(dist, _mm_set1_pd(o->hitbox.cy));
+			max = _mm_add_pd(_mm_loadu_pd(hh + i), _mm_set1_pd(o->hitbox.hh));
+			ok = _mm_and_pd(ok, _mm_cmplt_pd(_mm_andnot_pd(sign, dist), max));
+			mask |= _mm_movemask_pd(ok) << i;
+			i += 2;
+		}
+	}
+#else
+	mask = 0;
+	i = 0;
+	while (i < GFRAME_OVERLAP_LANES) {
+		if (GFraMe_util_absr(px[i] - o->dx - o->hitbox.cx) <
+				hw[i] + o->hitbox.hw &&
+			GFraMe_util_absr(py[i] - o->dy - o->hitbox.cy) <
+				hh[i] + o->hitbox.hh)
+			mask |= 1 << i;
+		i++;
+	}
+#endif
+	
+	return mask;
+}
+
+/**
+ * Generate a kernel for GFraMe_object_overlap_many; 'resolve' is run for every
+ * object that overlapped, with 'o' and 'other' as the overlapping objects;
+ * if 'moves_o' is set, the remaining lanes are re-tested after each hit, as
+ * 'o' was (possibly) moved
+ */
+#define GFRAME_OVERLAP_KERNEL(name, moves_o, resolve) \
+static int name(GFraMe_object *o, GFraMe_object **others, int n, \
+				uint64_t *hitmask) { \
+	int count = 0; \
+	int i = 0; \
+	while (i < n) { \
+		int len = n - i; \
+		int mask, lane; \
+		if (len > GFRAME_OVERLAP_LANES) \
+			len = GFRAME_OVERLAP_LANES; \
+		mask = GFraMe_object_overlap_lanes(o, others + i, len); \
+		lane = 0; \
+		while (mask >> lane) { \
+			if (mask & (1 << lane)) { \
+				GFraMe_object *other = others[i + lane]; \
+				GFraMe_real hdist, vdist, hmax, vmax; \
+				int hcol, vcol; \
+				hdist = other->dx + other->hitbox.cx - o->dx - o->hitbox.cx; \
+				vdist = other->dy + other->hitbox.cy - o->dy - o->hitbox.cy; \
+				hmax = other->hitbox.hw + o->hitbox.hw; \
+				vmax = other->hitbox.hh + o->hitbox.hh; \
+				GFraMe_object_get_collision(o, other, hmax, vmax, &hcol, \
+											&vcol); \
+				resolve; \
+				GFraMe_object_set_hit(o, other, hdist, vdist, hcol, vcol); \
+				if (hitmask) \
+					hitmask[(i + lane) >> 6] |= (uint64_t)1 << \
+												((i + lane) & 63); \
+				count++; \
+				if (moves_o && (hcol || vcol)) \
+					mask = GFraMe_object_overlap_lanes(o, others + i, len) & \
+						   ~((2 << lane) - 1); \
+			} \
+			lane++; \
+		} \
+		i += len; \
+	} \
+	return count; \
+}
+
+GFRAME_OVERLAP_KERNEL(GFraMe_object_overlap_many_flags, 0, (void)0)
+GFRAME_OVERLAP_KERNEL(GFraMe_object_overlap_many_first, 0,
+	GFraMe_object_separate_fixed(other, o, hmax, vmax, hcol, vcol))
+GFRAME_OVERLAP_KERNEL(GFraMe_object_overlap_many_second, 1,
+	GFraMe_object_separate_fixed(o, other, hmax, vmax, hcol, vcol))
+GFRAME_OVERLAP_KERNEL(GFraMe_object_overlap_many_full, 1,
+	GFraMe_object_separate_full(o, other, hdist, vdist, hcol, vcol))
+
+#undef GFRAME_OVERLAP_KERNEL
+
+/**
+ * Overlaps one object against many others; the result is the same as calling
+ * GFraMe_object_overlap(o, others[i], mode) for each one, in order, but most
+ * objects are rejected a few at a time (using SIMD, if available)
+ * @param	*o	The object overlapped against every other
+ * @param	**others	Objects to be overlapped
+ * @param	n	How many objects there are
+ * @param	mode	How collision should be handle ('o' is the first object)
+ * @param	*hitmask	Bit array ((n + 63) / 64 words) where every object
+ *			  that overlapped is set; may be NULL
+ * @return	How many objects overlapped
+ */
+int GFraMe_object_overlap_many(GFraMe_object *o, GFraMe_object **others,
+							   int n, GFraMe_collision_type mode,
+							   uint64_t *hitmask) {
+	// Clear the mask
+	if (hitmask)
+		memset(hitmask, 0x0, sizeof(uint64_t) * ((n + 63) / 64));
+	// Select the kernel only once, instead of on every pair
+	switch (mode) {
+		case GFraMe_dont_collide:
+			return GFraMe_object_overlap_many_flags(o, others, n, hitmask);
+		case GFraMe_first_fixed:
+			return GFraMe_object_overlap_many_first(o, others, n, hitmask);
+		case GFraMe_second_fixed:
+			return GFraMe_object_overlap_many_second(o, others, n, hitmask);
+		case GFraMe_collision_full:
+			return GFraMe_object_overlap_many_full(o, others, n, hitmask);
+		default: break;
+	}
+	return 0;
+}
+
+/**
+ * Find when (as a fraction of the movement) the distance between two objects,
+ *on a single axis, gets inside the overlap range
+ * @param	dist	Distance between them, at the start
+ * @param	delta	How much the distance changed during the movement
+ * @param	max	Maximum distance for overlap
+ * @param	*entry	When they started overlapping
+ * @param	*exit	When they stopped overlapping
+ * @return	0 - They never overlapped; 1 - Otherwise
+ */
+static int GFraMe_object_sweep_axis(GFraMe_real dist, GFraMe_real delta,
+									GFraMe_real max, GFraMe_real *entry,
+									GFraMe_real *exit) {
+	if (delta == 0) {
+		// Either they always overlapped or never did
+		if (GFraMe_util_absr(dist) >= max)
+			return 0;
+		*entry = GFRAME_REAL_MIN;
+		*exit = GFRAME_REAL_MAX;
+	}
+	else if (delta > 0) {
+		*entry = GFraMe_util_divr(-max - dist, delta);
+		*exit = GFraMe_util_divr(max - dist, delta);
+	}
+	else {
+		*entry = GFraMe_util_divr(max - dist, delta);
+		*exit = GFraMe_util_divr(-max - dist, delta);
+	}
+	return 1;
+}
+
+/**
+ * Find when two objects started touching during their last update, by
+ *sweeping their hitboxes from their last position (ldx, ldy) to the current
+ *one (dx, dy); objects that were already overlapping aren't reported
+ * @param	*o1	One of the objects
+ * @param	*o2	The other object
+ * @param	*time	Returns the fraction of the movement (in [0, 1)) when they
+ *			  touched
+ * @param	*axis	Returns on which axis they touched
+ *			  (GAME_HORIZONTAL_COLLISION and/or GAME_VERTICAL_COLLISION)
+ * @return	Whether they touched (GFraMe_ret_ok) or not (GFraMe_ret_no_overlap)
+ */
+GFraMe_ret GFraMe_object_sweep(GFraMe_object *o1, GFraMe_object *o2,
+							   GFraMe_real *time, int *axis) {
+	GFraMe_real hentry, hexit, ventry, vexit, entry, exit;
+	
+	// Get when they overlap on each axis (o1's movement relative to o2's)
+	if (!GFraMe_object_sweep_axis(o1->ldx + o1->hitbox.cx - o2->ldx -
+								  o2->hitbox.cx,
+								  (o1->dx - o1->ldx) - (o2->dx - o2->ldx),
+								  o1->hitbox.hw + o2->hitbox.hw, &hentry,
+								  &hexit))
+		return GFraMe_ret_no_overlap;
+	if (!GFraMe_object_sweep_axis(o1->ldy + o1->hitbox.cy - o2->ldy -
+								  o2->hitbox.cy,
+								  (o1->dy - o1->ldy) - (o2->dy - o2->ldy),
+								  o1->hitbox.hh + o2->hitbox.hh, &ventry,
+								  &vexit))
+		return GFraMe_ret_no_overlap;
+	// They touch when both axis overlap
+	entry = hentry > ventry ? hentry : ventry;
+	exit = hexit < vexit ? hexit : vexit;
+	// Ignore objects that were already touching or that didn't reach
+	if (entry < 0 || entry >= GFraMe_real_from_int(1) || entry >= exit)
+		return GFraMe_ret_no_overlap;
+	*time = entry;
+	*axis = 0;
+	if (hentry == entry)
+		*axis |= GAME_HORIZONTAL_COLLISION;
+	if (ventry == entry)
+		*axis |= GAME_VERTICAL_COLLISION;
+	return GFraMe_ret_ok;
+}
+
+/**
+ * Resolve a contact found by GFraMe_object_sweep
+ */
+static void GFraMe_object_resolve_swept(GFraMe_object *o1, GFraMe_object *o2,
+										GFraMe_collision_type mode,
+										GFraMe_real time, int axis) {
+	GFraMe_real hdist, vdist, hmax, vmax;
+	int hcol, vcol;
+	
+	// Use the distance before moving, since they may have passed through
+	hdist = o2->ldx + o2->hitbox.cx - o1->ldx - o1->hitbox.cx;
+	vdist = o2->ldy + o2->hitbox.cy - o1->ldy - o1->hitbox.cy;
+	hmax = o2->hitbox.hw + o1->hitbox.hw;
+	vmax = o2->hitbox.hh + o1->hitbox.hh;
+	hcol = (axis & GAME_HORIZONTAL_COLLISION) != 0;
+	vcol = (axis & GAME_VERTICAL_COLLISION) != 0;
+	switch (mode) {
+		case GFraMe_collision_full:
+			// Stop both objects where they touched
 			if (hcol) {
-				// Position it exactly grazing horizontally
-				cur->dx = other->dx + other->hitbox.cx - cur->hitbox.cx;
-				if (cur->ldx + cur->hitbox.cx > other->ldx + other->hitbox.cx) {
-                    // GFraMe_log("right");
-					cur->dx += hmax;
-                }
-				else {
-                    // GFraMe_log("left");
-					cur->dx -= hmax;
-                }
-				// Update the actual position!!
-				cur->x = (int)cur->dx;
+				o1->dx = o1->ldx + GFraMe_real_mul(o1->dx - o1->ldx, time);
+				o2->dx = o2->ldx + GFraMe_real_mul(o2->dx - o2->ldx, time);
+				o1->x = GFraMe_real_to_int(o1->dx);
+				o2->x = GFraMe_real_to_int(o2->dx);
 			}
-			// If they weren't overlapping vertically, separate it
 			if (vcol) {
-				// Position it exactly grazing vertically
-				cur->dy = other->dy + other->hitbox.cy - cur->hitbox.cy;
-				if (cur->ldy + cur->hitbox.cy > other->ldy + other->hitbox.cy) {
-                    // GFraMe_log("bellow");
-					cur->dy += vmax;
-                }
-				else {
-                    // GFraMe_log("above");
-					cur->dy -= vmax;
-                }
-				// Update the actual position!!
-				cur->y = (int)cur->dy;
+				o1->dy = o1->ldy + GFraMe_real_mul(o1->dy - o1->ldy, time);
+				o2->dy = o2->ldy + GFraMe_real_mul(o2->dy - o2->ldy, time);
+				o1->y = GFraMe_real_to_int(o1->dy);
+				o2->y = GFraMe_real_to_int(o2->dy);
 			}
+		break;
+		case GFraMe_first_fixed:
+			GFraMe_object_separate_fixed(o2, o1, hmax, vmax, hcol, vcol);
+		break;
+		case GFraMe_second_fixed:
+			GFraMe_object_separate_fixed(o1, o2, hmax, vmax, hcol, vcol);
+		break;
+		default: break;
+	}
+	GFraMe_object_set_hit(o1, o2, hdist, vdist, hcol, vcol);
+}
+
+/**
+ * Overlaps two objects, just like GFraMe_object_overlap, but also collides
+ *objects that passed through each other during their last update (e.g., fast
+ *bullets and thin platforms)
+ * @param	*o1	One of the objects to be overlaped
+ * @param	*o2	The other object to be overlaped
+ * @param	mode	How collision should be handle
+ * @return	Whether an overlap occured (GFraMe_ret_ok) or not (GFraMe_ret_no_overlap)
+ */
+GFraMe_ret GFraMe_object_overlap_swept(GFraMe_object *o1, GFraMe_object *o2,
+									   GFraMe_collision_type mode) {
+	GFraMe_real time;
+	int axis;
+	
+	// Objects that are overlapping are handled as usual
+	if (GFraMe_object_overlap(o1, o2, mode) == GFraMe_ret_ok)
+		return GFraMe_ret_ok;
+	// Otherwise, check if they passed through each other
+	if (GFraMe_object_sweep(o1, o2, &time, &axis) != GFraMe_ret_ok)
+		return GFraMe_ret_no_overlap;
+	GFraMe_object_resolve_swept(o1, o2, mode, time, axis);
+	return GFraMe_ret_ok;
+}
+
+/**
+ * Collides one object against many others using their swept hitboxes; the
+ *earliest contact is always resolved first (and every other is then checked
+ *again), so an object that hits many others on a single update stops at the
+ *first one
+ * @param	*o	The object collided against every other
+ * @param	**others	Objects to be collided
+ * @param	n	How many objects there are
+ * @param	mode	How collision should be handle ('o' is the first object)
+ * @param	*hitmask	Bit array ((n + 63) / 64 words) where every object
+ *			  that overlapped is set; may be NULL
+ * @return	How many contacts were resolved
+ */
+int GFraMe_object_overlap_swept_many(GFraMe_object *o, GFraMe_object **others,
+									 int n, GFraMe_collision_type mode,
+									 uint64_t *hitmask) {
+	int count, i, rounds;
+	
+	// Clear the mask
+	if (hitmask)
+		memset(hitmask, 0x0, sizeof(uint64_t) * ((n + 63) / 64));
+	count = 0;
+	// Since nothing moves, every contact may be reported at once
+	if (mode == GFraMe_dont_collide) {
+		i = 0;
+		while (i < n) {
+			if (GFraMe_object_layers_match(o, others[i]) &&
+				GFraMe_object_overlap_swept(o, others[i], mode)
+					== GFraMe_ret_ok) {
+				if (hitmask)
+					hitmask[i >> 6] |= (uint64_t)1 << (i & 63);
+				count++;
+			}
+			i++;
 		}
-_aftercol:
-		// TODO this will probably clear overlap after one frame...
-		// is it a problem?
+		return count;
+	}
+	// Resolve the earliest contact until there are none left (each contact
+	// changes the objects' movement, so every other must be checked again)
+	rounds = 0;
+	while (rounds < n) {
+		GFraMe_real best_time, time;
+		int best, best_axis, axis;
 		
-		// Now, set all the flags
-		// If they are overlapping horizontally
-		if (hcol) {
-			// Check which was farther to the right/left
-			if (hdist > 0) {
-				o1->hit |= GFraMe_direction_right;
-				o2->hit |= GFraMe_direction_left;
-			}
-			else {
-				o1->hit |= GFraMe_direction_left;
-				o2->hit |= GFraMe_direction_right;
+		best = -1;
+		best_time = GFraMe_real_from_int(1);
+		best_axis = 0;
+		i = 0;
+		while (i < n) {
+			if (GFraMe_object_layers_match(o, others[i]) &&
+				GFraMe_object_sweep(o, others[i], &time, &axis)
+					== GFraMe_ret_ok && time < best_time) {
+				best = i;
+				best_time = time;
+				best_axis = axis;
 			}
+			i++;
 		}
-		// If they are overlapping vertically
-		if (vcol) {
-			// Check which was higher/lower
-			if (vdist > 0) {
-				o1->hit |= GFraMe_direction_down;
-				o2->hit |= GFraMe_direction_up;
-			}
-			else {
-				o1->hit |= GFraMe_direction_up;
-				o2->hit |= GFraMe_direction_down;
-			}
+		if (best < 0)
+			break;
+		GFraMe_object_resolve_swept(o, others[best], mode, best_time,
+									best_axis);
+		if (hitmask)
+			hitmask[best >> 6] |= (uint64_t)1 << (best & 63);
+		count++;
+		rounds++;
+	}
+	// Lastly, handle objects that were already overlapping
+	i = 0;
+	while (i < n) {
+		if (GFraMe_object_layers_match(o, others[i]) &&
+			GFraMe_object_overlap(o, others[i], mode) == GFraMe_ret_ok) {
+			if (hitmask)
+				hitmask[i >> 6] |= (uint64_t)1 << (i & 63);
+			count++;
 		}
-		// Signal as overlap happening
-		rv = GFraMe_ret_ok;
+		i++;
 	}
-	// Return result
-	return rv;
+	return count;
 }
 
 GFraMe_hitbox *GFraMe_object_get_hitbox(GFraMe_object *obj) {
@@ -0,0 +1,478 @@
+/**
+ * @src/gframe_object_pool.c
+ */
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_hitbox.h>
+#include <GFraMe/GFraMe_object.h>
+#include <GFraMe/GFraMe_object_pool.h>
+#include <GFraMe/GFraMe_tween.h>
+#include <GFraMe/GFraMe_util.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// SIMD is only used for doubles
+#if !defined(GFRAME_FIXED_POINT) && defined(__AVX__)
+#  define GFRAME_POOL_AVX
+#  include <immintrin.h>
+#elif !defined(GFRAME_FIXED_POINT) && defined(__SSE2__)
+#  define GFRAME_POOL_SSE2
+#  include <emmintrin.h>
+#endif
+
+/**
+ * How many bits of a handle are used by its slot
+ */
+#define GFRAME_POOL_SLOT_BITS 16
+#define GFRAME_POOL_SLOT_MASK ((1 << GFRAME_POOL_SLOT_BITS) - 1)
+/**
+ * Mask for generations (keeps handles positive)
+ */
+#define GFRAME_POOL_GEN_MASK 0x7fff
+/**
+ * Alignment of every array (enough for AVX)
+ */
+#define GFRAME_POOL_ALIGN 32
+
+/**
+ * Round a size up to the alignment
+ */
+static size_t GFraMe_object_pool_align(size_t size) {
+	return (size + GFRAME_POOL_ALIGN - 1) & ~((size_t)GFRAME_POOL_ALIGN - 1);
+}
+
+/**
+ * Get the slot of a valid handle, or -1
+ */
+static int GFraMe_object_pool_get_slot(GFraMe_object_pool *pool,
+									   GFraMe_object_handle handle) {
+	int slot;
+
+	if (handle < 0)
+		return -1;
+	slot = handle & GFRAME_POOL_SLOT_MASK;
+	if (slot >= pool->max)
+		return -1;
+	if (pool->generation[slot] != (handle >> GFRAME_POOL_SLOT_BITS))
+		return -1;
+	// Check that the slot is in use
+	if (pool->index[slot] < 0 || pool->index[slot] >= pool->num
+			|| pool->slot[pool->index[slot]] != slot)
+		return -1;
+	return slot;
+}
+
+/**
+ * Initialize a pool
+ * @param	*pool	Pool to be initialized
+ * @param	max	How many objects fit on the pool (at most 65536)
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_object_pool_init(GFraMe_object_pool *pool, int max) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	size_t dsize, isize, lsize, hsize, size;
+	uintptr_t addr;
+	char *mem;
+	int cap, i;
+
+	memset(pool, 0x0, sizeof(GFraMe_object_pool));
+	GFraMe_assertRV(max > 0 && max <= GFRAME_POOL_SLOT_MASK + 1,
+					"Invalid pool size", rv = GFraMe_ret_bad_param, _ret);
+	// Pad the arrays so vectors never go out of bounds
+	cap = (max + 3) & ~3;
+	dsize = GFraMe_object_pool_align(sizeof(GFraMe_real) * cap);
+	isize = GFraMe_object_pool_align(sizeof(int) * cap);
+	lsize = GFraMe_object_pool_align(sizeof(uint32_t) * cap);
+	hsize = GFraMe_object_pool_align(sizeof(GFraMe_hitbox) * cap);
+	// Alloc every array at once
+	size = dsize * 8 + isize * 6 + lsize * 2 + hsize + GFRAME_POOL_ALIGN;
+	pool->mem = malloc(size);
+	GFraMe_assertRV(pool->mem, "Failed to alloc pool",
+					rv = GFraMe_ret_memory_error, _ret);
+	memset(pool->mem, 0x0, size);
+	// Align the first array
+	addr = (uintptr_t)pool->mem;
+	addr = (addr + GFRAME_POOL_ALIGN - 1) & ~((uintptr_t)GFRAME_POOL_ALIGN - 1);
+	mem = (char*)addr;
+	// Split the memory between the arrays
+	pool->dx = (GFraMe_real*)mem; mem += dsize;
+	pool->dy = (GFraMe_real*)mem; mem += dsize;
+	pool->ldx = (GFraMe_real*)mem; mem += dsize;
+	pool->ldy = (GFraMe_real*)mem; mem += dsize;
+	pool->vx = (GFraMe_real*)mem; mem += dsize;
+	pool->vy = (GFraMe_real*)mem; mem += dsize;
+	pool->ax = (GFraMe_real*)mem; mem += dsize;
+	pool->ay = (GFraMe_real*)mem; mem += dsize;
+	pool->x = (int*)mem; mem += isize;
+	pool->y = (int*)mem; mem += isize;
+	pool->hit = (int*)mem; mem += isize;
+	pool->slot = (int*)mem; mem += isize;
+	pool->index = (int*)mem; mem += isize;
+	pool->generation = (int*)mem; mem += isize;
+	pool->layer = (uint32_t*)mem; mem += lsize;
+	pool->mask = (uint32_t*)mem; mem += lsize;
+	pool->hitbox = (GFraMe_hitbox*)mem;
+	// Chain every free slot
+	i = 0;
+	while (i < max) {
+		pool->index[i] = i + 1;
+		i++;
+	}
+	pool->index[max - 1] = -1;
+	pool->free_slot = 0;
+	pool->num = 0;
+	pool->max = max;
+_ret:
+	if (rv != GFraMe_ret_ok)
+		GFraMe_object_pool_clear(pool);
+	return rv;
+}
+
+/**
+ * Release every memory used by the pool
+ * @param	*pool	The pool
+ */
+void GFraMe_object_pool_clear(GFraMe_object_pool *pool) {
+	if (pool->mem)
+		free(pool->mem);
+	memset(pool, 0x0, sizeof(GFraMe_object_pool));
+	pool->free_slot = -1;
+}
+
+/**
+ * Add an object to the pool
+ * @param	*pool	The pool
+ * @param	*obj	Object whose state is copied into the pool; if NULL, the
+ *			  new object is cleared
+ * @param	*handle	Returns the new object's handle
+ * @return	GFraMe_ret_ok - Success; GFraMe_buffer_too_small - Pool is full
+ */
+GFraMe_ret GFraMe_object_pool_add(GFraMe_object_pool *pool, GFraMe_object *obj,
+								  GFraMe_object_handle *handle) {
+	GFraMe_ret rv;
+	int i, slot;
+
+	GFraMe_assertRV(pool->free_slot >= 0, "Object pool is full",
+					rv = GFraMe_buffer_too_small, _ret);
+	// Get a free slot
+	slot = pool->free_slot;
+	pool->free_slot = pool->index[slot];
+	// Put the object after every other
+	i = pool->num;
+	pool->num++;
+	pool->index[slot] = i;
+	pool->slot[i] = slot;
+	*handle = (pool->generation[slot] << GFRAME_POOL_SLOT_BITS) | slot;
+	// Set its state
+	if (obj) {
+		GFraMe_object_pool_store(pool, *handle, obj);
+	}
+	else {
+		pool->dx[i] = 0;
+		pool->dy[i] = 0;
+		pool->ldx[i] = 0;
+		pool->ldy[i] = 0;
+		pool->vx[i] = 0;
+		pool->vy[i] = 0;
+		pool->ax[i] = 0;
+		pool->ay[i] = 0;
+		pool->x[i] = 0;
+		pool->y[i] = 0;
+		pool->hit[i] = GFraMe_direction_none;
+		pool->layer[i] = GFRAME_LAYER_DEFAULT;
+		pool->mask[i] = GFRAME_MASK_ALL;
+		GFraMe_hitbox_set(&pool->hitbox[i], GFraMe_hitbox_center, 0, 0, 0, 0);
+	}
+	rv = GFraMe_ret_ok;
+_ret:
+	return rv;
+}
+
+/**
+ * Remove an object from the pool; the last object is moved to its index
+ * @param	*pool	The pool
+ * @param	handle	The object
+ * @return	GFraMe_ret_ok - Success; GFraMe_ret_bad_param - Invalid handle
+ */
+GFraMe_ret GFraMe_object_pool_remove(GFraMe_object_pool *pool,
+									 GFraMe_object_handle handle) {
+	GFraMe_ret rv;
+	int i, last, slot;
+
+	slot = GFraMe_object_pool_get_slot(pool, handle);
+	GFraMe_assertRV(slot >= 0, "Invalid object handle",
+					rv = GFraMe_ret_bad_param, _ret);
+	i = pool->index[slot];
+	last = pool->num - 1;
+	// Move the last object into the removed one's place
+	if (i != last) {
+		pool->dx[i] = pool->dx[last];
+		pool->dy[i] = pool->dy[last];
+		pool->ldx[i] = pool->ldx[last];
+		pool->ldy[i] = pool->ldy[last];
+		pool->vx[i] = pool->vx[last];
+		pool->vy[i] = pool->vy[last];
+		pool->ax[i] = pool->ax[last];
+		pool->ay[i] = pool->ay[last];
+		pool->x[i] = pool->x[last];
+		pool->y[i] = pool->y[last];
+		pool->hit[i] = pool->hit[last];
+		pool->layer[i] = pool->layer[last];
+		pool->mask[i] = pool->mask[last];
+		pool->hitbox[i] = pool->hitbox[last];
+		pool->slot[i] = pool->slot[last];
+		pool->index[pool->slot[i]] = i;
+	}
+	pool->num--;
+	// Invalidate every handle to the slot and release it
+	pool->generation[slot] = (pool->generation[slot] + 1) & GFRAME_POOL_GEN_MASK;
+	pool->index[slot] = pool->free_slot;
+	pool->free_slot = slot;
+	rv = GFraMe_ret_ok;
+_ret:
+	return rv;
+}
+
+/**
+ * Get where an object is stored, so its arrays can be accessed directly; the
+ *index changes whenever an object is removed
+ * @param	*pool	The pool
+ * @param	handle	The object
+ * @return	The object's index or -1, if the handle is invalid
+ */
+int GFraMe_object_pool_get_index(GFraMe_object_pool *pool,
+								 GFraMe_object_handle handle) {
+	int slot;
+
+	slot = GFraMe_object_pool_get_slot(pool, handle);
+	if (slot < 0)
+		return -1;
+	return pool->index[slot];
+}
+
+/**
+ * Get the handle of the object at an index
+ * @param	*pool	The pool
+ * @param	index	The object's index
+ * @return	The object's handle
+ */
+GFraMe_object_handle GFraMe_object_pool_get_handle(GFraMe_object_pool *pool,
+												   int index) {
+	int slot;
+
+	if (index < 0 || index >= pool->num)
+		return GFraMe_object_handle_none;
+	slot = pool->slot[index];
+	return (pool->generation[slot] << GFRAME_POOL_SLOT_BITS) | slot;
+}
+
+/**
+ * Copy an object from the pool
+ * @param	*pool	The pool
+ * @param	handle	The object
+ * @param	*obj	Where the object is copied to (its tween is cleared)
+ * @return	GFraMe_ret_ok - Success; GFraMe_ret_bad_param - Invalid handle
+ */
+GFraMe_ret GFraMe_object_pool_load(GFraMe_object_pool *pool,
+								   GFraMe_object_handle handle,
+								   GFraMe_object *obj) {
+	GFraMe_ret rv;
+	int i;
+
+	i = GFraMe_object_pool_get_index(pool, handle);
+	GFraMe_assertRV(i >= 0, "Invalid object handle", rv = GFraMe_ret_bad_param,
+					_ret);
+	obj->x = pool->x[i];
+	obj->y = pool->y[i];
+	obj->dx = pool->dx[i];
+	obj->dy = pool->dy[i];
+	obj->ldx = pool->ldx[i];
+	obj->ldy = pool->ldy[i];
+	obj->vx = pool->vx[i];
+	obj->vy = pool->vy[i];
+	obj->ax = pool->ax[i];
+	obj->ay = pool->ay[i];
+	obj->hit = (GFraMe_direction)pool->hit[i];
+	obj->layer = pool->layer[i];
+	obj->mask = pool->mask[i];
+	obj->hitbox = pool->hitbox[i];
+	GFraMe_tween_clear(GFraMe_object_get_tween(obj));
+	rv = GFraMe_ret_ok;
+_ret:
+	return rv;
+}
+
+/**
+ * Copy an object back into the pool (e.g., after being overlapped)
+ * @param	*pool	The pool
+ * @param	handle	The object
+ * @param	*obj	Object to be copied (its tween is ignored)
+ * @return	GFraMe_ret_ok - Success; GFraMe_ret_bad_param - Invalid handle
+ */
+GFraMe_ret GFraMe_object_pool_store(GFraMe_object_pool *pool,
+									GFraMe_object_handle handle,
+									GFraMe_object *obj) {
+	GFraMe_ret rv;
+	int i;
+
+	i = GFraMe_object_pool_get_index(pool, handle);
+	GFraMe_assertRV(i >= 0, "Invalid object handle", rv = GFraMe_ret_bad_param,
+					_ret);
+	pool->x[i] = obj->x;
+	pool->y[i] = obj->y;
+	pool->dx[i] = obj->dx;
+	pool->dy[i] = obj->dy;
+	pool->ldx[i] = obj->ldx;
+	pool->ldy[i] = obj->ldy;
+	pool->vx[i] = obj->vx;
+	pool->vy[i] = obj->vy;
+	pool->ax[i] = obj->ax;
+	pool->ay[i] = obj->ay;
+	pool->hit[i] = (int)obj->hit;
+	pool->layer[i] = obj->layer;
+	pool->mask[i] = obj->mask;
+	pool->hitbox[i] = obj->hitbox;
+	rv = GFraMe_ret_ok;
+_ret:
+	return rv;
+}
+
+/**
+ * Sets an object position
+ * @param	*pool	The pool
+ * @param	handle	The object
+ * @param	X	New horizontal position
+ * @param	Y	New vertical position
+ */
+void GFraMe_object_pool_set_pos(GFraMe_object_pool *pool,
+								GFraMe_object_handle handle, int X, int Y) {
+	int i;
+
+	i = GFraMe_object_pool_get_index(pool, handle);
+	if (i < 0)
+		return;
+	pool->x[i] = X;
+	pool->dx[i] = GFraMe_real_from_int(X);
+	pool->y[i] = Y;
+	pool->dy[i] = GFraMe_real_from_int(Y);
+	// Setting this avoids glitches on collision
+	pool->ldx[i] = GFraMe_real_from_int(X);
+	pool->ldy[i] = GFraMe_real_from_int(Y);
+}
+
+/**
+ * Sets an object velocity
+ * @param	*pool	The pool
+ * @param	handle	The object
+ * @param	vx	New horizontal velocity
+ * @param	vy	New vertical velocity
+ */
+void GFraMe_object_pool_set_velocity(GFraMe_object_pool *pool,
+									 GFraMe_object_handle handle,
+									 GFraMe_real vx, GFraMe_real vy) {
+	int i;
+
+	i = GFraMe_object_pool_get_index(pool, handle);
+	if (i < 0)
+		return;
+	pool->vx[i] = vx;
+	pool->vy[i] = vy;
+}
+
+/**
+ * Sets an object acceleration
+ * @param	*pool	The pool
+ * @param	handle	The object
+ * @param	ax	New horizontal acceleration
+ * @param	ay	New vertical acceleration
+ */
+void GFraMe_object_pool_set_acceleration(GFraMe_object_pool *pool,
+										 GFraMe_object_handle handle,
+										 GFraMe_real ax, GFraMe_real ay) {
+	int i;
+
+	i = GFraMe_object_pool_get_index(pool, handle);
+	if (i < 0)
+		return;
+	pool->ax[i] = ax;
+	pool->ay[i] = ay;
+}
+
+/**
+ * Integrate a single axis of the first num objects; adding a zero
+ *acceleration/velocity leaves the value as is, so there's no need to branch
+ */
+static void GFraMe_object_pool_integrate(GFraMe_real *p, GFraMe_real *lp,
+										 GFraMe_real *v, GFraMe_real *a,
+										 int *ip, int num, GFraMe_real time) {
+	int i = 0;
+#if defined(GFRAME_POOL_AVX)
+	__m256d t = _mm256_set1_pd(time);
+	// Arrays are aligned and padded to 4 elements, so overshooting is safe
+	while (i < num) {
+		__m256d vp, vv, va;
+
+		vp = _mm256_load_pd(p + i);
+		vv = _mm256_load_pd(v + i);
+		va = _mm256_load_pd(a + i);
+		_mm256_store_pd(lp + i, vp);
+		vv = _mm256_add_pd(vv, _mm256_mul_pd(va, t));
+		vp = _mm256_add_pd(vp, _mm256_mul_pd(vv, t));
+		_mm256_store_pd(v + i, vv);
+		_mm256_store_pd(p + i, vp);
+		_mm_store_si128((__m128i*)(ip + i), _mm256_cvttpd_epi32(vp));
+		i += 4;
+	}
+#elif defined(GFRAME_POOL_SSE2)
+	__m128d t = _mm_set1_pd(time);
+	while (i < num) {
+		__m128d vp, vv, va;
+
+		vp = _mm_load_pd(p + i);
+		vv = _mm_load_pd(v + i);
+		va = _mm_load_pd(a + i);
+		_mm_store_pd(lp + i, vp);
+		vv = _mm_add_pd(vv, _mm_mul_pd(va, t));
+		vp = _mm_add_pd(vp, _mm_mul_pd(vv, t));
+		_mm_store_pd(v + i, vv);
+		_mm_store_pd(p + i, vp);
+		_mm_storel_epi64((__m128i*)(ip + i), _mm_cvttpd_epi32(vp));
+		i += 2;
+	}
+#else
+	while (i < num) {
+		lp[i] = p[i];
+		v[i] += GFraMe_util_integrate_real(a[i], time);
+		p[i] += GFraMe_util_integrate_real(v[i], time);
+		ip[i] = GFraMe_real_to_int(p[i]);
+		i++;
+	}
+#endif
+}
+
+/**
+ * Updates every object's position, velocity and collision state, just like
+ *GFraMe_object_update
+ * @param	*pool	The pool
+ * @param	ms	How long this frame took
+ */
+void GFraMe_object_pool_update(GFraMe_object_pool *pool, int ms) {
+	GFraMe_real time;
+	int i;
+
+	// Get the time in a nicer way to the integration
+	time = GFraMe_util_divr(GFraMe_real_from_int(ms),
+							GFraMe_real_from_int(1000));
+	// Integrate both axis
+	GFraMe_object_pool_integrate(pool->dx, pool->ldx, pool->vx, pool->ax,
+								 pool->x, pool->num, time);
+	GFraMe_object_pool_integrate(pool->dy, pool->ldy, pool->vy, pool->ay,
+								 pool->y, pool->num, time);
+	// Update the direction hit/that was hit
+	i = 0;
+	while (i < pool->num) {
+		pool->hit[i] = (pool->hit[i] << GFM_LAST_BITS) & GFraMe_direction_last;
+		i++;
+	}
+}
+
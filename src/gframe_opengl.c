@@ -70,6 +70,14 @@ void GFraMe_opengl_setAlpha(float alpha) {
 	glw_setAlpha(alpha);
 }
 
+/**
+ * Set how sprites are blended
+ * @param	mode	A GFraMe_blend (from GFraMe_renderqueue.h)
+ */
+void GFraMe_opengl_setBlend(int mode) {
+	glw_setBlend(mode);
+}
+
 void GFraMe_opengl_renderSprite(int x, int y, int dx, int dy, int tx, int ty) {
 	glw_renderSprite(x, y, dx, dy, tx, ty);
 }
@@ -78,3 +86,33 @@ void GFraMe_opengl_doRender() {
 	glw_doRender(GFraMe_screen_get_window());
 }
 
+/**
+ * Get the renderer's counters (since the last reset)
+ * @param	*issued	Returns how many state changes reached the driver
+ * @param	*elided	Returns how many state changes were skipped, as they
+ *		  wouldn't change anything
+ * @param	*draws	Returns how many draw calls were made
+ */
+void GFraMe_opengl_getStats(int *issued, int *elided, int *draws) {
+	glw_getStats(issued, elided, draws);
+}
+
+/**
+ * Zero the renderer's counters
+ */
+void GFraMe_opengl_resetStats() {
+	glw_resetStats();
+}
+
+/**
+ * Forget every GL state the renderer expects to be set (the bound program,
+ *textures, buffers, blend mode, viewport...), so it's all set again. Call it
+ *whenever anything other than GFraMe makes GL calls (e.g., another library
+ *drawing its own interface), after those calls and before the next
+ *GFraMe_opengl_prepareRender; since sprites are only drawn on
+ *GFraMe_opengl_doRender, no GL call should be made in between
+ */
+void GFraMe_opengl_invalidateState() {
+	glw_invalidateState();
+}
+
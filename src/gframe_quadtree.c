@@ -0,0 +1,630 @@
+/**
+ * @src/gframe_quadtree.c
+ */
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_object.h>
+#include <GFraMe/GFraMe_quadtree.h>
+#include <GFraMe/GFraMe_tilemap.h>
+#include <stdlib.h>
+
+/**
+ * Get an object's hitbox
+ */
+static void GFraMe_quadtree_get_box(GFraMe_object *obj,
+									GFraMe_quadtree_box *box) {
+	GFraMe_hitbox *hb = &obj->hitbox;
+	box->x0 = GFraMe_real_to_double(obj->dx + hb->cx - hb->hw);
+	box->y0 = GFraMe_real_to_double(obj->dy + hb->cy - hb->hh);
+	box->x1 = GFraMe_real_to_double(obj->dx + hb->cx + hb->hw);
+	box->y1 = GFraMe_real_to_double(obj->dy + hb->cy + hb->hh);
+}
+
+/**
+ * Get a new node, expanding the array as necessary; since the array may be
+ *moved, nodes must be accessed by index
+ */
+static int GFraMe_quadtree_new_node(GFraMe_quadtree *qt) {
+	if (qt->num_nodes >= qt->max_nodes) {
+		GFraMe_quadtree_node *tmp;
+		int len;
+
+		len = qt->max_nodes * 2;
+		tmp = (GFraMe_quadtree_node*)realloc(qt->nodes,
+										sizeof(GFraMe_quadtree_node) * len);
+		if (!tmp)
+			return -1;
+		qt->nodes = tmp;
+		qt->max_nodes = len;
+	}
+	qt->num_nodes++;
+	return qt->num_nodes - 1;
+}
+
+/**
+ * Get in which child a box fits (0: upper left, 1: upper right, 2: lower left,
+ *3: lower right) or 4, if it crosses the node's center
+ */
+static int GFraMe_quadtree_get_quad(GFraMe_quadtree_box *box, double cx,
+									double cy) {
+	int q;
+
+	if (box->x1 <= cx)
+		q = 0;
+	else if (box->x0 >= cx)
+		q = 1;
+	else
+		return 4;
+	if (box->y1 <= cy)
+		return q;
+	else if (box->y0 >= cy)
+		return q + 2;
+	return 4;
+}
+
+/**
+ * Split a node (already with its bounds and objects set) until every node has
+ *at most max_per_node objects (or is as deep as allowed)
+ */
+static GFraMe_ret GFraMe_quadtree_split(GFraMe_quadtree *qt, int node,
+										int depth, GFraMe_object **tmp_objs,
+										GFraMe_quadtree_box *tmp_boxes) {
+	GFraMe_ret rv;
+	GFraMe_quadtree_box bounds;
+	double cx, cy;
+	int count[5], pos[5];
+	int first, num, i, q, child;
+
+	bounds = qt->nodes[node].bounds;
+	first = qt->nodes[node].first;
+	num = qt->nodes[node].count;
+	rv = GFraMe_ret_ok;
+	if (num <= qt->max_per_node || depth >= qt->max_depth)
+		goto _ret;
+
+	cx = (bounds.x0 + bounds.x1) * 0.5;
+	cy = (bounds.y0 + bounds.y1) * 0.5;
+
+	// Count how many objects go to each child (and how many stay)
+	i = 0;
+	while (i < 5) {
+		count[i] = 0;
+		i++;
+	}
+	i = 0;
+	while (i < num) {
+		count[GFraMe_quadtree_get_quad(qt->boxes + first + i, cx, cy)]++;
+		i++;
+	}
+	// Nothing would be moved to the children
+	if (count[4] == num)
+		goto _ret;
+
+	// Sort the objects so the ones that stay come first, then each child's
+	pos[4] = 0;
+	pos[0] = count[4];
+	i = 1;
+	while (i < 4) {
+		pos[i] = pos[i - 1] + count[i - 1];
+		i++;
+	}
+	i = 0;
+	while (i < num) {
+		q = GFraMe_quadtree_get_quad(qt->boxes + first + i, cx, cy);
+		tmp_objs[pos[q]] = qt->objs[first + i];
+		tmp_boxes[pos[q]] = qt->boxes[first + i];
+		pos[q]++;
+		i++;
+	}
+	i = 0;
+	while (i < num) {
+		qt->objs[first + i] = tmp_objs[i];
+		qt->boxes[first + i] = tmp_boxes[i];
+		i++;
+	}
+
+	// Create the children (which are always contiguous)
+	child = GFraMe_quadtree_new_node(qt);
+	GFraMe_assertRV(child >= 0, "Failed to alloc node",
+					rv = GFraMe_ret_memory_error, _ret);
+	i = 1;
+	while (i < 4) {
+		GFraMe_assertRV(GFraMe_quadtree_new_node(qt) >= 0,
+						"Failed to alloc node", rv = GFraMe_ret_memory_error,
+						_ret);
+		i++;
+	}
+	qt->nodes[node].child = child;
+	qt->nodes[node].count = count[4];
+
+	first += count[4];
+	i = 0;
+	while (i < 4) {
+		GFraMe_quadtree_node *n = qt->nodes + child + i;
+
+		n->bounds.x0 = (i & 1) ? cx : bounds.x0;
+		n->bounds.x1 = (i & 1) ? bounds.x1 : cx;
+		n->bounds.y0 = (i & 2) ? cy : bounds.y0;
+		n->bounds.y1 = (i & 2) ? bounds.y1 : cy;
+		n->child = -1;
+		n->first = first;
+		n->count = count[i];
+		first += count[i];
+		i++;
+	}
+	// Recurse only after every child was set
+	i = 0;
+	while (i < 4) {
+		rv = GFraMe_quadtree_split(qt, child + i, depth + 1, tmp_objs,
+								   tmp_boxes);
+		GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to split node", _ret);
+		i++;
+	}
+
+	rv = GFraMe_ret_ok;
+_ret:
+	return rv;
+}
+
+/**
+ * Build the quadtree from the objects already on it
+ */
+static GFraMe_ret GFraMe_quadtree_build(GFraMe_quadtree *qt) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	GFraMe_quadtree_node *root;
+	GFraMe_object **tmp_objs = NULL;
+	GFraMe_quadtree_box *tmp_boxes = NULL;
+	int i;
+
+	qt->max_nodes = 16;
+	qt->nodes = (GFraMe_quadtree_node*)malloc(sizeof(GFraMe_quadtree_node)
+											  * qt->max_nodes);
+	GFraMe_assertRV(qt->nodes, "Failed to alloc nodes",
+					rv = GFraMe_ret_memory_error, _ret);
+	qt->num_nodes = 1;
+
+	// The root covers every object
+	root = qt->nodes;
+	root->child = -1;
+	root->first = 0;
+	root->count = qt->num_objs;
+	root->bounds.x0 = 0.0;
+	root->bounds.y0 = 0.0;
+	root->bounds.x1 = 0.0;
+	root->bounds.y1 = 0.0;
+	i = 0;
+	while (i < qt->num_objs) {
+		GFraMe_quadtree_get_box(qt->objs[i], qt->boxes + i);
+		if (i == 0 || qt->boxes[i].x0 < root->bounds.x0)
+			root->bounds.x0 = qt->boxes[i].x0;
+		if (i == 0 || qt->boxes[i].y0 < root->bounds.y0)
+			root->bounds.y0 = qt->boxes[i].y0;
+		if (i == 0 || qt->boxes[i].x1 > root->bounds.x1)
+			root->bounds.x1 = qt->boxes[i].x1;
+		if (i == 0 || qt->boxes[i].y1 > root->bounds.y1)
+			root->bounds.y1 = qt->boxes[i].y1;
+		i++;
+	}
+	if (qt->num_objs == 0)
+		goto _ret;
+
+	tmp_objs = (GFraMe_object**)malloc(sizeof(GFraMe_object*) * qt->num_objs);
+	GFraMe_assertRV(tmp_objs, "Failed to alloc buffer",
+					rv = GFraMe_ret_memory_error, _ret);
+	tmp_boxes = (GFraMe_quadtree_box*)malloc(sizeof(GFraMe_quadtree_box)
+											 * qt->num_objs);
+	GFraMe_assertRV(tmp_boxes, "Failed to alloc buffer",
+					rv = GFraMe_ret_memory_error, _ret);
+
+	rv = GFraMe_quadtree_split(qt, 0, 0, tmp_objs, tmp_boxes);
+_ret:
+	if (tmp_objs)
+		free(tmp_objs);
+	if (tmp_boxes)
+		free(tmp_boxes);
+	return rv;
+}
+
+/**
+ * Alloc the arrays for the objects
+ */
+static GFraMe_ret GFraMe_quadtree_alloc(GFraMe_quadtree *qt, int num,
+										int max_per_node, int max_depth) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+
+	// Init every alloc'ed pointer with NULL
+	qt->nodes = NULL;
+	qt->objs = NULL;
+	qt->boxes = NULL;
+	qt->num_nodes = 0;
+	qt->max_nodes = 0;
+	qt->num_objs = 0;
+
+	GFraMe_assertRV(num >= 0 && max_per_node > 0 && max_depth >= 0,
+					"Invalid quadtree parameters", rv = GFraMe_ret_bad_param,
+					_ret);
+	qt->max_per_node = max_per_node;
+	qt->max_depth = max_depth;
+
+	// Alloc at least one, so it's never a NULL return from malloc(0)
+	qt->objs = (GFraMe_object**)malloc(sizeof(GFraMe_object*) * (num + 1));
+	GFraMe_assertRV(qt->objs, "Failed to alloc objects",
+					rv = GFraMe_ret_memory_error, _ret);
+	qt->boxes = (GFraMe_quadtree_box*)malloc(sizeof(GFraMe_quadtree_box)
+											 * (num + 1));
+	GFraMe_assertRV(qt->boxes, "Failed to alloc boxes",
+					rv = GFraMe_ret_memory_error, _ret);
+	qt->num_objs = num;
+_ret:
+	return rv;
+}
+
+/**
+ * Build a quadtree from some objects; they mustn't move nor be released
+ *until the quadtree is cleared
+ * @param	*qt	Quadtree to be initialized
+ * @param	**objs	The objects
+ * @param	num	How many objects there are
+ * @param	max_per_node	Nodes with more objects than this are split
+ * @param	max_depth	How deep the quadtree may get
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_quadtree_init(GFraMe_quadtree *qt, GFraMe_object **objs,
+								int num, int max_per_node, int max_depth) {
+	GFraMe_ret rv;
+	int i;
+
+	rv = GFraMe_quadtree_alloc(qt, num, max_per_node, max_depth);
+	GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to alloc quadtree", _ret);
+
+	i = 0;
+	while (i < num) {
+		qt->objs[i] = objs[i];
+		i++;
+	}
+
+	rv = GFraMe_quadtree_build(qt);
+	GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to build quadtree", _ret);
+_ret:
+	if (rv != GFraMe_ret_ok)
+		GFraMe_quadtree_clear(qt);
+	return rv;
+}
+
+/**
+ * Build a quadtree from a tilemap's boxes; it must be built again whenever
+ *a tile is changed
+ * @param	*qt	Quadtree to be initialized
+ * @param	*tmap	The tilemap
+ * @param	max_per_node	Nodes with more objects than this are split
+ * @param	max_depth	How deep the quadtree may get
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_quadtree_init_tilemap(GFraMe_quadtree *qt,
+										GFraMe_tilemap *tmap,
+										int max_per_node, int max_depth) {
+	GFraMe_ret rv;
+	int i;
+
+	rv = GFraMe_quadtree_alloc(qt, tmap->num_boxes, max_per_node, max_depth);
+	GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to alloc quadtree", _ret);
+
+	i = 0;
+	while (i < tmap->num_boxes) {
+		qt->objs[i] = tmap->boxes + i;
+		i++;
+	}
+
+	rv = GFraMe_quadtree_build(qt);
+	GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to build quadtree", _ret);
+_ret:
+	if (rv != GFraMe_ret_ok)
+		GFraMe_quadtree_clear(qt);
+	return rv;
+}
+
+/**
+ * Release every memory used by the quadtree
+ * @param	*qt	The quadtree
+ */
+void GFraMe_quadtree_clear(GFraMe_quadtree *qt) {
+	if (qt->nodes)
+		free(qt->nodes);
+	qt->nodes = NULL;
+	if (qt->objs)
+		free(qt->objs);
+	qt->objs = NULL;
+	if (qt->boxes)
+		free(qt->boxes);
+	qt->boxes = NULL;
+	qt->num_nodes = 0;
+	qt->max_nodes = 0;
+	qt->num_objs = 0;
+}
+
+/**
+ * Recursively retrieve every object that overlaps a box; if 'other' isn't NULL,
+ *it's overlapped against each object found, instead
+ */
+static int GFraMe_quadtree_collect(GFraMe_quadtree *qt, int node,
+								   GFraMe_quadtree_box *box,
+								   GFraMe_object **out, int max, int count,
+								   GFraMe_object *other,
+								   GFraMe_collision_type mode) {
+	GFraMe_quadtree_node *n;
+	int i, end;
+
+	n = qt->nodes + node;
+	// Objects are always inside their node, so touching it isn't enough
+	if (n->bounds.x0 >= box->x1 || n->bounds.x1 <= box->x0 ||
+		n->bounds.y0 >= box->y1 || n->bounds.y1 <= box->y0)
+		return count;
+
+	i = n->first;
+	end = i + n->count;
+	while (i < end) {
+		GFraMe_quadtree_box *b = qt->boxes + i;
+
+		if (b->x0 < box->x1 && box->x0 < b->x1 && b->y0 < box->y1 &&
+			box->y0 < b->y1) {
+			if (other) {
+				if (qt->objs[i] != other &&
+					GFraMe_object_layers_match(other, qt->objs[i]) &&
+					GFraMe_object_overlap(other, qt->objs[i], mode) ==
+						GFraMe_ret_ok)
+					count++;
+			}
+			else {
+				if (count < max)
+					out[count] = qt->objs[i];
+				count++;
+			}
+		}
+		i++;
+	}
+
+	if (n->child != -1) {
+		int child = n->child;
+
+		i = 0;
+		while (i < 4) {
+			count = GFraMe_quadtree_collect(qt, child + i, box, out, max,
+											count, other, mode);
+			i++;
+		}
+	}
+
+	return count;
+}
+
+/**
+ * Retrieve every object that overlaps a rectangle
+ * @param	*qt	The quadtree
+ * @param	x	Rectangle's left position
+ * @param	y	Rectangle's top position
+ * @param	w	Rectangle's width
+ * @param	h	Rectangle's height
+ * @param	**out	Array where the objects are returned
+ * @param	max	How many objects fit on the array
+ * @return	How many objects were found (may be greater than max)
+ */
+int GFraMe_quadtree_query_rect(GFraMe_quadtree *qt, double x, double y,
+							   double w, double h, GFraMe_object **out,
+							   int max) {
+	GFraMe_quadtree_box box;
+
+	if (qt->num_objs == 0)
+		return 0;
+
+	box.x0 = x;
+	box.y0 = y;
+	box.x1 = x + w;
+	box.y1 = y + h;
+	return GFraMe_quadtree_collect(qt, 0, &box, out, max, 0, NULL,
+								   GFraMe_dont_collide);
+}
+
+/**
+ * Retrieve every object that contains a point (e.g., the pointer, after
+ *GFraMe_screen_point_to_world)
+ * @param	*qt	The quadtree
+ * @param	x	Point's horizontal position
+ * @param	y	Point's vertical position
+ * @param	**out	Array where the objects are returned
+ * @param	max	How many objects fit on the array
+ * @return	How many objects were found (may be greater than max)
+ */
+int GFraMe_quadtree_query_point(GFraMe_quadtree *qt, double x, double y,
+								GFraMe_object **out, int max) {
+	GFraMe_quadtree_node *n;
+	int node, count, i, end;
+
+	if (qt->num_objs == 0)
+		return 0;
+
+	count = 0;
+	node = 0;
+	// A point is inside at most one child, so simply walk down the tree
+	while (node != -1) {
+		n = qt->nodes + node;
+		if (x < n->bounds.x0 || x > n->bounds.x1 || y < n->bounds.y0 ||
+			y > n->bounds.y1)
+			break;
+
+		i = n->first;
+		end = i + n->count;
+		while (i < end) {
+			GFraMe_quadtree_box *b = qt->boxes + i;
+
+			if (x >= b->x0 && x < b->x1 && y >= b->y0 && y < b->y1) {
+				if (count < max)
+					out[count] = qt->objs[i];
+				count++;
+			}
+			i++;
+		}
+
+		if (n->child == -1)
+			break;
+		node = n->child;
+		if (x >= qt->nodes[node].bounds.x1)
+			node += 1;
+		if (y >= qt->nodes[node].bounds.y1)
+			node += 2;
+	}
+
+	return count;
+}
+
+/**
+ * Calculate when a segment enters a box (using the slab test)
+ * @return	Fraction of the segment where the box is entered; or a negative
+ *		  value, if it isn't
+ */
+static double GFraMe_quadtree_ray_box(GFraMe_quadtree_box *b, double x0,
+									  double y0, double dx, double dy) {
+	double tmin, tmax, t0, t1, tmp;
+
+	tmin = 0.0;
+	tmax = 1.0;
+	if (dx == 0.0) {
+		if (x0 < b->x0 || x0 > b->x1)
+			return -1.0;
+	}
+	else {
+		t0 = (b->x0 - x0) / dx;
+		t1 = (b->x1 - x0) / dx;
+		if (t0 > t1) {
+			tmp = t0;
+			t0 = t1;
+			t1 = tmp;
+		}
+		if (t0 > tmin)
+			tmin = t0;
+		if (t1 < tmax)
+			tmax = t1;
+		if (tmin > tmax)
+			return -1.0;
+	}
+	if (dy == 0.0) {
+		if (y0 < b->y0 || y0 > b->y1)
+			return -1.0;
+	}
+	else {
+		t0 = (b->y0 - y0) / dy;
+		t1 = (b->y1 - y0) / dy;
+		if (t0 > t1) {
+			tmp = t0;
+			t0 = t1;
+			t1 = tmp;
+		}
+		if (t0 > tmin)
+			tmin = t0;
+		if (t1 < tmax)
+			tmax = t1;
+		if (tmin > tmax)
+			return -1.0;
+	}
+
+	return tmin;
+}
+
+/**
+ * Recursively search for the first object hit by a segment; nodes farther
+ *than the current best are skipped
+ */
+static void GFraMe_quadtree_ray_node(GFraMe_quadtree *qt, int node,
+									 double x0, double y0, double dx,
+									 double dy, GFraMe_object **best,
+									 double *best_t) {
+	GFraMe_quadtree_node *n;
+	double t, child_t[4];
+	int order[4];
+	int i, j, end;
+
+	n = qt->nodes + node;
+
+	i = n->first;
+	end = i + n->count;
+	while (i < end) {
+		t = GFraMe_quadtree_ray_box(qt->boxes + i, x0, y0, dx, dy);
+		if (t >= 0.0 && t < *best_t) {
+			*best = qt->objs[i];
+			*best_t = t;
+		}
+		i++;
+	}
+
+	if (n->child == -1)
+		return;
+
+	// Visit the children from the nearest to the farthest
+	i = 0;
+	while (i < 4) {
+		t = GFraMe_quadtree_ray_box(&qt->nodes[n->child + i].bounds, x0, y0,
+									dx, dy);
+		j = i;
+		while (j > 0 && child_t[j - 1] > t) {
+			child_t[j] = child_t[j - 1];
+			order[j] = order[j - 1];
+			j--;
+		}
+		child_t[j] = t;
+		order[j] = n->child + i;
+		i++;
+	}
+	i = 0;
+	while (i < 4) {
+		if (child_t[i] >= *best_t)
+			break;
+		if (child_t[i] >= 0.0)
+			GFraMe_quadtree_ray_node(qt, order[i], x0, y0, dx, dy, best,
+									 best_t);
+		i++;
+	}
+}
+
+/**
+ * Find the first object hit by a segment
+ * @param	*qt	The quadtree
+ * @param	x0	Segment's starting horizontal position
+ * @param	y0	Segment's starting vertical position
+ * @param	x1	Segment's ending horizontal position
+ * @param	y1	Segment's ending vertical position
+ * @param	*time	Returns the fraction of the segment (in [0, 1]) where the
+ *			  object was hit (may be NULL)
+ * @return	The object hit or NULL, if none
+ */
+GFraMe_object* GFraMe_quadtree_raycast(GFraMe_quadtree *qt, double x0,
+									   double y0, double x1, double y1,
+									   double *time) {
+	GFraMe_object *best = NULL;
+	double best_t = 2.0;
+
+	if (qt->num_objs > 0 && GFraMe_quadtree_ray_box(&qt->nodes[0].bounds, x0,
+													y0, x1 - x0, y1 - y0) >= 0.0)
+		GFraMe_quadtree_ray_node(qt, 0, x0, y0, x1 - x0, y1 - y0, &best,
+								 &best_t);
+
+	if (time && best)
+		*time = best_t;
+	return best;
+}
+
+/**
+ * Overlap (through GFraMe_object_overlap) an object against every object on
+ *the quadtree that it may touch and whose layers match its own
+ * @param	*qt	The quadtree
+ * @param	*obj	The object
+ * @param	mode	How collision should be handle ('obj' is the first object)
+ * @return	How many objects overlapped
+ */
+int GFraMe_quadtree_overlap(GFraMe_quadtree *qt, GFraMe_object *obj,
+							GFraMe_collision_type mode) {
+	GFraMe_quadtree_box box;
+
+	if (qt->num_objs == 0)
+		return 0;
+
+	GFraMe_quadtree_get_box(obj, &box);
+	return GFraMe_quadtree_collect(qt, 0, &box, NULL, 0, 0, obj, mode);
+}
@@ -0,0 +1,462 @@
+/**
+ * @src/gframe_renderqueue.c
+ */
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_fixed.h>
+#include <GFraMe/GFraMe_opengl.h>
+#include <GFraMe/GFraMe_renderqueue.h>
+#include <GFraMe/GFraMe_sprite.h>
+#include <GFraMe/GFraMe_spriteset.h>
+#include <GFraMe/GFraMe_texture.h>
+#include <SDL2/SDL.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Layout of the keys; layers are always on the highest bits, painter's order
+ *layers are then sorted by depth and sequence, while sorted layers are sorted
+ *by texture and blend mode first
+ */
+#define GFRAME_RQ_LAYER_SHIFT 56
+#define GFRAME_RQ_SEQ_BITS 24
+#define GFRAME_RQ_SEQ_MASK ((1 << GFRAME_RQ_SEQ_BITS) - 1)
+#define GFRAME_RQ_DEPTH_MASK 0xffff
+#define GFRAME_RQ_TEX_MASK (GFRAME_RENDERQUEUE_TEXTURES - 1)
+#define GFRAME_RQ_BLEND_MASK 0xf
+
+/**
+ * Initialize a queue
+ * @param	*queue	Queue to be initialized
+ * @param	max	How many commands may be pushed on a frame (at most 2^24)
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_renderqueue_init(GFraMe_renderqueue *queue, int max) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+
+	memset(queue, 0x0, sizeof(GFraMe_renderqueue));
+	GFraMe_assertRV(max > 0 && max <= GFRAME_RQ_SEQ_MASK + 1,
+					"Invalid queue size", rv = GFraMe_ret_bad_param, _ret);
+
+	queue->cmds = (GFraMe_rendercmd*)malloc(sizeof(GFraMe_rendercmd) * max);
+	GFraMe_assertRV(queue->cmds, "Failed to alloc commands",
+					rv = GFraMe_ret_memory_error, _ret);
+	queue->keys = (uint64_t*)malloc(sizeof(uint64_t) * max);
+	GFraMe_assertRV(queue->keys, "Failed to alloc keys",
+					rv = GFraMe_ret_memory_error, _ret);
+	queue->tmp_keys = (uint64_t*)malloc(sizeof(uint64_t) * max);
+	GFraMe_assertRV(queue->tmp_keys, "Failed to alloc keys",
+					rv = GFraMe_ret_memory_error, _ret);
+	queue->order = (int*)malloc(sizeof(int) * max);
+	GFraMe_assertRV(queue->order, "Failed to alloc order",
+					rv = GFraMe_ret_memory_error, _ret);
+	queue->tmp_order = (int*)malloc(sizeof(int) * max);
+	GFraMe_assertRV(queue->tmp_order, "Failed to alloc order",
+					rv = GFraMe_ret_memory_error, _ret);
+	queue->textures = (GFraMe_renderqueue_tex*)malloc(
+			sizeof(GFraMe_renderqueue_tex) * GFRAME_RENDERQUEUE_TEXTURES);
+	GFraMe_assertRV(queue->textures, "Failed to alloc textures",
+					rv = GFraMe_ret_memory_error, _ret);
+	queue->max = max;
+
+	GFraMe_renderqueue_reset(queue);
+_ret:
+	if (rv != GFraMe_ret_ok)
+		GFraMe_renderqueue_clear(queue);
+	return rv;
+}
+
+/**
+ * Release every memory used by the queue
+ * @param	*queue	The queue
+ */
+void GFraMe_renderqueue_clear(GFraMe_renderqueue *queue) {
+	if (queue->cmds)
+		free(queue->cmds);
+	if (queue->keys)
+		free(queue->keys);
+	if (queue->tmp_keys)
+		free(queue->tmp_keys);
+	if (queue->order)
+		free(queue->order);
+	if (queue->tmp_order)
+		free(queue->tmp_order);
+	if (queue->textures)
+		free(queue->textures);
+	memset(queue, 0x0, sizeof(GFraMe_renderqueue));
+}
+
+/**
+ * Drop every command without drawing them
+ * @param	*queue	The queue
+ */
+void GFraMe_renderqueue_reset(GFraMe_renderqueue *queue) {
+	queue->num = 0;
+	queue->num_textures = 0;
+	queue->last_texture = -1;
+}
+
+/**
+ * Set whether a layer is sorted by state or drawn on painter's order; only
+ *affects commands pushed afterward
+ * @param	*queue	The queue
+ * @param	layer	The layer
+ * @param	sorted	1 - Group commands by state; 0 - Keep painter's order
+ */
+void GFraMe_renderqueue_set_layer_sorted(GFraMe_renderqueue *queue,
+										 int layer, int sorted) {
+	if (layer >= 0 && layer < GFRAME_RENDERQUEUE_LAYERS)
+		queue->sorted[layer] = (sorted != 0);
+}
+
+/**
+ * Get the index of a texture on this frame's table, adding it if needed
+ * @return	The index or -1, if the table is full
+ */
+static int GFraMe_renderqueue_find_texture(GFraMe_renderqueue *queue,
+										   GFraMe_texture *tex) {
+	int i;
+
+	// Commands are usually pushed in runs of the same texture
+	if (queue->last_texture >= 0
+		&& queue->textures[queue->last_texture].tex == tex)
+		return queue->last_texture;
+	i = 0;
+	while (i < queue->num_textures) {
+		if (queue->textures[i].tex == tex)
+			break;
+		i++;
+	}
+	if (i == queue->num_textures) {
+		if (i >= GFRAME_RENDERQUEUE_TEXTURES)
+			return -1;
+		// Textures are expected to be on their default state
+		queue->textures[i].tex = tex;
+		queue->textures[i].blend = GFraMe_blend_alpha;
+		queue->textures[i].alpha = 1.0f;
+		queue->num_textures++;
+	}
+	queue->last_texture = i;
+	return i;
+}
+
+/**
+ * Push a command
+ * @param	*queue	The queue
+ * @param	layer	Layer, in [0, GFRAME_RENDERQUEUE_LAYERS)
+ * @param	depth	Depth within the layer (clamped to the valid range)
+ * @param	*cmd	The command (copied into the queue)
+ * @return	GFraMe_ret_ok - Success; GFraMe_buffer_too_small - Queue is full
+ *		  (or too many textures); GFraMe_ret_bad_param - Invalid layer
+ */
+GFraMe_ret GFraMe_renderqueue_push(GFraMe_renderqueue *queue, int layer,
+								   int depth, GFraMe_rendercmd *cmd) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	uint64_t key, tex, blend, dep, seq;
+	int i;
+
+	GFraMe_assertRV(layer >= 0 && layer < GFRAME_RENDERQUEUE_LAYERS,
+					"Invalid layer", rv = GFraMe_ret_bad_param, _ret);
+	GFraMe_assertRV(cmd->sset && cmd->tile >= 0 && cmd->tile < cmd->sset->max,
+					"Invalid tile!", rv = GFraMe_ret_bad_param, _ret);
+	GFraMe_assertRV(queue->num < queue->max, "Render queue is full",
+					rv = GFraMe_buffer_too_small, _ret);
+	i = GFraMe_renderqueue_find_texture(queue, cmd->sset->tex);
+	GFraMe_assertRV(i >= 0, "Too many textures on a single frame",
+					rv = GFraMe_buffer_too_small, _ret);
+
+	if (depth < GFRAME_RENDERQUEUE_DEPTH_MIN)
+		depth = GFRAME_RENDERQUEUE_DEPTH_MIN;
+	else if (depth > GFRAME_RENDERQUEUE_DEPTH_MAX)
+		depth = GFRAME_RENDERQUEUE_DEPTH_MAX;
+	queue->cmds[queue->num] = *cmd;
+	cmd = queue->cmds + queue->num;
+	if (cmd->blend < 0 || cmd->blend >= GFraMe_blend_max)
+		cmd->blend = GFraMe_blend_alpha;
+
+	tex = (uint64_t)(i & GFRAME_RQ_TEX_MASK);
+	blend = (uint64_t)(cmd->blend & GFRAME_RQ_BLEND_MASK);
+	dep = (uint64_t)((depth - GFRAME_RENDERQUEUE_DEPTH_MIN)
+					 & GFRAME_RQ_DEPTH_MASK);
+	seq = (uint64_t)queue->num;
+	key = (uint64_t)layer << GFRAME_RQ_LAYER_SHIFT;
+	if (queue->sorted[layer])
+		// layer | texture | blend | depth | sequence
+		key |= (tex << 44) | (blend << 40) | (dep << 24) | seq;
+	else
+		// layer | depth | sequence | texture | blend
+		key |= (dep << 40) | (seq << 16) | (tex << 4) | blend;
+
+	queue->keys[queue->num] = key;
+	queue->order[queue->num] = queue->num;
+	queue->num++;
+_ret:
+	return rv;
+}
+
+/**
+ * Set a command to draw a sprite at its current position, as
+ *GFraMe_sprite_draw would draw it
+ * NOTE unlike GFraMe_sprite_draw, the sprite's scale and alpha are also
+ *applied when not using OpenGL (its angle still isn't)
+ * @param	*cmd	The command
+ * @param	*spr	The sprite
+ * @param	blend	How the sprite is blended
+ */
+void GFraMe_rendercmd_set_sprite(GFraMe_rendercmd *cmd, GFraMe_sprite *spr,
+								 GFraMe_blend blend) {
+	cmd->sset = spr->sset;
+	cmd->tile = spr->cur_tile;
+	cmd->x = spr->obj.x;
+	if (!spr->flipped)
+		cmd->x += spr->offset_x;
+	else
+		cmd->x -= (spr->sset->tw - GFraMe_real_to_int(spr->obj.hitbox.hw) * 2)
+				  + spr->offset_x;
+	cmd->y = spr->obj.y + spr->offset_y;
+	cmd->flipped = spr->flipped;
+	cmd->scale_x = spr->scale_x;
+	cmd->scale_y = spr->scale_y;
+	cmd->angle = spr->angle;
+	cmd->alpha = spr->alpha;
+	cmd->blend = blend;
+}
+
+/**
+ * Push a sprite at its current position, as GFraMe_sprite_draw would draw it
+ * NOTE unlike GFraMe_sprite_draw, the sprite's scale and alpha are also
+ *applied when not using OpenGL (its angle still isn't)
+ * @param	*queue	The queue
+ * @param	layer	Layer, in [0, GFRAME_RENDERQUEUE_LAYERS)
+ * @param	depth	Depth within the layer (clamped to the valid range)
+ * @param	*spr	The sprite
+ * @param	blend	How the sprite is blended
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_renderqueue_push_sprite(GFraMe_renderqueue *queue,
+										  int layer, int depth,
+										  GFraMe_sprite *spr,
+										  GFraMe_blend blend) {
+	GFraMe_rendercmd cmd;
+
+	GFraMe_rendercmd_set_sprite(&cmd, spr, blend);
+	return GFraMe_renderqueue_push(queue, layer, depth, &cmd);
+}
+
+/**
+ * Sort the keys (and the commands' order along) with a LSD radix sort; since
+ *every key has a unique sequence, the result is the same as a stable sort
+ */
+static void GFraMe_renderqueue_sort(GFraMe_renderqueue *queue) {
+	int count[8][256];
+	uint64_t *keys, *tmp_keys;
+	int *order, *tmp_order;
+	int i, pass, num;
+
+	num = queue->num;
+	if (num < 2)
+		return;
+	// Build the histogram of every digit at once
+	memset(count, 0x0, sizeof(count));
+	i = 0;
+	while (i < num) {
+		uint64_t key = queue->keys[i];
+		pass = 0;
+		while (pass < 8) {
+			count[pass][(key >> (pass * 8)) & 0xff]++;
+			pass++;
+		}
+		i++;
+	}
+
+	keys = queue->keys;
+	order = queue->order;
+	tmp_keys = queue->tmp_keys;
+	tmp_order = queue->tmp_order;
+	pass = 0;
+	while (pass < 8) {
+		int *cur = count[pass];
+		int shift = pass * 8;
+		int sum, digit;
+
+		// Skip the digit if every key has the same value on it
+		if (cur[(keys[0] >> shift) & 0xff] == num) {
+			pass++;
+			continue;
+		}
+		// Turn the histogram into the first position of each digit
+		sum = 0;
+		digit = 0;
+		while (digit < 256) {
+			int tmp = cur[digit];
+			cur[digit] = sum;
+			sum += tmp;
+			digit++;
+		}
+		i = 0;
+		while (i < num) {
+			int pos = cur[(keys[i] >> shift) & 0xff]++;
+			tmp_keys[pos] = keys[i];
+			tmp_order[pos] = order[i];
+			i++;
+		}
+		// Swap the buffers
+		{
+			uint64_t *swp_keys = keys;
+			int *swp_order = order;
+			keys = tmp_keys;
+			order = tmp_order;
+			tmp_keys = swp_keys;
+			tmp_order = swp_order;
+		}
+		pass++;
+	}
+	// Keep the sorted data on the main buffers
+	queue->keys = keys;
+	queue->order = order;
+	queue->tmp_keys = tmp_keys;
+	queue->tmp_order = tmp_order;
+}
+
+#if !defined(GFRAME_OPENGL)
+/**
+ * Get SDL's equivalent to a blend mode
+ */
+static SDL_BlendMode GFraMe_renderqueue_get_sdl_blend(GFraMe_blend blend) {
+	switch (blend) {
+		case GFraMe_blend_add: return SDL_BLENDMODE_ADD;
+		case GFraMe_blend_mod: return SDL_BLENDMODE_MOD;
+		case GFraMe_blend_none: return SDL_BLENDMODE_NONE;
+		default: return SDL_BLENDMODE_BLEND;
+	}
+}
+#endif
+
+/**
+ * Sort every command, draw them and empty the queue
+ * @param	*queue	The queue
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_renderqueue_flush(GFraMe_renderqueue *queue) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+#if defined(GFRAME_OPENGL)
+	float sx, sy, angle, alpha;
+	GFraMe_blend blend;
+#else
+	GFraMe_renderqueue_tex *state;
+	GFraMe_texture *cur;
+	int dx, dy, dw, dh;
+#endif
+	int i;
+
+	GFraMe_renderqueue_sort(queue);
+
+#if defined(GFRAME_OPENGL)
+	// Every texture is on the same atlas, so only the uniforms and the blend
+	// mode must be kept; start from the default state
+	sx = 1.0f;
+	sy = 1.0f;
+	angle = 0.0f;
+	alpha = 1.0f;
+	blend = GFraMe_blend_alpha;
+#else
+	state = NULL;
+	cur = NULL;
+#endif
+	i = 0;
+	while (i < queue->num) {
+		GFraMe_rendercmd *cmd = queue->cmds + queue->order[i];
+		GFraMe_spriteset *sset = cmd->sset;
+		int tx, ty;
+
+		// Calculate the tile position
+		tx = (cmd->tile % sset->columns) * sset->tw;
+		ty = (cmd->tile / sset->columns) * sset->th;
+#if defined(GFRAME_OPENGL)
+		{
+			float cmd_sx = cmd->flipped ? -cmd->scale_x : cmd->scale_x;
+
+			if (cmd->blend != blend) {
+				GFraMe_opengl_setBlend(cmd->blend);
+				blend = cmd->blend;
+			}
+			if (cmd->angle != angle) {
+				GFraMe_opengl_setRotation(cmd->angle);
+				angle = cmd->angle;
+			}
+			if (cmd_sx != sx || cmd->scale_y != sy) {
+				GFraMe_opengl_setScale(cmd_sx, cmd->scale_y);
+				sx = cmd_sx;
+				sy = cmd->scale_y;
+			}
+			if (cmd->alpha != alpha) {
+				GFraMe_opengl_setAlpha(cmd->alpha);
+				alpha = cmd->alpha;
+			}
+		}
+		GFraMe_opengl_renderSprite(cmd->x, cmd->y, sset->tw, sset->th, tx, ty);
+#else
+		if (sset->tex != cur) {
+			cur = sset->tex;
+			state = queue->textures + GFraMe_renderqueue_find_texture(queue,
+																	  cur);
+		}
+		// SDL keeps the blend mode and alpha per texture, so those are only
+		// set when they differ from the last ones set on this texture
+		if (cmd->blend != state->blend) {
+			SDL_SetTextureBlendMode(cur->texture,
+								GFraMe_renderqueue_get_sdl_blend(cmd->blend));
+			state->blend = cmd->blend;
+		}
+		if (cmd->alpha != state->alpha) {
+			SDL_SetTextureAlphaMod(cur->texture, (Uint8)(cmd->alpha * 255.0f));
+			state->alpha = cmd->alpha;
+		}
+		// Scale around the tile's center, as the GL backend does
+		dw = (int)((float)sset->tw * cmd->scale_x);
+		dh = (int)((float)sset->th * cmd->scale_y);
+		if (dw < 0)
+			dw = -dw;
+		if (dh < 0)
+			dh = -dh;
+		dx = cmd->x + (sset->tw - dw) / 2;
+		dy = cmd->y + (sset->th - dh) / 2;
+		if (!cmd->flipped)
+			rv = GFraMe_texture_l_copy(tx, ty, sset->tw, sset->th, dx, dy, dw,
+									   dh, cur);
+		else
+			rv = GFraMe_texture_l_copy_flipped(tx, ty, sset->tw, sset->th, dx,
+											   dy, dw, dh, cur);
+		GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to render tile!", _ret);
+#endif
+		i++;
+	}
+
+#if !defined(GFRAME_OPENGL)
+_ret:
+#endif
+	// Return to the default state, so direct draws aren't affected
+#if defined(GFRAME_OPENGL)
+	if (blend != GFraMe_blend_alpha)
+		GFraMe_opengl_setBlend(GFraMe_blend_alpha);
+	if (angle != 0.0f)
+		GFraMe_opengl_setRotation(0.0f);
+	if (sx != 1.0f || sy != 1.0f)
+		GFraMe_opengl_setScale(1.0f, 1.0f);
+	if (alpha != 1.0f)
+		GFraMe_opengl_setAlpha(1.0f);
+#else
+	i = 0;
+	while (i < queue->num_textures) {
+		state = queue->textures + i;
+		if (state->blend != GFraMe_blend_alpha)
+			SDL_SetTextureBlendMode(state->tex->texture, SDL_BLENDMODE_BLEND);
+		if (state->alpha != 1.0f)
+			SDL_SetTextureAlphaMod(state->tex->texture, 0xff);
+		i++;
+	}
+#endif
+	GFraMe_renderqueue_reset(queue);
+	return rv;
+}
+
@@ -0,0 +1,510 @@
+/**
+ * @src/gframe_spatialhash.c
+ */
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_object.h>
+#include <GFraMe/GFraMe_spatialhash.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Convert a position into a cell position (rounding towards -inf)
+ */
+static int GFraMe_spatialhash_cell(double pos, int size) {
+	int cell = (int)(pos / size);
+	if (pos < (double)cell * size)
+		cell--;
+	return cell;
+}
+
+/**
+ * Get the bucket where a cell is stored
+ */
+static int GFraMe_spatialhash_bucket(GFraMe_spatialhash *sh, int cx, int cy) {
+	unsigned int h;
+	h = ((unsigned int)cx * 73856093u) ^ ((unsigned int)cy * 19349663u);
+	return (int)(h & (unsigned int)(sh->num_buckets - 1));
+}
+
+/**
+ * Get the cells touched by a rectangle
+ */
+static void GFraMe_spatialhash_get_range(GFraMe_spatialhash *sh, double x,
+										 double y, double w, double h,
+										 GFraMe_spatialhash_range *r) {
+	r->x0 = GFraMe_spatialhash_cell(x, sh->cell_w);
+	r->y0 = GFraMe_spatialhash_cell(y, sh->cell_h);
+	r->x1 = GFraMe_spatialhash_cell(x + w, sh->cell_w);
+	r->y1 = GFraMe_spatialhash_cell(y + h, sh->cell_h);
+}
+
+/**
+ * Get the cells touched by an object's hitbox
+ */
+static void GFraMe_spatialhash_get_obj_range(GFraMe_spatialhash *sh,
+											 GFraMe_object *obj,
+											 GFraMe_spatialhash_range *r) {
+	GFraMe_hitbox *hb = &obj->hitbox;
+	double x, y;
+	x = GFraMe_real_to_double(obj->dx + hb->cx - hb->hw);
+	y = GFraMe_real_to_double(obj->dy + hb->cy - hb->hh);
+	GFraMe_spatialhash_get_range(sh, x, y, GFraMe_real_to_double(hb->hw) * 2.0,
+								 GFraMe_real_to_double(hb->hh) * 2.0, r);
+}
+
+/**
+ * Start a new query, so every object may be reported again
+ */
+static void GFraMe_spatialhash_new_stamp(GFraMe_spatialhash *sh) {
+	sh->cur_stamp++;
+	// On overflow, old stamps could match the current one
+	if (sh->cur_stamp == 0) {
+		memset(sh->stamps, 0x0, sizeof(unsigned int) * sh->max_objs);
+		sh->cur_stamp = 1;
+	}
+}
+
+/**
+ * Report every object on a range of cells that wasn't yet reported
+ */
+static int GFraMe_spatialhash_collect(GFraMe_spatialhash *sh,
+									  GFraMe_spatialhash_range *r,
+									  GFraMe_object *skip,
+									  GFraMe_object **out, int max) {
+	int count = 0;
+	int cx, cy;
+
+	cy = r->y0;
+	while (cy <= r->y1) {
+		cx = r->x0;
+		while (cx <= r->x1) {
+			int b, i, end;
+
+			b = GFraMe_spatialhash_bucket(sh, cx, cy);
+			i = sh->bucket_start[b];
+			end = sh->bucket_start[b + 1];
+			while (i < end) {
+				GFraMe_spatialhash_node *n = sh->nodes + i;
+				// Buckets are shared by many cells, so check the actual one
+				// (and skip removed objects)
+				if (n->obj >= 0 && n->cx == cx && n->cy == cy &&
+					sh->stamps[n->obj] != sh->cur_stamp) {
+					GFraMe_object *other = sh->objs[n->obj];
+
+					sh->stamps[n->obj] = sh->cur_stamp;
+					// Skip the object itself and the ones it never collides
+					// against
+					if (other != skip && (!skip ||
+						GFraMe_object_layers_match(skip, other))) {
+						if (count < max)
+							out[count] = other;
+						count++;
+					}
+				}
+				i++;
+			}
+			cx++;
+		}
+		cy++;
+	}
+
+	return count;
+}
+
+/**
+ * Initialize a spatial hash; a good cell size is about twice the size of the
+ *usual object
+ * @param	*sh	Spatial hash to be initialized
+ * @param	cell_w	Width of each cell
+ * @param	cell_h	Height of each cell
+ * @param	num_buckets	How many buckets to use (rounded up to a power of two)
+ * @param	max_objs	How many objects may be registered
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_spatialhash_init(GFraMe_spatialhash *sh, int cell_w,
+								   int cell_h, int num_buckets, int max_objs) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+
+	// Init every alloc'ed pointer with NULL
+	sh->bucket_start = NULL;
+	sh->nodes = NULL;
+	sh->objs = NULL;
+	sh->ranges = NULL;
+	sh->stamps = NULL;
+
+	GFraMe_assertRV(cell_w > 0 && cell_h > 0 && num_buckets > 0 &&
+					max_objs > 0, "Invalid spatial hash dimensions",
+					rv = GFraMe_ret_bad_param, _ret);
+
+	sh->cell_w = cell_w;
+	sh->cell_h = cell_h;
+	// Round the buckets up, so hashing is a simple mask
+	sh->num_buckets = 1;
+	while (sh->num_buckets < num_buckets)
+		sh->num_buckets <<= 1;
+	sh->num_objs = 0;
+	sh->max_objs = max_objs;
+	sh->num_indexed = 0;
+	sh->num_nodes = 0;
+	// Most objects should touch less than four cells
+	sh->max_nodes = max_objs * 4;
+	sh->cur_stamp = 0;
+
+	sh->bucket_start = (int*)calloc(sh->num_buckets + 1, sizeof(int));
+	GFraMe_assertRV(sh->bucket_start, "Failed to alloc buckets",
+					rv = GFraMe_ret_memory_error, _ret);
+	sh->nodes = (GFraMe_spatialhash_node*)malloc(
+					sizeof(GFraMe_spatialhash_node) * sh->max_nodes);
+	GFraMe_assertRV(sh->nodes, "Failed to alloc nodes",
+					rv = GFraMe_ret_memory_error, _ret);
+	sh->objs = (GFraMe_object**)malloc(sizeof(GFraMe_object*) * max_objs);
+	GFraMe_assertRV(sh->objs, "Failed to alloc objects",
+					rv = GFraMe_ret_memory_error, _ret);
+	sh->ranges = (GFraMe_spatialhash_range*)malloc(
+					sizeof(GFraMe_spatialhash_range) * max_objs);
+	GFraMe_assertRV(sh->ranges, "Failed to alloc ranges",
+					rv = GFraMe_ret_memory_error, _ret);
+	sh->stamps = (unsigned int*)calloc(max_objs, sizeof(unsigned int));
+	GFraMe_assertRV(sh->stamps, "Failed to alloc stamps",
+					rv = GFraMe_ret_memory_error, _ret);
+_ret:
+	if (rv != GFraMe_ret_ok)
+		GFraMe_spatialhash_clear(sh);
+	return rv;
+}
+
+/**
+ * Release every memory used by the spatial hash
+ * @param	*sh	The spatial hash
+ */
+void GFraMe_spatialhash_clear(GFraMe_spatialhash *sh) {
+	if (sh->bucket_start)
+		free(sh->bucket_start);
+	sh->bucket_start = NULL;
+	if (sh->nodes)
+		free(sh->nodes);
+	sh->nodes = NULL;
+	if (sh->objs)
+		free(sh->objs);
+	sh->objs = NULL;
+	if (sh->ranges)
+		free(sh->ranges);
+	sh->ranges = NULL;
+	if (sh->stamps)
+		free(sh->stamps);
+	sh->stamps = NULL;
+	sh->num_nodes = 0;
+	sh->max_nodes = 0;
+	sh->num_objs = 0;
+	sh->max_objs = 0;
+	sh->num_indexed = 0;
+}
+
+/**
+ * Remove every registered object
+ * @param	*sh	The spatial hash
+ */
+void GFraMe_spatialhash_reset(GFraMe_spatialhash *sh) {
+	sh->num_objs = 0;
+	sh->num_indexed = 0;
+	sh->num_nodes = 0;
+	memset(sh->bucket_start, 0x0, sizeof(int) * (sh->num_buckets + 1));
+}
+
+/**
+ * Register an object; it will only be found after the next update
+ * @param	*sh	The spatial hash
+ * @param	*obj	Object to be registered
+ * @return	GFraMe_ret_ok - Success; GFraMe_buffer_too_small - Too many objects
+ */
+GFraMe_ret GFraMe_spatialhash_add(GFraMe_spatialhash *sh, GFraMe_object *obj) {
+	if (sh->num_objs >= sh->max_objs)
+		return GFraMe_buffer_too_small;
+	sh->objs[sh->num_objs++] = obj;
+	return GFraMe_ret_ok;
+}
+
+/**
+ * Point every node of an object (as of the last update) to another index
+ */
+static void GFraMe_spatialhash_relink(GFraMe_spatialhash *sh, int from,
+									  int to) {
+	GFraMe_spatialhash_range *r = sh->ranges + from;
+	int cx, cy;
+
+	cy = r->y0;
+	while (cy <= r->y1) {
+		cx = r->x0;
+		while (cx <= r->x1) {
+			int b, i, end;
+
+			b = GFraMe_spatialhash_bucket(sh, cx, cy);
+			i = sh->bucket_start[b];
+			end = sh->bucket_start[b + 1];
+			while (i < end) {
+				GFraMe_spatialhash_node *n = sh->nodes + i;
+
+				if (n->obj == from && n->cx == cx && n->cy == cy)
+					n->obj = to;
+				i++;
+			}
+			cx++;
+		}
+		cy++;
+	}
+}
+
+/**
+ * Unregister an object (the last registered object takes its place); it's
+ *immediately removed from the grid, so queries won't find it anymore
+ * @param	*sh	The spatial hash
+ * @param	*obj	Object to be removed
+ * @return	GFraMe_ret_ok - Success; GFraMe_ret_failed - Object not found
+ */
+GFraMe_ret GFraMe_spatialhash_remove(GFraMe_spatialhash *sh,
+									 GFraMe_object *obj) {
+	int i, last;
+
+	i = 0;
+	while (i < sh->num_objs) {
+		if (sh->objs[i] == obj)
+			break;
+		i++;
+	}
+	if (i >= sh->num_objs)
+		return GFraMe_ret_failed;
+
+	last = sh->num_objs - 1;
+	// Only objects registered before the last update have nodes
+	if (i < sh->num_indexed)
+		GFraMe_spatialhash_relink(sh, i, -1);
+	if (last != i) {
+		if (last < sh->num_indexed) {
+			GFraMe_spatialhash_relink(sh, last, i);
+			sh->ranges[i] = sh->ranges[last];
+		}
+		sh->objs[i] = sh->objs[last];
+	}
+	sh->num_objs--;
+	if (sh->num_indexed > sh->num_objs)
+		sh->num_indexed = sh->num_objs;
+	return GFraMe_ret_ok;
+}
+
+/**
+ * Rebuild the grid from the objects' current hitboxes; call this after every
+ *registered object was updated
+ * @param	*sh	The spatial hash
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_spatialhash_update(GFraMe_spatialhash *sh) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	int *start = sh->bucket_start;
+	int i, total;
+
+	// Count how many nodes go into each bucket (shifted by one, so the
+	// prefix sum gives where each bucket starts)
+	memset(start, 0x0, sizeof(int) * (sh->num_buckets + 1));
+	total = 0;
+	i = 0;
+	while (i < sh->num_objs) {
+		GFraMe_spatialhash_range *r = sh->ranges + i;
+		int cx, cy;
+
+		GFraMe_spatialhash_get_obj_range(sh, sh->objs[i], r);
+		cy = r->y0;
+		while (cy <= r->y1) {
+			cx = r->x0;
+			while (cx <= r->x1) {
+				start[GFraMe_spatialhash_bucket(sh, cx, cy) + 1]++;
+				total++;
+				cx++;
+			}
+			cy++;
+		}
+		i++;
+	}
+
+	// Expand the nodes, if needed
+	if (total > sh->max_nodes) {
+		GFraMe_spatialhash_node *tmp;
+		int len = sh->max_nodes;
+
+		while (len < total)
+			len <<= 1;
+		tmp = (GFraMe_spatialhash_node*)realloc(sh->nodes,
+								sizeof(GFraMe_spatialhash_node) * len);
+		GFraMe_assertRV(tmp, "Failed to expand spatial hash nodes",
+						rv = GFraMe_ret_memory_error, _ret);
+		sh->nodes = tmp;
+		sh->max_nodes = len;
+	}
+
+	// Turn the counters into offsets
+	i = 1;
+	while (i <= sh->num_buckets) {
+		start[i] += start[i - 1];
+		i++;
+	}
+
+	// Place every node on its bucket; this advances each bucket start to
+	// the next bucket's start
+	i = 0;
+	while (i < sh->num_objs) {
+		GFraMe_spatialhash_range *r = sh->ranges + i;
+		int cx, cy;
+
+		cy = r->y0;
+		while (cy <= r->y1) {
+			cx = r->x0;
+			while (cx <= r->x1) {
+				GFraMe_spatialhash_node *n;
+
+				n = sh->nodes + start[GFraMe_spatialhash_bucket(sh, cx, cy)]++;
+				n->obj = i;
+				n->cx = cx;
+				n->cy = cy;
+				cx++;
+			}
+			cy++;
+		}
+		i++;
+	}
+
+	// Shift the starts back into place
+	i = sh->num_buckets;
+	while (i > 0) {
+		start[i] = start[i - 1];
+		i--;
+	}
+	start[0] = 0;
+	sh->num_nodes = total;
+	sh->num_indexed = sh->num_objs;
+_ret:
+	if (rv != GFraMe_ret_ok) {
+		// Leave it empty instead of half-built
+		memset(start, 0x0, sizeof(int) * (sh->num_buckets + 1));
+		sh->num_nodes = 0;
+		sh->num_indexed = 0;
+	}
+	return rv;
+}
+
+/**
+ * Retrieve every object that shares a cell with the given rectangle; each
+ *object is reported only once
+ * @param	*sh	The spatial hash
+ * @param	x	Rectangle's left position
+ * @param	y	Rectangle's top position
+ * @param	w	Rectangle's width
+ * @param	h	Rectangle's height
+ * @param	**out	Array where the objects are returned
+ * @param	max	How many objects fit on the array
+ * @return	How many objects were found (may be greater than max)
+ */
+int GFraMe_spatialhash_query_rect(GFraMe_spatialhash *sh, double x, double y,
+								  double w, double h, GFraMe_object **out,
+								  int max) {
+	GFraMe_spatialhash_range r;
+
+	GFraMe_spatialhash_get_range(sh, x, y, w, h, &r);
+	GFraMe_spatialhash_new_stamp(sh);
+	return GFraMe_spatialhash_collect(sh, &r, NULL, out, max);
+}
+
+/**
+ * Retrieve every object that shares a cell with another (which is itself
+ *skipped, as are objects whose layers don't match its own); each object is
+ *reported only once
+ * @param	*sh	The spatial hash
+ * @param	*obj	The object
+ * @param	**out	Array where the objects are returned
+ * @param	max	How many objects fit on the array
+ * @return	How many objects were found (may be greater than max)
+ */
+int GFraMe_spatialhash_query(GFraMe_spatialhash *sh, GFraMe_object *obj,
+							 GFraMe_object **out, int max) {
+	GFraMe_spatialhash_range r;
+
+	GFraMe_spatialhash_get_obj_range(sh, obj, &r);
+	GFraMe_spatialhash_new_stamp(sh);
+	return GFraMe_spatialhash_collect(sh, &r, obj, out, max);
+}
+
+/**
+ * Overlap (through GFraMe_object_overlap) every pair of objects that share a
+ *cell and whose layers match; each pair is tested only once
+ * NOTE the object registered first is always passed as o1 (this matters for
+ *the GFraMe_first_fixed and GFraMe_second_fixed modes)
+ * @param	*sh	The spatial hash
+ * @param	mode	How collision should be handle
+ * @param	cb	Called for every pair that overlapped (may be NULL)
+ * @param	*ctx	Passed to the callback
+ * @return	How many pairs overlapped
+ */
+int GFraMe_spatialhash_collide(GFraMe_spatialhash *sh,
+							   GFraMe_collision_type mode,
+							   GFraMe_spatialhash_callback cb, void *ctx) {
+	int b, count;
+
+	count = 0;
+	b = 0;
+	while (b < sh->num_buckets) {
+		int i, end;
+
+		end = sh->bucket_start[b + 1];
+		i = sh->bucket_start[b];
+		while (i < end) {
+			GFraMe_spatialhash_node *n1 = sh->nodes + i;
+			GFraMe_spatialhash_range *r1;
+			int j;
+
+			// Skip removed objects
+			if (n1->obj < 0) {
+				i++;
+				continue;
+			}
+			r1 = sh->ranges + n1->obj;
+			j = i + 1;
+			while (j < end) {
+				GFraMe_spatialhash_node *n2 = sh->nodes + j;
+				GFraMe_spatialhash_range *r2;
+				GFraMe_object *o1, *o2;
+
+				j++;
+				// Skip other cells that fell into this bucket (and removed
+				// objects)
+				if (n2->obj < 0 || n1->cx != n2->cx || n1->cy != n2->cy)
+					continue;
+				r2 = sh->ranges + n2->obj;
+				// Pairs that share many cells are only tested on the
+				// top-left-most one
+				if (n1->cx != (r1->x0 > r2->x0 ? r1->x0 : r2->x0) ||
+					n1->cy != (r1->y0 > r2->y0 ? r1->y0 : r2->y0))
+					continue;
+				// Keep the registration order
+				if (n1->obj < n2->obj) {
+					o1 = sh->objs[n1->obj];
+					o2 = sh->objs[n2->obj];
+				}
+				else {
+					o1 = sh->objs[n2->obj];
+					o2 = sh->objs[n1->obj];
+				}
+				// Skip objects that never collide
+				if (!GFraMe_object_layers_match(o1, o2))
+					continue;
+				if (GFraMe_object_overlap(o1, o2, mode) == GFraMe_ret_ok) {
+					count++;
+					if (cb)
+						cb(o1, o2, ctx);
+				}
+			}
+			i++;
+		}
+		b++;
+	}
+
+	return count;
+}
+
@@ -90,10 +90,12 @@ void GFraMe_sprite_update(GFraMe_sprite *spr, int ms) {
 }
 
 /**
- * Draw a sprite at its current position
- * @param    *spr    Sprite to be drawn
+ * Draw a sprite displaced from its current position (without modifying it)
+ * @param *spr Sprite to be drawn
+ * @param dx Horizontal displacement
+ * @param dy Vertical displacement
  */
-void GFraMe_sprite_draw(GFraMe_sprite *spr) {
+static void GFraMe_sprite_draw_at(GFraMe_sprite *spr, int dx, int dy) {
 #if defined(GFRAME_OPENGL)
     GFraMe_ssetRenderCtx ctx;
     
@@ -102,25 +104,27 @@ void GFraMe_sprite_draw(GFraMe_sprite *spr) {
     if (!spr->flipped)
         ctx.x = spr->obj.x + spr->offset_x;
     else {
-        ctx.x = spr->obj.x -(spr->sset->tw -(int)spr->obj.hitbox.hw * 2.0)
-             - spr->offset_x;
+        ctx.x = spr->obj.x -(spr->sset->tw -
+                GFraMe_real_to_int(spr->obj.hitbox.hw) * 2.0) - spr->offset_x;
         ctx.sX *= -1;
     }
-    ctx.y = spr->obj.y + spr->offset_y;
+    ctx.x += dx;
+    ctx.y = spr->obj.y + spr->offset_y + dy;
     ctx.alpha = spr->alpha;
     ctx.angle = spr->angle;
     
     GFraMe_spriteset_draw_ex(spr->sset, spr->cur_tile, &ctx);
 #else
-    int x = spr->obj.x;
+    int x = spr->obj.x + dx;
     // Simply draw the current frame at the current position
     if (!spr->flipped)
         x += spr->offset_x;
     else
-        x += -(spr->sset->tw - ((int)spr->obj.hitbox.hw * 2.0))
+        x += -(spr->sset->tw -
+                (GFraMe_real_to_int(spr->obj.hitbox.hw) * 2.0))
              - spr->offset_x;
     GFraMe_spriteset_draw(spr->sset, spr->cur_tile,
-            x, spr->obj.y + spr->offset_y,
+            x, spr->obj.y + spr->offset_y + dy,
             spr->flipped);
 #  if defined(GFRAME_DEBUG) && !defined(GFRAME_OPENGL)
     // If should draw the bounding box
@@ -130,10 +134,12 @@ void GFraMe_sprite_draw(GFraMe_sprite *spr) {
         
         // Create a SDL_Rect at its position
         SDL_Rect dbg_rect;
-        dbg_rect.x = x + hb->cx - hb->hw;
-        dbg_rect.y = spr->obj.y + hb->cy - hb->hh;
-        dbg_rect.w = hb->hw * 2;
-        dbg_rect.h = hb->hh * 2;
+        dbg_rect.x = GFraMe_real_to_int(GFraMe_real_from_int(x) + hb->cx
+                                        - hb->hw);
+        dbg_rect.y = GFraMe_real_to_int(GFraMe_real_from_int(spr->obj.y + dy)
+                                        + hb->cy - hb->hh);
+        dbg_rect.w = GFraMe_real_to_int(hb->hw * 2);
+        dbg_rect.h = GFraMe_real_to_int(hb->hh * 2);
         // Render it to the screen, in red
         SDL_SetRenderDrawColor(GFraMe_renderer, 0xff, 0x00, 0x00, 0xff);
         SDL_RenderDrawRect(GFraMe_renderer, &dbg_rect);
@@ -142,6 +148,14 @@ void GFraMe_sprite_draw(GFraMe_sprite *spr) {
 #endif
 }
 
+/**
+ * Draw a sprite at its current position
+ * @param    *spr    Sprite to be drawn
+ */
+void GFraMe_sprite_draw(GFraMe_sprite *spr) {
+    GFraMe_sprite_draw_at(spr, 0, 0);
+}
+
 /**
  * Draw a sprite from world space into screen space
  * 
@@ -152,23 +166,23 @@ void GFraMe_sprite_draw(GFraMe_sprite *spr) {
  * @param cam_h The camera's height
  */
 void GFraMe_sprite_draw_camera(GFraMe_sprite *spr, int cam_x, int cam_y, int cam_w, int cam_h) {
-    #define ASSERT(stmt) do { if (!(stmt)) goto __ret; } while(0)
-    
-    // Check that the sprite is inside the camera
-    ASSERT(spr->obj.x + spr->sset->w >= cam_x && spr->obj.x <= cam_x + cam_w);
-    ASSERT(spr->obj.y + spr->sset->h >= cam_y && spr->obj.y <= cam_y + cam_h);
+    int x, y;
     
-    // Assign its screen position, render and revert
-    spr->obj.x -= cam_x;
-    spr->obj.y -= cam_y;
-    
-    GFraMe_sprite_draw(spr);
-    
-    spr->obj.x += cam_x;
-    spr->obj.y += cam_y;
+    // Check that the current frame (not the whole spriteset!) is inside the
+    // camera
+    if (!spr->flipped)
+        x = spr->obj.x + spr->offset_x;
+    else
+        x = spr->obj.x - (spr->sset->tw -
+                GFraMe_real_to_int(spr->obj.hitbox.hw) * 2) - spr->offset_x;
+    y = spr->obj.y + spr->offset_y;
+    if (x + spr->sset->tw <= cam_x || x >= cam_x + cam_w)
+        return;
+    if (y + spr->sset->th <= cam_y || y >= cam_y + cam_h)
+        return;
     
-__ret:
-    return;
+    // Render it displaced, instead of moving the object
+    GFraMe_sprite_draw_at(spr, -cam_x, -cam_y);
 }
 
 /**
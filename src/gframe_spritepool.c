@@ -0,0 +1,364 @@
+/**
+ * @src/gframe_spritepool.c
+ */
+#include <GFraMe/GFraMe_animation.h>
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_renderqueue.h>
+#include <GFraMe/GFraMe_sprite.h>
+#include <GFraMe/GFraMe_spritepool.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * How many bits of a handle are used by its slot
+ */
+#define GFRAME_SPRITEPOOL_SLOT_BITS 16
+#define GFRAME_SPRITEPOOL_SLOT_MASK ((1 << GFRAME_SPRITEPOOL_SLOT_BITS) - 1)
+/**
+ * Mask for generations (keeps handles positive)
+ */
+#define GFRAME_SPRITEPOOL_GEN_MASK 0x7fff
+
+/**
+ * Get the slot of a valid handle, or -1
+ */
+static int GFraMe_spritepool_get_slot(GFraMe_spritepool *pool,
+									  GFraMe_sprite_handle handle) {
+	int slot;
+
+	if (handle < 0)
+		return -1;
+	slot = handle & GFRAME_SPRITEPOOL_SLOT_MASK;
+	if (slot >= pool->max)
+		return -1;
+	if (pool->generation[slot] != (handle >> GFRAME_SPRITEPOOL_SLOT_BITS))
+		return -1;
+	// Check that the slot is in use
+	if (pool->index[slot] < 0 || pool->index[slot] >= pool->num
+		|| pool->slot[pool->index[slot]] != slot)
+		return -1;
+	return slot;
+}
+
+/**
+ * Initialize a pool
+ * @param	*pool	Pool to be initialized
+ * @param	max	How many sprites fit on the pool (at most 65536)
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_spritepool_init(GFraMe_spritepool *pool, int max) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+
+	memset(pool, 0x0, sizeof(GFraMe_spritepool));
+	GFraMe_assertRV(max > 0 && max <= GFRAME_SPRITEPOOL_SLOT_MASK + 1,
+					"Invalid pool size", rv = GFraMe_ret_bad_param, _ret);
+
+	pool->sprites = (GFraMe_sprite*)malloc(sizeof(GFraMe_sprite) * max);
+	GFraMe_assertRV(pool->sprites, "Failed to alloc sprites",
+					rv = GFraMe_ret_memory_error, _ret);
+	pool->players = (GFraMe_animplayer*)malloc(sizeof(GFraMe_animplayer)
+											   * max);
+	GFraMe_assertRV(pool->players, "Failed to alloc animation players",
+					rv = GFraMe_ret_memory_error, _ret);
+	pool->changed = (int*)malloc(sizeof(int) * max);
+	GFraMe_assertRV(pool->changed, "Failed to alloc buffer",
+					rv = GFraMe_ret_memory_error, _ret);
+	pool->slot = (int*)malloc(sizeof(int) * max);
+	GFraMe_assertRV(pool->slot, "Failed to alloc slots",
+					rv = GFraMe_ret_memory_error, _ret);
+	pool->index = (int*)malloc(sizeof(int) * max);
+	GFraMe_assertRV(pool->index, "Failed to alloc indexes",
+					rv = GFraMe_ret_memory_error, _ret);
+	pool->generation = (int*)calloc(max, sizeof(int));
+	GFraMe_assertRV(pool->generation, "Failed to alloc generations",
+					rv = GFraMe_ret_memory_error, _ret);
+	pool->max = max;
+
+	GFraMe_spritepool_reset(pool);
+_ret:
+	if (rv != GFraMe_ret_ok)
+		GFraMe_spritepool_clear(pool);
+	return rv;
+}
+
+/**
+ * Release every memory used by the pool
+ * @param	*pool	The pool
+ */
+void GFraMe_spritepool_clear(GFraMe_spritepool *pool) {
+	if (pool->sprites)
+		free(pool->sprites);
+	if (pool->players)
+		free(pool->players);
+	if (pool->changed)
+		free(pool->changed);
+	if (pool->slot)
+		free(pool->slot);
+	if (pool->index)
+		free(pool->index);
+	if (pool->generation)
+		free(pool->generation);
+	memset(pool, 0x0, sizeof(GFraMe_spritepool));
+	pool->free_slot = -1;
+}
+
+/**
+ * Despawn every sprite (invalidating their handles)
+ * @param	*pool	The pool
+ */
+void GFraMe_spritepool_reset(GFraMe_spritepool *pool) {
+	int i;
+
+	// Invalidate the handles of every live sprite
+	i = 0;
+	while (i < pool->num) {
+		int slot = pool->slot[i];
+		pool->generation[slot] = (pool->generation[slot] + 1) &
+								 GFRAME_SPRITEPOOL_GEN_MASK;
+		i++;
+	}
+	// Chain every free slot
+	i = 0;
+	while (i < pool->max) {
+		pool->index[i] = i + 1;
+		i++;
+	}
+	pool->index[pool->max - 1] = -1;
+	pool->free_slot = 0;
+	pool->num = 0;
+}
+
+/**
+ * Get a new sprite from the pool; it must be initialized (e.g., with
+ *GFraMe_sprite_init) by the caller
+ * @param	*pool	The pool
+ * @param	*handle	Returns the sprite's handle (may be NULL)
+ * @return	The new sprite (only valid until some sprite is despawned) or
+ *		  NULL, if the pool is full
+ */
+GFraMe_sprite* GFraMe_spritepool_spawn(GFraMe_spritepool *pool,
+									   GFraMe_sprite_handle *handle) {
+	int i, slot;
+
+	if (pool->free_slot < 0)
+		return NULL;
+	// Get a free slot
+	slot = pool->free_slot;
+	pool->free_slot = pool->index[slot];
+	// Put the sprite after every other
+	i = pool->num;
+	pool->num++;
+	pool->index[slot] = i;
+	pool->slot[i] = slot;
+	GFraMe_animplayer_play(pool->players + i, NULL);
+	if (handle)
+		*handle = (pool->generation[slot] << GFRAME_SPRITEPOOL_SLOT_BITS)
+				  | slot;
+
+	return pool->sprites + i;
+}
+
+/**
+ * Return a sprite to the pool; the last sprite is moved to its index
+ * @param	*pool	The pool
+ * @param	handle	The sprite
+ * @return	GFraMe_ret_ok - Success; GFraMe_ret_bad_param - Invalid handle
+ */
+GFraMe_ret GFraMe_spritepool_despawn(GFraMe_spritepool *pool,
+									 GFraMe_sprite_handle handle) {
+	GFraMe_ret rv;
+	int slot;
+
+	slot = GFraMe_spritepool_get_slot(pool, handle);
+	GFraMe_assertRV(slot >= 0, "Invalid sprite handle",
+					rv = GFraMe_ret_bad_param, _ret);
+	rv = GFraMe_spritepool_despawn_index(pool, pool->index[slot]);
+_ret:
+	return rv;
+}
+
+/**
+ * Return the sprite at an index to the pool; when despawning while iterating,
+ *iterate from the last index to the first, so no sprite is skipped
+ * @param	*pool	The pool
+ * @param	index	The sprite's index
+ * @return	GFraMe_ret_ok - Success; GFraMe_ret_bad_param - Invalid index
+ */
+GFraMe_ret GFraMe_spritepool_despawn_index(GFraMe_spritepool *pool,
+										   int index) {
+	GFraMe_ret rv;
+	int last, slot;
+
+	GFraMe_assertRV(index >= 0 && index < pool->num, "Invalid sprite index",
+					rv = GFraMe_ret_bad_param, _ret);
+	slot = pool->slot[index];
+	last = pool->num - 1;
+	// Move the last sprite into the removed one's place
+	if (index != last) {
+		pool->sprites[index] = pool->sprites[last];
+		pool->players[index] = pool->players[last];
+		pool->slot[index] = pool->slot[last];
+		pool->index[pool->slot[index]] = index;
+	}
+	pool->num--;
+	// Invalidate every handle to the slot and release it
+	pool->generation[slot] = (pool->generation[slot] + 1) &
+							 GFRAME_SPRITEPOOL_GEN_MASK;
+	pool->index[slot] = pool->free_slot;
+	pool->free_slot = slot;
+	rv = GFraMe_ret_ok;
+_ret:
+	return rv;
+}
+
+/**
+ * Get a sprite by its handle
+ * @param	*pool	The pool
+ * @param	handle	The sprite
+ * @return	The sprite (only valid until some sprite is despawned) or NULL, if
+ *		  the handle is invalid
+ */
+GFraMe_sprite* GFraMe_spritepool_get(GFraMe_spritepool *pool,
+									 GFraMe_sprite_handle handle) {
+	int slot;
+
+	slot = GFraMe_spritepool_get_slot(pool, handle);
+	if (slot < 0)
+		return NULL;
+	return pool->sprites + pool->index[slot];
+}
+
+/**
+ * Get the handle of the sprite at an index
+ * @param	*pool	The pool
+ * @param	index	The sprite's index
+ * @return	The sprite's handle
+ */
+GFraMe_sprite_handle GFraMe_spritepool_get_handle(GFraMe_spritepool *pool,
+												  int index) {
+	int slot;
+
+	if (index < 0 || index >= pool->num)
+		return GFraMe_sprite_handle_none;
+	slot = pool->slot[index];
+	return (pool->generation[slot] << GFRAME_SPRITEPOOL_SLOT_BITS) | slot;
+}
+
+/**
+ * Play an animation on a sprite (from its first frame)
+ * @param	*pool	The pool
+ * @param	handle	The sprite
+ * @param	*def	Animation to be played (NULL stops the current one)
+ * @return	GFraMe_ret_ok - Success; GFraMe_ret_bad_param - Invalid handle
+ */
+GFraMe_ret GFraMe_spritepool_play(GFraMe_spritepool *pool,
+								  GFraMe_sprite_handle handle,
+								  GFraMe_animdef const *def) {
+	GFraMe_ret rv;
+	int slot, i;
+
+	slot = GFraMe_spritepool_get_slot(pool, handle);
+	GFraMe_assertRV(slot >= 0, "Invalid sprite handle",
+					rv = GFraMe_ret_bad_param, _ret);
+	i = pool->index[slot];
+	GFraMe_animplayer_play(pool->players + i, def);
+	if (def)
+		pool->sprites[i].cur_tile = def->frames[0];
+	rv = GFraMe_ret_ok;
+_ret:
+	return rv;
+}
+
+/**
+ * Get a sprite's animation player
+ * @param	*pool	The pool
+ * @param	handle	The sprite
+ * @return	The player (only valid until some sprite is despawned) or NULL, if
+ *		  the handle is invalid
+ */
+GFraMe_animplayer* GFraMe_spritepool_get_player(GFraMe_spritepool *pool,
+												GFraMe_sprite_handle handle) {
+	int slot;
+
+	slot = GFraMe_spritepool_get_slot(pool, handle);
+	if (slot < 0)
+		return NULL;
+	return pool->players + pool->index[slot];
+}
+
+/**
+ * Update every live sprite that is active, then every sprite's animation
+ *player (even if the sprite is inactive)
+ * @param	*pool	The pool
+ * @param	ms	Elapsed time from previous frame (in milliseconds)
+ */
+void GFraMe_spritepool_update_all(GFraMe_spritepool *pool, int ms) {
+	GFraMe_sprite *spr, *end;
+	int i, num;
+
+	spr = pool->sprites;
+	end = spr + pool->num;
+	while (spr < end) {
+		if (spr->is_active)
+			GFraMe_sprite_update(spr, ms);
+		spr++;
+	}
+
+	// Only sprites whose frame flipped have their tile rewritten
+	num = GFraMe_animation_update_many(pool->players, pool->num, ms,
+									   pool->changed);
+	i = 0;
+	while (i < num) {
+		int idx = pool->changed[i];
+		pool->sprites[idx].cur_tile =
+			GFraMe_animplayer_get_tile(pool->players + idx);
+		i++;
+	}
+}
+
+/**
+ * Draw every live sprite that is visible
+ * @param	*pool	The pool
+ */
+void GFraMe_spritepool_draw_all(GFraMe_spritepool *pool) {
+	GFraMe_sprite *spr, *end;
+
+	spr = pool->sprites;
+	end = spr + pool->num;
+	while (spr < end) {
+		if (spr->is_visible)
+			GFraMe_sprite_draw(spr);
+		spr++;
+	}
+}
+
+/**
+ * Push every live sprite that is visible into a render queue
+ * @param	*pool	The pool
+ * @param	*queue	The render queue
+ * @param	layer	Layer where the sprites are pushed
+ * @param	depth	Depth of every sprite within the layer
+ * @param	blend	How the sprites are blended
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_spritepool_submit(GFraMe_spritepool *pool,
+									GFraMe_renderqueue *queue, int layer,
+									int depth, GFraMe_blend blend) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	GFraMe_sprite *spr, *end;
+
+	spr = pool->sprites;
+	end = spr + pool->num;
+	while (spr < end) {
+		if (spr->is_visible) {
+			rv = GFraMe_renderqueue_push_sprite(queue, layer, depth, spr,
+												blend);
+			GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to push sprite",
+							 _ret);
+		}
+		spr++;
+	}
+_ret:
+	return rv;
+}
+
@@ -56,7 +56,12 @@ GFraMe_ret GFraMe_spriteset_draw(GFraMe_spriteset *sset, int tile, int x,
 	// GFraMe_texture_l_copy will copy to the screen
 	
 #if defined(GFRAME_OPENGL)
+	// A negative scale flips the sprite (without breaking the batch)
+	if (flipped)
+		GFraMe_opengl_setScale(-1.0f, 1.0f);
 	GFraMe_opengl_renderSprite(x, y, sset->tw, sset->th, sx, sy);
+	if (flipped)
+		GFraMe_opengl_setScale(1.0f, 1.0f);
 #else
 	if (!flipped)
 		rv = GFraMe_texture_l_copy(sx, sy, sset->tw, sset->th,
@@ -113,4 +118,41 @@ _ret:
 	return rv;
 }
 
+/**
+ * Render a horizontal run of tiles, next to each other, to the screen
+ * @param	*sset	Spriteset used to render
+ * @param	*tiles	Index of each tile
+ * @param	num	How many tiles there are
+ * @param	x	Horizontal position of the first tile, on the screen
+ * @param	y	Vertical position, on the screen
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_spriteset_draw_span(GFraMe_spriteset *sset,
+									  GFraMe_tile const *tiles, int num,
+									  int x, int y) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	int i;
+
+	i = 0;
+	while (i < num) {
+		int tile, sx, sy;
+
+		tile = tiles[i];
+		GFraMe_assertRV(tile < sset->max, "Invalid tile!", rv = 1, _ret);
+		// Calculate the tile position
+		sx = (tile % sset->columns) * sset->tw;
+		sy = (tile / sset->columns) * sset->th;
+#if defined(GFRAME_OPENGL)
+		GFraMe_opengl_renderSprite(x, y, sset->tw, sset->th, sx, sy);
+#else
+		rv = GFraMe_texture_l_copy(sx, sy, sset->tw, sset->th, x, y, sset->tw,
+								   sset->th, sset->tex);
+		GFraMe_assertRet(rv == 0, "Failed to render tile!", _ret);
+#endif
+		x += sset->tw;
+		i++;
+	}
+_ret:
+	return rv;
+}
 
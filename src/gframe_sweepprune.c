@@ -0,0 +1,522 @@
+/**
+ * @src/gframe_sweepprune.c
+ */
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_object.h>
+#include <GFraMe/GFraMe_sweepprune.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SLOT(ep)	((ep)->data >> 1)
+#define IS_MAX(ep)	((ep)->data & 1)
+
+/**
+ * Hash a pair of slots
+ */
+static int GFraMe_sweepprune_hash(GFraMe_sweepprune *sap, int a, int b) {
+	unsigned int h;
+	h = ((unsigned int)a * 73856093u) ^ ((unsigned int)b * 19349663u);
+	return (int)(h & (unsigned int)(sap->table_len - 1));
+}
+
+/**
+ * Find where a pair is (or should be) on the table
+ */
+static int GFraMe_sweepprune_find(GFraMe_sweepprune *sap, int a, int b) {
+	int i;
+
+	i = GFraMe_sweepprune_hash(sap, a, b);
+	while (sap->table[i] != -1) {
+		GFraMe_sweepprune_pair *p = sap->pairs + sap->table[i];
+		if (p->a == a && p->b == b)
+			break;
+		i = (i + 1) & (sap->table_len - 1);
+	}
+	return i;
+}
+
+/**
+ * Re-insert every pair into a new table
+ */
+static GFraMe_ret GFraMe_sweepprune_rehash(GFraMe_sweepprune *sap, int len) {
+	int *table;
+	int i;
+
+	table = (int*)malloc(sizeof(int) * len);
+	if (!table)
+		return GFraMe_ret_memory_error;
+	if (sap->table)
+		free(sap->table);
+	sap->table = table;
+	sap->table_len = len;
+	memset(sap->table, 0xff, sizeof(int) * len);
+
+	i = 0;
+	while (i < sap->num_pairs) {
+		GFraMe_sweepprune_pair *p = sap->pairs + i;
+		sap->table[GFraMe_sweepprune_find(sap, p->a, p->b)] = i;
+		i++;
+	}
+	return GFraMe_ret_ok;
+}
+
+/**
+ * Add a new (and not yet touching) pair
+ */
+static GFraMe_ret GFraMe_sweepprune_add_pair(GFraMe_sweepprune *sap, int a,
+											 int b) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	int i;
+
+	// Keep the table at most half full
+	if (sap->num_pairs >= sap->max_pairs) {
+		GFraMe_sweepprune_pair *tmp;
+		int len = sap->max_pairs * 2;
+
+		tmp = (GFraMe_sweepprune_pair*)realloc(sap->pairs,
+										sizeof(GFraMe_sweepprune_pair) * len);
+		GFraMe_assertRV(tmp, "Failed to expand pairs",
+						rv = GFraMe_ret_memory_error, _ret);
+		sap->pairs = tmp;
+		sap->max_pairs = len;
+		rv = GFraMe_sweepprune_rehash(sap, len * 2);
+		GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to expand pair table",
+						 _ret);
+	}
+
+	if (a > b) {
+		int tmp = a;
+		a = b;
+		b = tmp;
+	}
+	i = GFraMe_sweepprune_find(sap, a, b);
+	if (sap->table[i] != -1)
+		goto _ret;
+	sap->table[i] = sap->num_pairs;
+	sap->pairs[sap->num_pairs].a = a;
+	sap->pairs[sap->num_pairs].b = b;
+	sap->pairs[sap->num_pairs].touching = 0;
+	sap->num_pairs++;
+_ret:
+	return rv;
+}
+
+/**
+ * Remember that a touching pair was removed, so it can be reported
+ */
+static GFraMe_ret GFraMe_sweepprune_push_ended(GFraMe_sweepprune *sap,
+											   GFraMe_sweepprune_pair *p) {
+	GFraMe_sweepprune_ended *e;
+
+	if (sap->num_ended >= sap->max_ended) {
+		GFraMe_sweepprune_ended *tmp;
+		int len = sap->max_ended * 2;
+
+		tmp = (GFraMe_sweepprune_ended*)realloc(sap->ended,
+									sizeof(GFraMe_sweepprune_ended) * len);
+		if (!tmp)
+			return GFraMe_ret_memory_error;
+		sap->ended = tmp;
+		sap->max_ended = len;
+	}
+	// Store the objects, as the slots may be reused before it's reported
+	e = sap->ended + sap->num_ended++;
+	if (sap->order[p->a] < sap->order[p->b]) {
+		e->o1 = sap->objs[p->a];
+		e->o2 = sap->objs[p->b];
+	}
+	else {
+		e->o1 = sap->objs[p->b];
+		e->o2 = sap->objs[p->a];
+	}
+	return GFraMe_ret_ok;
+}
+
+/**
+ * Remove the pair at the given table position (on failure, it's kept)
+ */
+static GFraMe_ret GFraMe_sweepprune_remove_at(GFraMe_sweepprune *sap,
+											  int slot) {
+	int mask = sap->table_len - 1;
+	int idx, last;
+	int i, j;
+
+	idx = sap->table[slot];
+	if (sap->pairs[idx].touching) {
+		GFraMe_ret rv;
+
+		rv = GFraMe_sweepprune_push_ended(sap, sap->pairs + idx);
+		if (rv != GFraMe_ret_ok)
+			return rv;
+	}
+
+	// Remove it from the table, shifting back any entry that collided
+	i = slot;
+	sap->table[i] = -1;
+	j = i;
+	while (1) {
+		GFraMe_sweepprune_pair *p;
+		int k;
+
+		j = (j + 1) & mask;
+		if (sap->table[j] == -1)
+			break;
+		p = sap->pairs + sap->table[j];
+		k = GFraMe_sweepprune_hash(sap, p->a, p->b);
+		// Only move it if its home isn't cyclically in (i, j]
+		if ((i <= j) ? (i < k && k <= j) : (i < k || k <= j))
+			continue;
+		sap->table[i] = sap->table[j];
+		sap->table[j] = -1;
+		i = j;
+	}
+
+	// Move the last pair into the hole
+	last = sap->num_pairs - 1;
+	if (idx != last) {
+		GFraMe_sweepprune_pair *p = sap->pairs + last;
+		sap->table[GFraMe_sweepprune_find(sap, p->a, p->b)] = idx;
+		sap->pairs[idx] = *p;
+	}
+	sap->num_pairs--;
+	return GFraMe_ret_ok;
+}
+
+/**
+ * Remove a pair, if it exists
+ */
+static GFraMe_ret GFraMe_sweepprune_remove_pair(GFraMe_sweepprune *sap, int a,
+												int b) {
+	int i;
+
+	if (a > b) {
+		int tmp = a;
+		a = b;
+		b = tmp;
+	}
+	i = GFraMe_sweepprune_find(sap, a, b);
+	if (sap->table[i] != -1)
+		return GFraMe_sweepprune_remove_at(sap, i);
+	return GFraMe_ret_ok;
+}
+
+/**
+ * Check whether an endpoint should come before another; on ties, right bounds
+ *come first, so objects that merely graze aren't overlapping (just like
+ *GFraMe_object_overlap), except for an object's own bounds, whose left one
+ *must always come first (otherwise, a zero-width object would pair with
+ *itself as soon as it grew)
+ */
+static int GFraMe_sweepprune_less(GFraMe_sweepprune_endpoint *e1,
+								  GFraMe_sweepprune_endpoint *e2) {
+	if (e1->val != e2->val)
+		return e1->val < e2->val;
+	if (SLOT(e1) == SLOT(e2))
+		return !IS_MAX(e1) && IS_MAX(e2);
+	return IS_MAX(e1) && !IS_MAX(e2);
+}
+
+/**
+ * Check if two objects overlap on both axis
+ */
+static int GFraMe_sweepprune_touch(GFraMe_object *o1, GFraMe_object *o2) {
+	GFraMe_real dist, max;
+
+	dist = o2->dx + o2->hitbox.cx - o1->dx - o1->hitbox.cx;
+	max = o2->hitbox.hw + o1->hitbox.hw;
+	if (dist >= max || -dist >= max)
+		return 0;
+	dist = o2->dy + o2->hitbox.cy - o1->dy - o1->hitbox.cy;
+	max = o2->hitbox.hh + o1->hitbox.hh;
+	if (dist >= max || -dist >= max)
+		return 0;
+	return 1;
+}
+
+/**
+ * Report a pair, keeping the order in which the objects were added
+ */
+static void GFraMe_sweepprune_report(GFraMe_sweepprune *sap,
+									 GFraMe_sweepprune_pair *p,
+									 GFraMe_sweepprune_event ev,
+									 GFraMe_sweepprune_callback cb,
+									 void *ctx) {
+	if (!cb)
+		return;
+	if (sap->order[p->a] < sap->order[p->b])
+		cb(sap->objs[p->a], sap->objs[p->b], ev, ctx);
+	else
+		cb(sap->objs[p->b], sap->objs[p->a], ev, ctx);
+}
+
+/**
+ * Initialize a sweep and prune
+ * @param	*sap	Sweep and prune to be initialized
+ * @param	max_objs	How many objects may be added
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_sweepprune_init(GFraMe_sweepprune *sap, int max_objs) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+
+	// Init every alloc'ed pointer with NULL
+	sap->objs = NULL;
+	sap->order = NULL;
+	sap->endpoints = NULL;
+	sap->pairs = NULL;
+	sap->table = NULL;
+	sap->ended = NULL;
+
+	GFraMe_assertRV(max_objs > 0, "Invalid number of objects",
+					rv = GFraMe_ret_bad_param, _ret);
+
+	sap->max_objs = max_objs;
+	sap->next_order = 0;
+	sap->num_endpoints = 0;
+	sap->num_pairs = 0;
+	// The pair table must be a power of two (and twice as long as pairs)
+	sap->max_pairs = 1;
+	while (sap->max_pairs < max_objs)
+		sap->max_pairs <<= 1;
+	sap->num_ended = 0;
+	sap->max_ended = 16;
+
+	sap->objs = (GFraMe_object**)calloc(max_objs, sizeof(GFraMe_object*));
+	GFraMe_assertRV(sap->objs, "Failed to alloc objects",
+					rv = GFraMe_ret_memory_error, _ret);
+	sap->order = (unsigned int*)calloc(max_objs, sizeof(unsigned int));
+	GFraMe_assertRV(sap->order, "Failed to alloc order",
+					rv = GFraMe_ret_memory_error, _ret);
+	sap->endpoints = (GFraMe_sweepprune_endpoint*)malloc(
+					sizeof(GFraMe_sweepprune_endpoint) * max_objs * 2);
+	GFraMe_assertRV(sap->endpoints, "Failed to alloc endpoints",
+					rv = GFraMe_ret_memory_error, _ret);
+	sap->pairs = (GFraMe_sweepprune_pair*)malloc(
+					sizeof(GFraMe_sweepprune_pair) * sap->max_pairs);
+	GFraMe_assertRV(sap->pairs, "Failed to alloc pairs",
+					rv = GFraMe_ret_memory_error, _ret);
+	sap->ended = (GFraMe_sweepprune_ended*)malloc(
+					sizeof(GFraMe_sweepprune_ended) * sap->max_ended);
+	GFraMe_assertRV(sap->ended, "Failed to alloc ended pairs",
+					rv = GFraMe_ret_memory_error, _ret);
+	rv = GFraMe_sweepprune_rehash(sap, sap->max_pairs * 2);
+	GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to alloc pair table", _ret);
+_ret:
+	if (rv != GFraMe_ret_ok)
+		GFraMe_sweepprune_clear(sap);
+	return rv;
+}
+
+/**
+ * Release every memory used by the sweep and prune
+ * @param	*sap	The sweep and prune
+ */
+void GFraMe_sweepprune_clear(GFraMe_sweepprune *sap) {
+	if (sap->objs)
+		free(sap->objs);
+	sap->objs = NULL;
+	if (sap->order)
+		free(sap->order);
+	sap->order = NULL;
+	if (sap->endpoints)
+		free(sap->endpoints);
+	sap->endpoints = NULL;
+	if (sap->pairs)
+		free(sap->pairs);
+	sap->pairs = NULL;
+	if (sap->table)
+		free(sap->table);
+	sap->table = NULL;
+	if (sap->ended)
+		free(sap->ended);
+	sap->ended = NULL;
+	sap->max_objs = 0;
+	sap->num_endpoints = 0;
+	sap->num_pairs = 0;
+	sap->max_pairs = 0;
+	sap->table_len = 0;
+	sap->num_ended = 0;
+	sap->max_ended = 0;
+}
+
+/**
+ * Add an object; it's sorted into place on the next update
+ * @param	*sap	The sweep and prune
+ * @param	*obj	Object to be added
+ * @return	GFraMe_ret_ok - Success; GFraMe_buffer_too_small - Too many objects
+ */
+GFraMe_ret GFraMe_sweepprune_add(GFraMe_sweepprune *sap, GFraMe_object *obj) {
+	GFraMe_sweepprune_endpoint *ep;
+	int slot;
+
+	// Look for a free slot
+	slot = 0;
+	while (slot < sap->max_objs && sap->objs[slot])
+		slot++;
+	if (slot >= sap->max_objs)
+		return GFraMe_buffer_too_small;
+	sap->objs[slot] = obj;
+	sap->order[slot] = sap->next_order++;
+
+	// Append both bounds after every other one; since they start after every
+	// right bound, the object starts overlapping nothing, which is
+	// corrected while sorting
+	ep = sap->endpoints + sap->num_endpoints;
+	ep[0].val = obj->dx + obj->hitbox.cx - obj->hitbox.hw;
+	ep[0].data = slot << 1;
+	ep[1].val = obj->dx + obj->hitbox.cx + obj->hitbox.hw;
+	ep[1].data = (slot << 1) | 1;
+	sap->num_endpoints += 2;
+
+	return GFraMe_ret_ok;
+}
+
+/**
+ * Remove an object; every pair it was touching is reported as ended on the
+ *next update
+ * @param	*sap	The sweep and prune
+ * @param	*obj	Object to be removed
+ * @return	GFraMe_ret_ok - Success; GFraMe_ret_failed - Object not found;
+ *		  GFraMe_ret_memory_error - Failed to store an ended pair (the object
+ *		  is kept, so it may be removed again)
+ */
+GFraMe_ret GFraMe_sweepprune_remove(GFraMe_sweepprune *sap,
+									GFraMe_object *obj) {
+	GFraMe_ret rv;
+	int slot, i, j;
+
+	slot = 0;
+	while (slot < sap->max_objs && sap->objs[slot] != obj)
+		slot++;
+	if (slot >= sap->max_objs)
+		return GFraMe_ret_failed;
+
+	// Remove its pairs (the removal moves the last pair into the hole)
+	i = 0;
+	while (i < sap->num_pairs) {
+		GFraMe_sweepprune_pair *p = sap->pairs + i;
+		if (p->a == slot || p->b == slot) {
+			rv = GFraMe_sweepprune_remove_at(sap,
+									GFraMe_sweepprune_find(sap, p->a, p->b));
+			if (rv != GFraMe_ret_ok)
+				return rv;
+		}
+		else
+			i++;
+	}
+
+	// Remove its endpoints, keeping the others sorted
+	i = 0;
+	j = 0;
+	while (i < sap->num_endpoints) {
+		if (SLOT(sap->endpoints + i) != slot)
+			sap->endpoints[j++] = sap->endpoints[i];
+		i++;
+	}
+	sap->num_endpoints = j;
+
+	sap->objs[slot] = NULL;
+	return GFraMe_ret_ok;
+}
+
+/**
+ * Re-sort every object's bounds and report what happened to every pair of
+ *overlapping objects; call it after every object was updated
+ * NOTE the callback shouldn't add nor remove objects
+ * NOTE pairs whose layers don't match are never reported; layers are only
+ *checked when a pair starts overlapping horizontally
+ * @param	*sap	The sweep and prune
+ * @param	cb	Called for every pair that began, persisted or ended
+ *			  overlapping (may be NULL)
+ * @param	*ctx	Passed to the callback
+ * @return	How many pairs are overlapping; negative on failure (the bounds are
+ *		  still sorted, but a pair that couldn't be stored is only found
+ *		  after it stops overlapping and overlaps again)
+ */
+int GFraMe_sweepprune_update(GFraMe_sweepprune *sap,
+							 GFraMe_sweepprune_callback cb, void *ctx) {
+	GFraMe_sweepprune_endpoint *eps = sap->endpoints;
+	int i, count, failed;
+
+	// Refresh every bound
+	i = 0;
+	while (i < sap->num_endpoints) {
+		GFraMe_object *obj = sap->objs[SLOT(eps + i)];
+		if (IS_MAX(eps + i))
+			eps[i].val = obj->dx + obj->hitbox.cx + obj->hitbox.hw;
+		else
+			eps[i].val = obj->dx + obj->hitbox.cx - obj->hitbox.hw;
+		i++;
+	}
+
+	// Insertion sort; every swap between a left and a right bound changes
+	// whether that pair overlaps horizontally
+	failed = 0;
+	i = 1;
+	while (i < sap->num_endpoints) {
+		GFraMe_sweepprune_endpoint cur = eps[i];
+		int j = i - 1;
+
+		while (j >= 0 && GFraMe_sweepprune_less(&cur, eps + j)) {
+			GFraMe_sweepprune_endpoint *other = eps + j;
+
+			if (!IS_MAX(&cur) && IS_MAX(other)) {
+				// A left bound passed a right bound; check the other side
+				// (objects that never collide don't even become a pair)
+				GFraMe_object *o1 = sap->objs[SLOT(&cur)];
+				GFraMe_object *o2 = sap->objs[SLOT(other)];
+				if (GFraMe_object_layers_match(o1, o2) &&
+					o2->dx + o2->hitbox.cx - o2->hitbox.hw <
+						o1->dx + o1->hitbox.cx + o1->hitbox.hw &&
+					GFraMe_sweepprune_add_pair(sap, SLOT(&cur), SLOT(other))
+						!= GFraMe_ret_ok)
+					failed = 1;
+			}
+			else if (IS_MAX(&cur) && !IS_MAX(other)) {
+				// A right bound passed a left bound, so they are separated
+				if (GFraMe_sweepprune_remove_pair(sap, SLOT(&cur),
+												  SLOT(other))
+						!= GFraMe_ret_ok)
+					failed = 1;
+			}
+
+			eps[j + 1] = eps[j];
+			j--;
+		}
+		eps[j + 1] = cur;
+		i++;
+	}
+	// Only fail after sorting, so the bounds are never left out of order
+	if (failed)
+		return -1;
+
+	// Report every pair that stopped overlapping horizontally
+	i = 0;
+	while (cb && i < sap->num_ended) {
+		cb(sap->ended[i].o1, sap->ended[i].o2, GFraMe_sweepprune_end, ctx);
+		i++;
+	}
+	sap->num_ended = 0;
+
+	// Check the vertical bounds of every pair that overlaps horizontally
+	count = 0;
+	i = 0;
+	while (i < sap->num_pairs) {
+		GFraMe_sweepprune_pair *p = sap->pairs + i;
+		int touching;
+
+		touching = GFraMe_sweepprune_touch(sap->objs[p->a], sap->objs[p->b]);
+		if (touching) {
+			GFraMe_sweepprune_report(sap, p, p->touching ?
+									 GFraMe_sweepprune_persist :
+									 GFraMe_sweepprune_begin, cb, ctx);
+			count++;
+		}
+		else if (p->touching)
+			GFraMe_sweepprune_report(sap, p, GFraMe_sweepprune_end, cb, ctx);
+		p->touching = touching;
+		i++;
+	}
+
+	return count;
+}
+
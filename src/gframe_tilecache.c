@@ -0,0 +1,380 @@
+/**
+ * @src/gframe_tilecache.c
+ */
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_screen.h>
+#include <GFraMe/GFraMe_texture.h>
+#include <GFraMe/GFraMe_tilecache.h>
+#include <GFraMe/GFraMe_tilemap.h>
+#include <GFraMe/GFraMe_util.h>
+#include <SDL2/SDL.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(GFRAME_OPENGL)
+/**
+ * From @src/gframe_screen.c; used to clear the chunks' textures
+ */
+extern SDL_Renderer *GFraMe_renderer;
+#endif
+
+/**
+ * Initialize a cache; no texture is created until a chunk is drawn
+ * @param	*cache	Cache to be initialized
+ * @param	*tmap	Tilemap to be cached (must be already initialized)
+ * @param	chunk_w	Width of a chunk, in tiles
+ * @param	chunk_h	Height of a chunk, in tiles
+ * @param	max_chunks	How many chunks may be kept at once (0 keeps every
+ *			  chunk)
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_tilecache_init(GFraMe_tilecache *cache,
+								 GFraMe_tilemap *tmap, int chunk_w,
+								 int chunk_h, int max_chunks) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	int num, i;
+
+	memset(cache, 0x0, sizeof(GFraMe_tilecache));
+	GFraMe_assertRV(chunk_w > 0 && chunk_h > 0 && max_chunks >= 0,
+					"Invalid chunk size", rv = GFraMe_ret_bad_param, _ret);
+	cache->tmap = tmap;
+	cache->chunk_w = chunk_w;
+	cache->chunk_h = chunk_h;
+	cache->chunks_x = (tmap->width_in_tiles + chunk_w - 1) / chunk_w;
+	cache->chunks_y = (tmap->height_in_tiles + chunk_h - 1) / chunk_h;
+	num = cache->chunks_x * cache->chunks_y;
+	if (max_chunks == 0 || max_chunks > num)
+		max_chunks = num;
+
+	cache->chunk_slot = (int*)malloc(sizeof(int) * num);
+	GFraMe_assertRV(cache->chunk_slot, "Failed to alloc chunks",
+					rv = GFraMe_ret_memory_error, _ret);
+	cache->dirty = (unsigned char*)malloc(sizeof(unsigned char) * num);
+	GFraMe_assertRV(cache->dirty, "Failed to alloc chunks",
+					rv = GFraMe_ret_memory_error, _ret);
+	cache->slots = (GFraMe_tilecache_slot*)malloc(
+			sizeof(GFraMe_tilecache_slot) * max_chunks);
+	GFraMe_assertRV(cache->slots, "Failed to alloc textures",
+					rv = GFraMe_ret_memory_error, _ret);
+	cache->max_slots = max_chunks;
+	cache->num_anims = tmap->num_anims;
+	cache->anim_gen = tmap->anim_gen;
+
+	i = 0;
+	while (i < num) {
+		cache->chunk_slot[i] = -1;
+		cache->dirty[i] = 1;
+		i++;
+	}
+_ret:
+	if (rv != GFraMe_ret_ok)
+		GFraMe_tilecache_clear(cache);
+	return rv;
+}
+
+/**
+ * Release every texture and memory used by the cache
+ * @param	*cache	The cache
+ */
+void GFraMe_tilecache_clear(GFraMe_tilecache *cache) {
+	int i;
+
+	i = 0;
+	while (i < cache->num_slots) {
+		GFraMe_texture_clear(&cache->slots[i].tex);
+		i++;
+	}
+	if (cache->slots)
+		free(cache->slots);
+	if (cache->chunk_slot)
+		free(cache->chunk_slot);
+	if (cache->dirty)
+		free(cache->dirty);
+	memset(cache, 0x0, sizeof(GFraMe_tilecache));
+}
+
+/**
+ * Mark the chunk with a tile to be rendered again
+ * @param	*cache	The cache
+ * @param	tx	Tile's horizontal position (in tiles)
+ * @param	ty	Tile's vertical position (in tiles)
+ */
+void GFraMe_tilecache_invalidate(GFraMe_tilecache *cache, int tx, int ty) {
+	if (tx < 0 || ty < 0 || tx >= cache->tmap->width_in_tiles
+			|| ty >= cache->tmap->height_in_tiles)
+		return;
+	cache->dirty[(ty / cache->chunk_h) * cache->chunks_x
+				 + tx / cache->chunk_w] = 1;
+}
+
+/**
+ * Mark every chunk to be rendered again
+ * @param	*cache	The cache
+ */
+void GFraMe_tilecache_invalidate_all(GFraMe_tilecache *cache) {
+	memset(cache->dirty, 1, cache->chunks_x * cache->chunks_y);
+}
+
+/**
+ * Change a tile on the cached tilemap (see GFraMe_tilemap_set_tile) and mark
+ *its chunk to be rendered again
+ * @param	*cache	The cache
+ * @param	tx	Tile's horizontal position (in tiles)
+ * @param	ty	Tile's vertical position (in tiles)
+ * @param	tile	The new tile
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_tilecache_set_tile(GFraMe_tilecache *cache, int tx, int ty,
+									 GFraMe_tile tile) {
+	GFraMe_ret rv;
+
+	rv = GFraMe_tilemap_set_tile(cache->tmap, tx, ty, tile);
+	if (rv == GFraMe_ret_ok)
+		GFraMe_tilecache_invalidate(cache, tx, ty);
+	return rv;
+}
+
+/**
+ * Advance the tilemap's animations, marking only the chunks whose tiles
+ *changed to be rendered again
+ * @param	*cache	The cache
+ * @param	ms	Time elapsed, in milliseconds
+ */
+void GFraMe_tilecache_update(GFraMe_tilecache *cache, int ms) {
+	GFraMe_tilemap *tmap;
+	unsigned int changed;
+	int i;
+
+	tmap = cache->tmap;
+	changed = 0;
+	// Chunks rendered before a type was animated don't know about it
+	if (cache->num_anims != tmap->num_anims)
+		GFraMe_tilecache_invalidate_all(cache);
+	else if (cache->anim_gen != tmap->anim_gen) {
+		// An animated type was set again (and restarted at its first frame);
+		// check whether it was set after the last check, even if the
+		// counter wrapped around
+		i = 0;
+		while (i < tmap->num_anims) {
+			if (tmap->anims[i].gen - cache->anim_gen - 1
+					< tmap->anim_gen - cache->anim_gen)
+				changed |= 1u << i;
+			i++;
+		}
+	}
+	cache->num_anims = tmap->num_anims;
+	cache->anim_gen = tmap->anim_gen;
+	changed |= GFraMe_tilemap_update_anims(tmap, ms);
+	if (!changed)
+		return;
+	// Chunks that aren't cached will be rendered anyway
+	i = 0;
+	while (i < cache->num_slots) {
+		GFraMe_tilecache_slot *cur = cache->slots + i;
+
+		if (cur->chunk >= 0 && (cur->anims & changed))
+			cache->dirty[cur->chunk] = 1;
+		i++;
+	}
+}
+
+#if !defined(GFRAME_OPENGL)
+/**
+ * Get the tiles on a chunk
+ */
+static void GFraMe_tilecache_get_rect(GFraMe_tilemap_rect *rect,
+									  GFraMe_tilecache *cache, int cx,
+									  int cy) {
+	rect->x = cx * cache->chunk_w;
+	rect->y = cy * cache->chunk_h;
+	rect->w = cache->chunk_w;
+	rect->h = cache->chunk_h;
+	// Chunks on the right and bottom borders may be smaller
+	if (rect->x + rect->w > cache->tmap->width_in_tiles)
+		rect->w = cache->tmap->width_in_tiles - rect->x;
+	if (rect->y + rect->h > cache->tmap->height_in_tiles)
+		rect->h = cache->tmap->height_in_tiles - rect->y;
+}
+
+/**
+ * Render a chunk into a texture
+ */
+static GFraMe_ret GFraMe_tilecache_render(GFraMe_tilecache *cache,
+										  GFraMe_texture *tex,
+										  GFraMe_tilemap_rect *rect) {
+	GFraMe_ret rv;
+	Uint8 r, g, b, a;
+
+	rv = GFraMe_texture_lock(tex);
+	GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to lock chunk", _ret);
+	// Empty tiles must be transparent (but keep the color used by the game)
+	SDL_GetRenderDrawColor(GFraMe_renderer, &r, &g, &b, &a);
+	SDL_SetRenderDrawColor(GFraMe_renderer, 0x00, 0x00, 0x00, 0x00);
+	SDL_RenderClear(GFraMe_renderer);
+	SDL_SetRenderDrawColor(GFraMe_renderer, r, g, b, a);
+	rv = GFraMe_tilemap_draw_rect(cache->tmap, rect, 0, 0);
+	GFraMe_texture_unlock();
+	GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to render chunk", _ret);
+_ret:
+	return rv;
+}
+
+/**
+ * Get the texture with a chunk, rendering it if needed
+ * @param	*slot	Returns the texture's index (or -1, if every texture was
+ *		  already drawn on this frame)
+ */
+static GFraMe_ret GFraMe_tilecache_get_slot(int *slot,
+											GFraMe_tilecache *cache,
+											int chunk,
+											GFraMe_tilemap_rect *rect) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	GFraMe_tilecache_slot *cur;
+	int i;
+
+	i = cache->chunk_slot[chunk];
+	if (i < 0) {
+		if (cache->num_slots < cache->max_slots) {
+			// Create a new texture (as big as any chunk)
+			i = cache->num_slots;
+			cur = cache->slots + i;
+			GFraMe_texture_init(&cur->tex);
+			rv = GFraMe_texture_create_blank(&cur->tex,
+									cache->chunk_w * cache->tmap->sset->tw,
+									cache->chunk_h * cache->tmap->sset->th);
+			GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to create chunk",
+							 _ret);
+			SDL_SetTextureBlendMode(cur->tex.texture, SDL_BLENDMODE_BLEND);
+			cache->num_slots++;
+		}
+		else {
+			int j;
+
+			// Reuse the texture drawn the longest time ago
+			i = -1;
+			j = 0;
+			while (j < cache->num_slots) {
+				cur = cache->slots + j;
+				if (cur->last_frame != cache->frame && (i < 0
+						|| cur->last_frame < cache->slots[i].last_frame))
+					i = j;
+				j++;
+			}
+			if (i < 0)
+				goto _ret;
+			cache->chunk_slot[cache->slots[i].chunk] = -1;
+		}
+		cache->slots[i].chunk = chunk;
+		cache->chunk_slot[chunk] = i;
+		cache->dirty[chunk] = 1;
+	}
+	cur = cache->slots + i;
+	if (cache->dirty[chunk]) {
+		rv = GFraMe_tilecache_render(cache, &cur->tex, rect);
+		GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to render chunk", _ret);
+		cache->dirty[chunk] = 0;
+		cur->anims = GFraMe_tilemap_get_anims(cache->tmap, rect);
+	}
+	cur->last_frame = cache->frame;
+_ret:
+	*slot = i;
+	return rv;
+}
+#endif
+
+/**
+ * Draw the chunks visible by a camera, from world space into screen space
+ * @param	*cache	The cache
+ * @param	cam_x	The camera's horizontal position
+ * @param	cam_y	The camera's vertical position
+ * @param	cam_w	The camera's width
+ * @param	cam_h	The camera's height
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_tilecache_draw_camera(GFraMe_tilecache *cache, int cam_x,
+										int cam_y, int cam_w, int cam_h) {
+#if defined(GFRAME_OPENGL)
+	return GFraMe_tilemap_draw_camera(cache->tmap, cam_x, cam_y, cam_w,
+									  cam_h);
+#else
+	GFraMe_ret rv = GFraMe_ret_ok;
+	GFraMe_tilemap *tmap;
+	int cx0, cy0, cx1, cy1, pw, ph, cx, cy;
+
+	tmap = cache->tmap;
+	cache->frame++;
+	// Find the visible chunks (the last ones are exclusive)
+	pw = cache->chunk_w * tmap->sset->tw;
+	ph = cache->chunk_h * tmap->sset->th;
+	cx0 = GFraMe_util_floor_div(cam_x - tmap->x, pw);
+	cy0 = GFraMe_util_floor_div(cam_y - tmap->y, ph);
+	cx1 = GFraMe_util_floor_div(cam_x + cam_w - tmap->x + pw - 1, pw);
+	cy1 = GFraMe_util_floor_div(cam_y + cam_h - tmap->y + ph - 1, ph);
+	if (cx0 < 0)
+		cx0 = 0;
+	if (cy0 < 0)
+		cy0 = 0;
+	if (cx1 > cache->chunks_x)
+		cx1 = cache->chunks_x;
+	if (cy1 > cache->chunks_y)
+		cy1 = cache->chunks_y;
+
+	cy = cy0;
+	while (cy < cy1) {
+		cx = cx0;
+		while (cx < cx1) {
+			GFraMe_tilemap_rect rect;
+			int slot, wx, wy, x0, y0, x1, y1;
+
+			GFraMe_tilecache_get_rect(&rect, cache, cx, cy);
+			wx = tmap->x + rect.x * tmap->sset->tw;
+			wy = tmap->y + rect.y * tmap->sset->th;
+			rv = GFraMe_tilecache_get_slot(&slot, cache,
+										   cy * cache->chunks_x + cx, &rect);
+			GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to cache chunk",
+							 _ret);
+			if (slot < 0) {
+				// Out of textures; draw the chunk's tiles directly
+				rv = GFraMe_tilemap_draw_rect(tmap, &rect, wx - cam_x,
+											  wy - cam_y);
+				GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to draw chunk",
+								 _ret);
+				cx++;
+				continue;
+			}
+			// Copy only the part of the chunk within the camera
+			x0 = (cam_x > wx) ? cam_x - wx : 0;
+			y0 = (cam_y > wy) ? cam_y - wy : 0;
+			x1 = rect.w * tmap->sset->tw;
+			y1 = rect.h * tmap->sset->th;
+			if (x1 > cam_x + cam_w - wx)
+				x1 = cam_x + cam_w - wx;
+			if (y1 > cam_y + cam_h - wy)
+				y1 = cam_y + cam_h - wy;
+			if (x1 > x0 && y1 > y0) {
+				rv = GFraMe_texture_l_copy(x0, y0, x1 - x0, y1 - y0,
+										   wx + x0 - cam_x, wy + y0 - cam_y,
+										   x1 - x0, y1 - y0,
+										   &cache->slots[slot].tex);
+				GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to draw chunk",
+								 _ret);
+			}
+			cx++;
+		}
+		cy++;
+	}
+_ret:
+	return rv;
+#endif
+}
+
+/**
+ * Draw every chunk that is visible on the screen
+ * @param	*cache	The cache
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_tilecache_draw(GFraMe_tilecache *cache) {
+	return GFraMe_tilecache_draw_camera(cache, 0, 0, GFraMe_screen_w,
+										GFraMe_screen_h);
+}
+
@@ -0,0 +1,526 @@
+/**
+ * @src/gframe_tilefile.c
+ */
+#include <GFraMe/GFraMe.h>
+#include <GFraMe/GFraMe_assets.h>
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_spriteset.h>
+#include <GFraMe/GFraMe_tilefile.h>
+#include <GFraMe/GFraMe_tilemap.h>
+#include <SDL2/SDL.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(GFRAME_MOBILE)
+  // Assets are within the package, so they are simply read
+#elif defined(_WIN32)
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+/**
+ * Size of the header, before the chunk table
+ */
+#define GFRAME_TILEFILE_HEADER 20
+
+/**
+ * Read a little-endian 16 bits value
+ */
+static int GFraMe_tilefile_rd16(unsigned char const *p) {
+	return p[0] | (p[1] << 8);
+}
+
+/**
+ * Read a little-endian 32 bits value
+ */
+static unsigned long GFraMe_tilefile_rd32(unsigned char const *p) {
+	return (unsigned long)p[0] | ((unsigned long)p[1] << 8)
+		| ((unsigned long)p[2] << 16) | ((unsigned long)p[3] << 24);
+}
+
+/**
+ * Write a little-endian 16 bits value
+ */
+static void GFraMe_tilefile_wr16(unsigned char *p, int v) {
+	p[0] = v & 0xff;
+	p[1] = (v >> 8) & 0xff;
+}
+
+/**
+ * Write a little-endian 32 bits value
+ */
+static void GFraMe_tilefile_wr32(unsigned char *p, unsigned long v) {
+	p[0] = v & 0xff;
+	p[1] = (v >> 8) & 0xff;
+	p[2] = (v >> 16) & 0xff;
+	p[3] = (v >> 24) & 0xff;
+}
+
+/**
+ * Map (or read, on mobile) a whole file into file->buf
+ */
+static GFraMe_ret GFraMe_tilefile_map(GFraMe_tilefile *file, char *name) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+#if defined(GFRAME_MOBILE)
+	SDL_RWops *fp;
+	unsigned char *buf = NULL;
+	Sint64 len;
+
+	fp = SDL_RWFromFile(name, "rb");
+	GFraMe_assertRV(fp, "Failed to open tilemap", rv = GFraMe_ret_file_not_found,
+					_ret);
+	len = SDL_RWsize(fp);
+	GFraMe_assertRV(len > 0, "Failed to read tilemap",
+					rv = GFraMe_ret_read_file_failed, _ret);
+	buf = (unsigned char*)malloc((size_t)len);
+	GFraMe_assertRV(buf, "Failed to alloc tilemap",
+					rv = GFraMe_ret_memory_error, _ret);
+	GFraMe_assertRV(SDL_RWread(fp, buf, (size_t)len, 1) == 1,
+					"Failed to read tilemap", rv = GFraMe_ret_read_file_failed,
+					_ret);
+	file->buf = buf;
+	file->len = (unsigned long)len;
+	file->is_mapped = 0;
+	buf = NULL;
+_ret:
+	if (buf)
+		free(buf);
+	if (fp)
+		SDL_RWclose(fp);
+#elif defined(_WIN32)
+	HANDLE fp, map = NULL;
+	DWORD len;
+
+	fp = CreateFileA(name, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+					 FILE_ATTRIBUTE_NORMAL, NULL);
+	GFraMe_assertRV(fp != INVALID_HANDLE_VALUE, "Failed to open tilemap",
+					rv = GFraMe_ret_file_not_found, _ret);
+	len = GetFileSize(fp, NULL);
+	GFraMe_assertRV(len != INVALID_FILE_SIZE && len > 0,
+					"Failed to read tilemap", rv = GFraMe_ret_read_file_failed,
+					_ret);
+	map = CreateFileMappingA(fp, NULL, PAGE_READONLY, 0, 0, NULL);
+	GFraMe_assertRV(map, "Failed to map tilemap",
+					rv = GFraMe_ret_read_file_failed, _ret);
+	// The view keeps the mapping alive after the handles are closed
+	file->buf = (unsigned char const*)MapViewOfFile(map, FILE_MAP_READ, 0, 0,
+													0);
+	GFraMe_assertRV(file->buf, "Failed to map tilemap",
+					rv = GFraMe_ret_read_file_failed, _ret);
+	file->len = (unsigned long)len;
+	file->is_mapped = 1;
+_ret:
+	if (map)
+		CloseHandle(map);
+	if (fp != INVALID_HANDLE_VALUE)
+		CloseHandle(fp);
+#else
+	struct stat st;
+	void *buf;
+	int fd;
+
+	fd = open(name, O_RDONLY);
+	GFraMe_assertRV(fd >= 0, "Failed to open tilemap",
+					rv = GFraMe_ret_file_not_found, _ret);
+	GFraMe_assertRV(fstat(fd, &st) == 0 && st.st_size > 0,
+					"Failed to read tilemap", rv = GFraMe_ret_read_file_failed,
+					_ret);
+	// The mapping stays valid after the file is closed
+	buf = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	GFraMe_assertRV(buf != MAP_FAILED, "Failed to map tilemap",
+					rv = GFraMe_ret_read_file_failed, _ret);
+	file->buf = (unsigned char const*)buf;
+	file->len = (unsigned long)st.st_size;
+	file->is_mapped = 1;
+_ret:
+	if (fd >= 0)
+		close(fd);
+#endif
+	return rv;
+}
+
+/**
+ * Open a tilemap file (from the assets folder); only the chunk table is read
+ * @param	*file	File to be initialized
+ * @param	*filename	The file's name
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_tilefile_open(GFraMe_tilefile *file, char *filename) {
+	GFraMe_ret rv;
+	char name[GFraMe_max_path_len];
+	unsigned long w, h, num;
+	int len;
+
+	memset(file, 0x0, sizeof(GFraMe_tilefile));
+	len = GFraMe_max_path_len;
+	rv = GFraMe_assets_clean_filename(name, filename, &len);
+	GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to get tilemap's name",
+					 _ret);
+	rv = GFraMe_tilefile_map(file, name);
+	GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to open tilemap", _ret);
+
+	GFraMe_assertRV(file->len >= GFRAME_TILEFILE_HEADER
+					&& memcmp(file->buf, "GFTM", 4) == 0
+					&& GFraMe_tilefile_rd16(file->buf + 4)
+						== GFRAME_TILEFILE_VERSION,
+					"Invalid tilemap file", rv = GFraMe_ret_failed, _ret);
+	file->chunk_w = GFraMe_tilefile_rd16(file->buf + 6);
+	file->chunk_h = GFraMe_tilefile_rd16(file->buf + 8);
+	w = GFraMe_tilefile_rd32(file->buf + 12);
+	h = GFraMe_tilefile_rd32(file->buf + 16);
+	// A chunk's tiles must fit an int (in bytes), and so must a chunk's end
+	// (even past the tilemap's border)
+	GFraMe_assertRV(file->chunk_w > 0 && file->chunk_h > 0 && w > 0 && h > 0
+					&& (unsigned long)file->chunk_w
+						<= INT_MAX / sizeof(GFraMe_tile) / file->chunk_h
+					&& w <= (unsigned long)(INT_MAX - file->chunk_w)
+					&& h <= (unsigned long)(INT_MAX - file->chunk_h),
+					"Invalid tilemap dimensions", rv = GFraMe_ret_failed, _ret);
+	file->width_in_tiles = (int)w;
+	file->height_in_tiles = (int)h;
+	file->chunks_x = (int)((w + file->chunk_w - 1) / file->chunk_w);
+	file->chunks_y = (int)((h + file->chunk_h - 1) / file->chunk_h);
+	// The chunk table must fit the file (checked without overflowing)
+	num = (file->len - GFRAME_TILEFILE_HEADER) / 8;
+	GFraMe_assertRV((unsigned long)file->chunks_x <= num
+					&& (unsigned long)file->chunks_y
+						<= num / (unsigned long)file->chunks_x,
+					"Truncated tilemap file", rv = GFraMe_ret_failed, _ret);
+	num = (unsigned long)file->chunks_x * (unsigned long)file->chunks_y;
+
+	file->chunks = (GFraMe_tile**)calloc(num, sizeof(GFraMe_tile*));
+	GFraMe_assertRV(file->chunks, "Failed to alloc chunks",
+					rv = GFraMe_ret_memory_error, _ret);
+_ret:
+	if (rv != GFraMe_ret_ok)
+		GFraMe_tilefile_close(file);
+	return rv;
+}
+
+/**
+ * Unmap a file and release every decompressed chunk
+ * @param	*file	The file
+ */
+void GFraMe_tilefile_close(GFraMe_tilefile *file) {
+	if (file->chunks) {
+		int i, num;
+
+		num = file->chunks_x * file->chunks_y;
+		i = 0;
+		while (i < num) {
+			if (file->chunks[i])
+				free(file->chunks[i]);
+			i++;
+		}
+		free(file->chunks);
+	}
+	if (file->buf && !file->is_mapped)
+		free((void*)file->buf);
+#if !defined(GFRAME_MOBILE)
+	else if (file->buf) {
+#  if defined(_WIN32)
+		UnmapViewOfFile(file->buf);
+#  else
+		munmap((void*)file->buf, (size_t)file->len);
+#  endif
+	}
+#endif
+	memset(file, 0x0, sizeof(GFraMe_tilefile));
+}
+
+/**
+ * Get a chunk's dimensions, in tiles
+ */
+static void GFraMe_tilefile_get_rect(GFraMe_tilemap_rect *rect,
+									 GFraMe_tilefile *file, int cx, int cy) {
+	rect->x = cx * file->chunk_w;
+	rect->y = cy * file->chunk_h;
+	rect->w = file->chunk_w;
+	rect->h = file->chunk_h;
+	// Chunks on the right and bottom borders may be smaller
+	if (rect->x + rect->w > file->width_in_tiles)
+		rect->w = file->width_in_tiles - rect->x;
+	if (rect->y + rect->h > file->height_in_tiles)
+		rect->h = file->height_in_tiles - rect->y;
+}
+
+/**
+ * Get a chunk's tiles, decompressing it on its first access
+ * @param	**tiles	Returns the chunk's tiles, row by row (a chunk on the
+ *		  borders is only as wide as the tiles within the map)
+ * @param	*file	The file
+ * @param	cx	Chunk's horizontal position (in chunks)
+ * @param	cy	Chunk's vertical position (in chunks)
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_tilefile_get_chunk(GFraMe_tile **tiles,
+									 GFraMe_tilefile *file, int cx, int cy) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	GFraMe_tilemap_rect rect;
+	GFraMe_tile *chunk = NULL;
+	unsigned char const *entry, *p, *end;
+	unsigned long off, size;
+	int i, num, pos;
+
+	GFraMe_assertRV(cx >= 0 && cy >= 0 && cx < file->chunks_x
+					&& cy < file->chunks_y, "Invalid chunk",
+					rv = GFraMe_ret_bad_param, _ret);
+	i = cy * file->chunks_x + cx;
+	if (file->chunks[i]) {
+		*tiles = file->chunks[i];
+		goto _ret;
+	}
+
+	entry = file->buf + GFRAME_TILEFILE_HEADER + 8 * (unsigned long)i;
+	off = GFraMe_tilefile_rd32(entry);
+	size = GFraMe_tilefile_rd32(entry + 4);
+	GFraMe_assertRV(off <= file->len && size <= file->len - off
+					&& size % 4 == 0, "Corrupted tilemap chunk",
+					rv = GFraMe_ret_failed, _ret);
+	GFraMe_tilefile_get_rect(&rect, file, cx, cy);
+	num = rect.w * rect.h;
+	chunk = (GFraMe_tile*)malloc(sizeof(GFraMe_tile) * num);
+	GFraMe_assertRV(chunk, "Failed to alloc chunk",
+					rv = GFraMe_ret_memory_error, _ret);
+	// Expand every run, which must cover the chunk exactly
+	p = file->buf + off;
+	end = p + size;
+	pos = 0;
+	while (p < end) {
+		int count;
+		GFraMe_tile tile;
+
+		count = GFraMe_tilefile_rd16(p);
+		tile = (GFraMe_tile)GFraMe_tilefile_rd16(p + 2);
+		GFraMe_assertRV(count > 0 && count <= num - pos,
+						"Corrupted tilemap chunk", rv = GFraMe_ret_failed,
+						_ret);
+		while (count > 0) {
+			chunk[pos] = tile;
+			pos++;
+			count--;
+		}
+		p += 4;
+	}
+	GFraMe_assertRV(pos == num, "Corrupted tilemap chunk",
+					rv = GFraMe_ret_failed, _ret);
+
+	file->chunks[i] = chunk;
+	file->num_loaded++;
+	*tiles = chunk;
+	chunk = NULL;
+_ret:
+	if (chunk)
+		free(chunk);
+	return rv;
+}
+
+/**
+ * Release a decompressed chunk (it's decompressed again if accessed later)
+ * @param	*file	The file
+ * @param	cx	Chunk's horizontal position (in chunks)
+ * @param	cy	Chunk's vertical position (in chunks)
+ */
+void GFraMe_tilefile_release_chunk(GFraMe_tilefile *file, int cx, int cy) {
+	int i;
+
+	if (cx < 0 || cy < 0 || cx >= file->chunks_x || cy >= file->chunks_y)
+		return;
+	i = cy * file->chunks_x + cx;
+	if (file->chunks[i]) {
+		free(file->chunks[i]);
+		file->chunks[i] = NULL;
+		file->num_loaded--;
+	}
+}
+
+/**
+ * Get a single tile; tiles outside the map are empty
+ * @param	*tile	Returns the tile
+ * @param	*file	The file
+ * @param	tx	Tile's horizontal position (in tiles)
+ * @param	ty	Tile's vertical position (in tiles)
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_tilefile_get_tile(GFraMe_tile *tile, GFraMe_tilefile *file,
+									int tx, int ty) {
+	GFraMe_tilemap_rect rect;
+
+	rect.x = tx;
+	rect.y = ty;
+	rect.w = 1;
+	rect.h = 1;
+	return GFraMe_tilefile_read(tile, file, &rect);
+}
+
+/**
+ * Copy a rectangle of tiles into a buffer, decompressing only the chunks it
+ *touches; tiles outside the map are empty
+ * @param	*dst	Buffer with (at least) rect->w * rect->h tiles
+ * @param	*file	The file
+ * @param	*rect	The tiles
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_tilefile_read(GFraMe_tile *dst, GFraMe_tilefile *file,
+								GFraMe_tilemap_rect *rect) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	int j;
+
+	j = 0;
+	while (j < rect->h) {
+		GFraMe_tile *row;
+		int ty, i;
+
+		row = dst + j * rect->w;
+		ty = rect->y + j;
+		if (ty < 0 || ty >= file->height_in_tiles) {
+			memset(row, 0x0, sizeof(GFraMe_tile) * rect->w);
+			j++;
+			continue;
+		}
+		// Copy the row in runs, one for each chunk it crosses
+		i = 0;
+		while (i < rect->w) {
+			GFraMe_tilemap_rect chunk_rect;
+			GFraMe_tile *chunk;
+			int tx, cx, cy, n;
+
+			tx = rect->x + i;
+			if (tx < 0 || tx >= file->width_in_tiles) {
+				row[i] = 0;
+				i++;
+				continue;
+			}
+			cx = tx / file->chunk_w;
+			cy = ty / file->chunk_h;
+			rv = GFraMe_tilefile_get_chunk(&chunk, file, cx, cy);
+			GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to read chunk",
+							 _ret);
+			GFraMe_tilefile_get_rect(&chunk_rect, file, cx, cy);
+			n = chunk_rect.x + chunk_rect.w - tx;
+			if (n > rect->w - i)
+				n = rect->w - i;
+			memcpy(row + i, chunk + (ty - chunk_rect.y) * chunk_rect.w
+				   + tx - chunk_rect.x, sizeof(GFraMe_tile) * n);
+			i += n;
+		}
+		j++;
+	}
+_ret:
+	return rv;
+}
+
+/**
+ * Compress a tilemap into a file
+ * @param	*filename	The file's name (not within the assets folder)
+ * @param	*data	Every tile, row by row
+ * @param	width_in_tiles	How many tiles there are horizontally
+ * @param	height_in_tiles	How many tiles there are vertically
+ * @param	chunk_w	Width of a chunk, in tiles
+ * @param	chunk_h	Height of a chunk, in tiles
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_tilefile_write(char *filename, GFraMe_tile const *data,
+								 int width_in_tiles, int height_in_tiles,
+								 int chunk_w, int chunk_h) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	GFraMe_tilefile file;
+	SDL_RWops *fp = NULL;
+	unsigned char *buf = NULL, *p;
+	unsigned long len;
+	int cx, cy;
+
+	GFraMe_assertRV(width_in_tiles > 0 && height_in_tiles > 0 && chunk_w > 0
+					&& chunk_h > 0 && chunk_w <= 0xffff && chunk_h <= 0xffff,
+					"Invalid tilemap dimensions", rv = GFraMe_ret_bad_param,
+					_ret);
+	// Only used to find each chunk's dimensions
+	memset(&file, 0x0, sizeof(GFraMe_tilefile));
+	file.width_in_tiles = width_in_tiles;
+	file.height_in_tiles = height_in_tiles;
+	file.chunk_w = chunk_w;
+	file.chunk_h = chunk_h;
+	file.chunks_x = (width_in_tiles + chunk_w - 1) / chunk_w;
+	file.chunks_y = (height_in_tiles + chunk_h - 1) / chunk_h;
+
+	// At worst, every tile is on its own run
+	len = GFRAME_TILEFILE_HEADER + 8 * (unsigned long)file.chunks_x
+		* file.chunks_y + 4 * (unsigned long)width_in_tiles * height_in_tiles;
+	buf = (unsigned char*)malloc(len);
+	GFraMe_assertRV(buf, "Failed to alloc tilemap",
+					rv = GFraMe_ret_memory_error, _ret);
+	memcpy(buf, "GFTM", 4);
+	GFraMe_tilefile_wr16(buf + 4, GFRAME_TILEFILE_VERSION);
+	GFraMe_tilefile_wr16(buf + 6, chunk_w);
+	GFraMe_tilefile_wr16(buf + 8, chunk_h);
+	GFraMe_tilefile_wr16(buf + 10, 0);
+	GFraMe_tilefile_wr32(buf + 12, (unsigned long)width_in_tiles);
+	GFraMe_tilefile_wr32(buf + 16, (unsigned long)height_in_tiles);
+
+	p = buf + GFRAME_TILEFILE_HEADER + 8 * (unsigned long)file.chunks_x
+		* file.chunks_y;
+	cy = 0;
+	while (cy < file.chunks_y) {
+		cx = 0;
+		while (cx < file.chunks_x) {
+			GFraMe_tilemap_rect rect;
+			unsigned char *entry, *start;
+			int i, j, count;
+			GFraMe_tile tile;
+
+			GFraMe_tilefile_get_rect(&rect, &file, cx, cy);
+			start = p;
+			count = 0;
+			tile = 0;
+			j = 0;
+			while (j < rect.h) {
+				GFraMe_tile const *row;
+
+				row = data + (unsigned long)(rect.y + j) * width_in_tiles
+					+ rect.x;
+				i = 0;
+				while (i < rect.w) {
+					// Close the run when the tile changes (or it's full)
+					if (count > 0 && (row[i] != tile || count == 0xffff)) {
+						GFraMe_tilefile_wr16(p, count);
+						GFraMe_tilefile_wr16(p + 2, tile);
+						p += 4;
+						count = 0;
+					}
+					tile = row[i];
+					count++;
+					i++;
+				}
+				j++;
+			}
+			GFraMe_tilefile_wr16(p, count);
+			GFraMe_tilefile_wr16(p + 2, tile);
+			p += 4;
+
+			entry = buf + GFRAME_TILEFILE_HEADER
+				+ 8 * ((unsigned long)cy * file.chunks_x + cx);
+			GFraMe_tilefile_wr32(entry, (unsigned long)(start - buf));
+			GFraMe_tilefile_wr32(entry + 4, (unsigned long)(p - start));
+			cx++;
+		}
+		cy++;
+	}
+
+	fp = SDL_RWFromFile(filename, "wb");
+	GFraMe_assertRV(fp, "Failed to create tilemap file",
+					rv = GFraMe_ret_file_not_found, _ret);
+	GFraMe_assertRV(SDL_RWwrite(fp, buf, p - buf, 1) == 1,
+					"Failed to write tilemap file", rv = GFraMe_ret_failed,
+					_ret);
+_ret:
+	if (fp)
+		SDL_RWclose(fp);
+	if (buf)
+		free(buf);
+	return rv;
+}
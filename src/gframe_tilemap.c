@@ -3,29 +3,55 @@
  */
 #include <GFraMe/GFraMe_error.h>
 #include <GFraMe/GFraMe_object.h>
+#include <GFraMe/GFraMe_screen.h>
 #include <GFraMe/GFraMe_spriteset.h>
 #include <GFraMe/GFraMe_tilemap.h>
+#include <GFraMe/GFraMe_util.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+/**
+ * How many animated tiles are translated (into their current frames) at once
+ */
+#define GFRAME_TILEMAP_SPAN 64
+
+static GFraMe_ret GFraMe_tilemap_mesh_rows(GFraMe_tilemap *tmap, int r0,
+										   int r1);
 
 /**
  * 
  * @param	*tmap	Tilemap to be initialized
  * @param	width_in_tiles	How many tiles there are horizontally
  * @param	height_in_tiles	How many tiles there are vertically
- * @param	*data	Array of bytes with the tiles
+ * @param	*data	Array with the tiles
  * @param	*sset	Spriteset used to render the tilemap
- * @param	*collideable	Array with which tile types are solid
+ * @param	*collideable	Array with which tile types are solid (may be NULL)
  * @param	col_len	Length of the collideable array
  */
 GFraMe_ret GFraMe_tilemap_init(GFraMe_tilemap *tmap, int width_in_tiles,
-							   int height_in_tiles, char *data,
-							   GFraMe_spriteset *sset, char *collideable, 
+							   int height_in_tiles, GFraMe_tile *data,
+							   GFraMe_spriteset *sset, GFraMe_tile *collideable,
 							   int col_len) {
 	GFraMe_ret rv = GFraMe_ret_ok;
+	int i, max_type;
 	// Init every alloc'ed pointer with NULL
 	tmap->data = NULL;
+	tmap->solid = NULL;
+	tmap->solid_len = 0;
 	tmap->boxes = NULL;
+	tmap->rects = NULL;
+	tmap->mesh_buf = NULL;
+	tmap->anim_tiles = NULL;
+	tmap->anim_index = NULL;
+	tmap->anim_len = 0;
+	tmap->num_boxes = 0;
+	tmap->max_boxes = 0;
+	tmap->num_anims = 0;
+	tmap->anim_gen = 0;
+	// Start at the origin (boxes and culling depend on it)
+	tmap->x = 0;
+	tmap->y = 0;
 	// Copy tilemap's limits
 	tmap->width_in_tiles = width_in_tiles;
 	tmap->height_in_tiles = height_in_tiles;
@@ -33,10 +59,35 @@ GFraMe_ret GFraMe_tilemap_init(GFraMe_tilemap *tmap, int width_in_tiles,
 	tmap->data = data;
 	GFraMe_assertRV(tmap->data, "Failed to alloc assign data",
 					rv = GFraMe_ret_memory_error, _ret);
-	// TODO check collideable array and create the minimum amount
-	// of objects to cover the complete area
+	// Mark every solid tile type, on a table just long enough for them
+	max_type = -1;
+	i = 0;
+	while (collideable && i < col_len) {
+		if (collideable[i] > max_type)
+			max_type = collideable[i];
+		i++;
+	}
+	if (max_type >= 0) {
+		tmap->solid = (unsigned int*)calloc((max_type >> 5) + 1,
+											sizeof(unsigned int));
+		GFraMe_assertRV(tmap->solid, "Failed to alloc solid tiles",
+						rv = GFraMe_ret_memory_error, _ret);
+		tmap->solid_len = (max_type >> 5) + 1;
+	}
+	i = 0;
+	while (collideable && i < col_len) {
+		GFraMe_tile type = collideable[i];
+		tmap->solid[type >> 5] |= 1u << (type & 31);
+		i++;
+	}
 	// Copy the spriteset
 	tmap->sset = sset;
+	// Merge every solid tile into as few boxes as possible
+	tmap->mesh_buf = (int*)malloc(sizeof(int) * 2 * (width_in_tiles + 1));
+	GFraMe_assertRV(tmap->mesh_buf, "Failed to alloc mesh buffer",
+					rv = GFraMe_ret_memory_error, _ret);
+	rv = GFraMe_tilemap_mesh_rows(tmap, 0, height_in_tiles - 1);
+	GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to create boxes", _ret);
 _ret:
 	if (rv != GFraMe_ret_ok)
 		GFraMe_tilemap_clear(tmap);
@@ -50,6 +101,11 @@ void GFraMe_tilemap_clear(GFraMe_tilemap *tmap) {
 	// Clear it's dimensions
 	tmap->width_in_tiles = 0;
 	tmap->height_in_tiles = 0;
+	// Nothing is solid
+	if (tmap->solid)
+		free(tmap->solid);
+	tmap->solid = NULL;
+	tmap->solid_len = 0;
 	// Check if there was any data and free it
 	//if (tmap->data)
 	//	free(tmap->data);
@@ -58,54 +114,655 @@ void GFraMe_tilemap_clear(GFraMe_tilemap *tmap) {
 	if (tmap->boxes)
 		free(tmap->boxes);
 	tmap->boxes = NULL;
+	if (tmap->rects)
+		free(tmap->rects);
+	tmap->rects = NULL;
+	if (tmap->mesh_buf)
+		free(tmap->mesh_buf);
+	tmap->mesh_buf = NULL;
+	if (tmap->anim_tiles)
+		free(tmap->anim_tiles);
+	tmap->anim_tiles = NULL;
+	if (tmap->anim_index)
+		free(tmap->anim_index);
+	tmap->anim_index = NULL;
+	tmap->anim_len = 0;
+	tmap->num_boxes = 0;
+	tmap->max_boxes = 0;
+	tmap->num_anims = 0;
 }
 
-GFraMe_ret GFraMe_tilemap_draw(GFraMe_tilemap *tmap) {
-	int i;
+/**
+ * Position a box's object over the tiles it covers
+ */
+static void GFraMe_tilemap_place_box(GFraMe_tilemap *tmap, int i) {
+	GFraMe_tilemap_rect *r;
+	GFraMe_object *box;
+	int tw, th;
+	
+	r = &tmap->rects[i];
+	box = &tmap->boxes[i];
+	tw = 0;
+	th = 0;
+	if (tmap->sset) {
+		tw = tmap->sset->tw;
+		th = tmap->sset->th;
+	}
+	GFraMe_object_clear(box);
+	GFraMe_object_set_pos(box, tmap->x + r->x * tw, tmap->y + r->y * th);
+	GFraMe_hitbox_set(GFraMe_object_get_hitbox(box), GFraMe_hitbox_upper_left,
+					  0, 0, r->w * tw, r->h * th);
+}
+
+/**
+ * Append a one tile high box
+ */
+static GFraMe_ret GFraMe_tilemap_add_box(GFraMe_tilemap *tmap, int x, int y,
+										 int w, int *index) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	GFraMe_tilemap_rect *r;
+	
+	// Expand the arrays, if necessary
+	if (tmap->num_boxes >= tmap->max_boxes) {
+		GFraMe_object *boxes;
+		GFraMe_tilemap_rect *rects;
+		int max;
+		
+		max = tmap->max_boxes * 2;
+		if (max < 16)
+			max = 16;
+		boxes = (GFraMe_object*)realloc(tmap->boxes,
+										sizeof(GFraMe_object) * max);
+		GFraMe_assertRV(boxes, "Failed to expand boxes",
+						rv = GFraMe_ret_memory_error, _ret);
+		tmap->boxes = boxes;
+		rects = (GFraMe_tilemap_rect*)realloc(tmap->rects,
+											  sizeof(GFraMe_tilemap_rect) * max);
+		GFraMe_assertRV(rects, "Failed to expand boxes",
+						rv = GFraMe_ret_memory_error, _ret);
+		tmap->rects = rects;
+		tmap->max_boxes = max;
+	}
+	r = &tmap->rects[tmap->num_boxes];
+	r->x = x;
+	r->y = y;
+	r->w = w;
+	r->h = 1;
+	*index = tmap->num_boxes;
+	tmap->num_boxes++;
+_ret:
+	return rv;
+}
+
+/**
+ * Create boxes for every solid tile on a range of rows (which must not be
+ *covered by any box); runs of solid tiles are merged horizontally and then
+ *with an equal run on the row above
+ */
+static GFraMe_ret GFraMe_tilemap_mesh_rows(GFraMe_tilemap *tmap, int r0,
+										   int r1) {
 	GFraMe_ret rv = GFraMe_ret_ok;
-	// TODO check which rect is inside the screen and draw only that!
-/*
-	// stupid way to use only one loop and no if *inside* the loop
+	int *prev, *cur, *tmp;
+	int prev_n, cur_n, first, ty;
+	
+	first = tmap->num_boxes;
+	// Boxes that may be extended (from the previous row) and the current one
+	prev = tmap->mesh_buf;
+	cur = tmap->mesh_buf + tmap->width_in_tiles + 1;
+	prev_n = 0;
+	ty = r0;
+	while (ty <= r1) {
+		int tx, j;
+		
+		cur_n = 0;
+		j = 0;
+		tx = 0;
+		while (tx < tmap->width_in_tiles) {
+			int start, k;
+			
+			if (!GFraMe_tilemap_is_solid(tmap, tx, ty)) {
+				tx++;
+				continue;
+			}
+			// Find the whole run
+			start = tx;
+			while (tx < tmap->width_in_tiles
+					&& GFraMe_tilemap_is_solid(tmap, tx, ty))
+				tx++;
+			// Skip every box from the previous row that starts before it
+			while (j < prev_n && tmap->rects[prev[j]].x < start)
+				j++;
+			// Either extend a box with the same run or start a new one
+			if (j < prev_n && tmap->rects[prev[j]].x == start
+					&& tmap->rects[prev[j]].w == tx - start) {
+				k = prev[j];
+				tmap->rects[k].h++;
+				j++;
+			}
+			else {
+				rv = GFraMe_tilemap_add_box(tmap, start, ty, tx - start, &k);
+				GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to add box",
+								 _ret);
+			}
+			cur[cur_n] = k;
+			cur_n++;
+		}
+		// Only this row's boxes may be extended
+		tmp = prev;
+		prev = cur;
+		cur = tmp;
+		prev_n = cur_n;
+		ty++;
+	}
+	// Position every new box
+	while (first < tmap->num_boxes) {
+		GFraMe_tilemap_place_box(tmap, first);
+		first++;
+	}
+_ret:
+	return rv;
+}
+
+/**
+ * Set the tilemap's position, moving its boxes along
+ * @param	*tmap	The tilemap
+ * @param	X	New horizontal position
+ * @param	Y	New vertical position
+ */
+void GFraMe_tilemap_set_pos(GFraMe_tilemap *tmap, int X, int Y) {
+	int i;
+	
+	tmap->x = X;
+	tmap->y = Y;
 	i = 0;
-	int x = 0;
-	int y = 0;
-	while (i < tmap->num_tiles) {
-		rv = GFraMe_spriteset_draw(tmap->sset, tmap->data[i],
-								   tmap->x + x*tmap->sset->tw,
-								   tmap->y + y);
-		GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to draw tilemap",
-						 _ret);
-		x++;
-		y += tmap->sset->th * (x >= width_in_tiles);
-		x -= width_in_tiles * (x >= width_in_tiles);
+	while (i < tmap->num_boxes) {
+		GFraMe_tilemap_place_box(tmap, i);
 		i++;
 	}
-*/
-	// Loop each row
+}
+
+/**
+ * Change a tile; if its solidity changed, only the boxes on the rows around it
+ *are rebuilt
+ * @param	*tmap	The tilemap
+ * @param	tx	Tile's horizontal position (in tiles)
+ * @param	ty	Tile's vertical position (in tiles)
+ * @param	tile	The new tile
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_tilemap_set_tile(GFraMe_tilemap *tmap, int tx, int ty,
+								   GFraMe_tile tile) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	int was_solid, r0, r1, i, j, changed;
+	
+	GFraMe_assertRV(tx >= 0 && ty >= 0 && tx < tmap->width_in_tiles
+					&& ty < tmap->height_in_tiles, "Invalid tile position",
+					rv = GFraMe_ret_bad_param, _ret);
+	was_solid = GFraMe_tilemap_is_solid(tmap, tx, ty);
+	tmap->data[tx + ty*tmap->width_in_tiles] = tile;
+	if (was_solid == GFraMe_tilemap_is_solid(tmap, tx, ty))
+		goto _ret;
+	// Expand the rows until no box is partially inside them
+	r0 = ty;
+	r1 = ty;
+	do {
+		changed = 0;
+		i = 0;
+		while (i < tmap->num_boxes) {
+			GFraMe_tilemap_rect *r = &tmap->rects[i];
+			
+			if (r->y <= r1 && r->y + r->h - 1 >= r0) {
+				if (r->y < r0) {
+					r0 = r->y;
+					changed = 1;
+				}
+				if (r->y + r->h - 1 > r1) {
+					r1 = r->y + r->h - 1;
+					changed = 1;
+				}
+			}
+			i++;
+		}
+	} while (changed);
+	// Remove every box on those rows (keeping the others in order)
 	i = 0;
-	while (i < tmap->width_in_tiles) {
-		int j;
-		// Loop each column
-		j = 0;
-		while (j < tmap->height_in_tiles) {
-			char tile = tmap->data[i + j*tmap->width_in_tiles];
-			if (tile > 0)
-				rv = GFraMe_spriteset_draw(tmap->sset,
-									tmap->data[i + j*tmap->width_in_tiles],
-									tmap->x + i*tmap->sset->tw,
-									tmap->y + j*tmap->sset->th, 0);
-			GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to draw tilemap",
-							 _ret);
+	j = 0;
+	while (i < tmap->num_boxes) {
+		GFraMe_tilemap_rect *r = &tmap->rects[i];
+		
+		if (r->y > r1 || r->y + r->h - 1 < r0) {
+			if (i != j) {
+				tmap->rects[j] = tmap->rects[i];
+				tmap->boxes[j] = tmap->boxes[i];
+			}
 			j++;
 		}
 		i++;
 	}
+	tmap->num_boxes = j;
+	// Merge those rows again
+	rv = GFraMe_tilemap_mesh_rows(tmap, r0, r1);
 _ret:
 	return rv;
 }
 
+/**
+ * Animate every tile of a type; only the drawn tile changes (collision still
+ *uses the type). Animating a type again restarts its clock
+ * @param	*tmap	The tilemap
+ * @param	type	The tile type
+ * @param	*def	Animation whose frames are drawn instead of the type (must
+ *		  outlive the tilemap)
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_tilemap_add_anim(GFraMe_tilemap *tmap, GFraMe_tile type,
+								   GFraMe_animdef const *def) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	GFraMe_tilemap_anim *anim;
+	GFraMe_tile t;
+	int i;
+
+	t = type;
+	GFraMe_assertRV(def && def->num_frames > 0, "Invalid animation",
+					rv = GFraMe_ret_bad_param, _ret);
+	// Every type is drawn as itself until it's animated; the tables only
+	// grow as far as the greatest animated type
+	if (t >= tmap->anim_len) {
+		GFraMe_tile *tiles;
+		unsigned char *index;
+
+		tiles = (GFraMe_tile*)realloc(tmap->anim_tiles,
+									  sizeof(GFraMe_tile) * (t + 1));
+		GFraMe_assertRV(tiles, "Failed to alloc animations",
+						rv = GFraMe_ret_memory_error, _ret);
+		tmap->anim_tiles = tiles;
+		index = (unsigned char*)realloc(tmap->anim_index, t + 1);
+		GFraMe_assertRV(index, "Failed to alloc animations",
+						rv = GFraMe_ret_memory_error, _ret);
+		tmap->anim_index = index;
+		i = tmap->anim_len;
+		while (i <= t) {
+			tmap->anim_tiles[i] = (GFraMe_tile)i;
+			tmap->anim_index[i] = 0;
+			i++;
+		}
+		tmap->anim_len = t + 1;
+	}
+	i = tmap->anim_index[t] - 1;
+	if (i < 0) {
+		GFraMe_assertRV(tmap->num_anims < GFRAME_TILEMAP_ANIMS,
+						"Too many animated tiles",
+						rv = GFraMe_ret_bad_param, _ret);
+		i = tmap->num_anims;
+		tmap->num_anims++;
+		tmap->anim_index[t] = (unsigned char)(i + 1);
+	}
+	anim = tmap->anims + i;
+	anim->type = t;
+	anim->def = def;
+	anim->time = 0;
+	tmap->anim_gen++;
+	anim->gen = tmap->anim_gen;
+	tmap->anim_tiles[t] = (GFraMe_tile)def->frames[0];
+_ret:
+	return rv;
+}
+
+/**
+ * Advance the clock of every animated type
+ * @param	*tmap	The tilemap
+ * @param	ms	Time elapsed, in milliseconds
+ * @return	Mask with the animations (bit 'i' is tmap->anims[i]) whose tile
+ *		  changed
+ */
+unsigned int GFraMe_tilemap_update_anims(GFraMe_tilemap *tmap, int ms) {
+	unsigned int changed;
+	int i;
+
+	changed = 0;
+	i = 0;
+	while (i < tmap->num_anims) {
+		GFraMe_tilemap_anim *anim = tmap->anims + i;
+		GFraMe_animdef const *def = anim->def;
+		GFraMe_tile tile;
+
+		anim->time += ms;
+		// Keep the clock within the animation, so it never overflows
+		if (def->total > 0 && anim->time >= def->total) {
+			if (def->do_loop)
+				anim->time %= def->total;
+			else
+				anim->time = def->total;
+		}
+		tile = (GFraMe_tile)GFraMe_animation_sample(def, anim->time, NULL,
+													NULL);
+		if (tile != tmap->anim_tiles[anim->type]) {
+			tmap->anim_tiles[anim->type] = tile;
+			changed |= 1u << i;
+		}
+		i++;
+	}
+	return changed;
+}
+
+/**
+ * Find which animated types are on a rectangle of tiles
+ * @param	*tmap	The tilemap
+ * @param	*rect	The tiles (must be within the tilemap)
+ * @return	Mask with the animations (bit 'i' is tmap->anims[i]) found
+ */
+unsigned int GFraMe_tilemap_get_anims(GFraMe_tilemap *tmap,
+									  GFraMe_tilemap_rect *rect) {
+	unsigned int mask;
+	int i, j;
+
+	mask = 0;
+	if (!tmap->anim_index)
+		return mask;
+	j = 0;
+	while (j < rect->h) {
+		GFraMe_tile *row;
+
+		row = tmap->data + (rect->y + j) * tmap->width_in_tiles + rect->x;
+		i = 0;
+		while (i < rect->w) {
+			if (row[i] < tmap->anim_len && tmap->anim_index[row[i]])
+				mask |= 1u << (tmap->anim_index[row[i]] - 1);
+			i++;
+		}
+		j++;
+	}
+	return mask;
+}
+
+/**
+ * Get the tile currently drawn for a type
+ * @param	*tmap	The tilemap
+ * @param	type	The tile type
+ * @return	The type's current frame (or the type itself, if not animated)
+ */
+int GFraMe_tilemap_get_drawn(GFraMe_tilemap *tmap, GFraMe_tile type) {
+	if (type < tmap->anim_len)
+		return tmap->anim_tiles[type];
+	return type;
+}
+
+/**
+ * Draw every tile that is visible on the screen
+ * @param	*tmap	The tilemap
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_tilemap_draw(GFraMe_tilemap *tmap) {
+	return GFraMe_tilemap_draw_camera(tmap, 0, 0, GFraMe_screen_w,
+									  GFraMe_screen_h);
+}
+
+/**
+ * Draw a rectangle of tiles, row by row; each run of non-empty tiles is drawn
+ *at once
+ * @param	*tmap	The tilemap
+ * @param	*rect	The tiles (must be within the tilemap)
+ * @param	x	Horizontal position of the rectangle's first tile, on the
+ *		  screen
+ * @param	y	Vertical position of the rectangle's first tile, on the screen
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_tilemap_draw_rect(GFraMe_tilemap *tmap,
+									GFraMe_tilemap_rect *rect, int x, int y) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	int tw, th, j;
+
+	tw = tmap->sset->tw;
+	th = tmap->sset->th;
+	j = 0;
+	while (j < rect->h) {
+		GFraMe_tile *row;
+		int i;
+
+		row = tmap->data + (rect->y + j) * tmap->width_in_tiles + rect->x;
+		i = 0;
+		while (i < rect->w) {
+			int start;
+
+			// Skip empty tiles (tile 0) and find the next run of tiles
+			while (i < rect->w && row[i] == 0)
+				i++;
+			start = i;
+			while (i < rect->w && row[i] != 0)
+				i++;
+			if (i > start && tmap->anim_tiles) {
+				GFraMe_tile buf[GFRAME_TILEMAP_SPAN];
+				int k, n;
+
+				// Draw the current frames, a few tiles at a time
+				while (start < i) {
+					n = i - start;
+					if (n > GFRAME_TILEMAP_SPAN)
+						n = GFRAME_TILEMAP_SPAN;
+					k = 0;
+					while (k < n) {
+						GFraMe_tile type = row[start + k];
+
+						if (type < tmap->anim_len)
+							type = tmap->anim_tiles[type];
+						buf[k] = type;
+						k++;
+					}
+					rv = GFraMe_spriteset_draw_span(tmap->sset, buf, n,
+													x + start * tw,
+													y + j * th);
+					GFraMe_assertRet(rv == GFraMe_ret_ok,
+									 "Failed to draw tilemap", _ret);
+					start += n;
+				}
+			}
+			else if (i > start) {
+				rv = GFraMe_spriteset_draw_span(tmap->sset, row + start,
+												i - start, x + start * tw,
+												y + j * th);
+				GFraMe_assertRet(rv == GFraMe_ret_ok,
+								 "Failed to draw tilemap", _ret);
+			}
+		}
+		j++;
+	}
+_ret:
+	return rv;
+}
+
+/**
+ * Draw the tiles visible by a camera, from world space into screen space; only
+ *the visible rows and columns are visited (row by row), and each run of
+ *non-empty tiles is drawn at once
+ * @param	*tmap	The tilemap
+ * @param	cam_x	The camera's horizontal position
+ * @param	cam_y	The camera's vertical position
+ * @param	cam_w	The camera's width
+ * @param	cam_h	The camera's height
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_tilemap_draw_camera(GFraMe_tilemap *tmap, int cam_x,
+									  int cam_y, int cam_w, int cam_h) {
+	GFraMe_tilemap_rect rect;
+	int x0, y0, x1, y1, tw, th;
+
+	tw = tmap->sset->tw;
+	th = tmap->sset->th;
+	// Find the visible tiles (the last ones are exclusive)
+	x0 = GFraMe_util_floor_div(cam_x - tmap->x, tw);
+	y0 = GFraMe_util_floor_div(cam_y - tmap->y, th);
+	x1 = GFraMe_util_floor_div(cam_x + cam_w - tmap->x + tw - 1, tw);
+	y1 = GFraMe_util_floor_div(cam_y + cam_h - tmap->y + th - 1, th);
+	if (x0 < 0)
+		x0 = 0;
+	if (y0 < 0)
+		y0 = 0;
+	if (x1 > tmap->width_in_tiles)
+		x1 = tmap->width_in_tiles;
+	if (y1 > tmap->height_in_tiles)
+		y1 = tmap->height_in_tiles;
+	if (x1 <= x0 || y1 <= y0)
+		return GFraMe_ret_ok;
+
+	rect.x = x0;
+	rect.y = y0;
+	rect.w = x1 - x0;
+	rect.h = y1 - y0;
+	return GFraMe_tilemap_draw_rect(tmap, &rect, tmap->x + x0 * tw - cam_x,
+									tmap->y + y0 * th - cam_y);
+}
+
+/**
+ * Check whether a tile is solid; tiles outside the tilemap aren't
+ * @param	*tmap	The tilemap
+ * @param	tx	Tile's horizontal position (in tiles)
+ * @param	ty	Tile's vertical position (in tiles)
+ * @return	1 - Tile is solid; 0 - Otherwise
+ */
+int GFraMe_tilemap_is_solid(GFraMe_tilemap *tmap, int tx, int ty) {
+	GFraMe_tile type;
+	if (tx < 0 || ty < 0 || tx >= tmap->width_in_tiles
+			|| ty >= tmap->height_in_tiles)
+		return 0;
+	type = tmap->data[tx + ty*tmap->width_in_tiles];
+	if ((type >> 5) >= tmap->solid_len)
+		return 0;
+	return (tmap->solid[type >> 5] >> (type & 31)) & 1;
+}
+
+/**
+ * Convert a position into a tile position (rounding towards -inf)
+ */
+static int GFraMe_tilemap_get_tile(GFraMe_real pos, int size) {
+	int tile = GFraMe_real_to_int(pos) / size;
+	if (pos < GFraMe_real_from_int(tile * size))
+		tile--;
+	return tile;
+}
+
+/**
+ * Collide an object against the solid tiles it touched since its last update;
+ *only the object is moved (as on GFraMe_second_fixed) and edges shared by two
+ *solid tiles are ignored, so objects don't get stuck between tiles
+ * @param	*tmap	The tilemap
+ * @param	*obj	The object
+ * @return	GFraMe_ret_ok - Overlapped; GFraMe_ret_no_overlap - Otherwise
+ */
 GFraMe_ret GFraMe_tilemap_overlap(GFraMe_tilemap *tmap,GFraMe_object *obj){
 	GFraMe_ret rv = GFraMe_ret_no_overlap;
+	GFraMe_hitbox *hb;
+	GFraMe_real left, top, right, bottom;
+	GFraMe_real hhw, hhh;
+	int tx0, ty0, tx1, ty1, tx, ty, tw, th;
+	
+	GFraMe_assertRet(tmap->sset, "Tilemap without spriteset", _ret);
+	hb = GFraMe_object_get_hitbox(obj);
+	tw = tmap->sset->tw;
+	th = tmap->sset->th;
+	// A tile's half dimensions
+	hhw = GFraMe_real_half(GFraMe_real_from_int(tw));
+	hhh = GFraMe_real_half(GFraMe_real_from_int(th));
+	// Get the area swept by the object since its last update
+	left = obj->dx;
+	if (obj->ldx < left)
+		left = obj->ldx;
+	right = obj->dx;
+	if (obj->ldx > right)
+		right = obj->ldx;
+	top = obj->dy;
+	if (obj->ldy < top)
+		top = obj->ldy;
+	bottom = obj->dy;
+	if (obj->ldy > bottom)
+		bottom = obj->ldy;
+	left += hb->cx - hb->hw - GFraMe_real_from_int(tmap->x);
+	right += hb->cx + hb->hw - GFraMe_real_from_int(tmap->x);
+	top += hb->cy - hb->hh - GFraMe_real_from_int(tmap->y);
+	bottom += hb->cy + hb->hh - GFraMe_real_from_int(tmap->y);
+	// Convert it to tiles (edges that only graze a tile don't touch it)
+	tx0 = GFraMe_tilemap_get_tile(left, tw);
+	ty0 = GFraMe_tilemap_get_tile(top, th);
+	tx1 = GFraMe_tilemap_get_tile(right, tw);
+	if (right == GFraMe_real_from_int(tx1 * tw))
+		tx1--;
+	ty1 = GFraMe_tilemap_get_tile(bottom, th);
+	if (bottom == GFraMe_real_from_int(ty1 * th))
+		ty1--;
+	// Clamp it to the tilemap
+	if (tx0 < 0)
+		tx0 = 0;
+	if (ty0 < 0)
+		ty0 = 0;
+	if (tx1 >= tmap->width_in_tiles)
+		tx1 = tmap->width_in_tiles - 1;
+	if (ty1 >= tmap->height_in_tiles)
+		ty1 = tmap->height_in_tiles - 1;
+	// Collide against every solid tile in that area
+	ty = ty0;
+	while (ty <= ty1) {
+		tx = tx0;
+		while (tx <= tx1) {
+			GFraMe_real hdist, vdist, hmax, vmax, tcx, tcy;
+			int hcol, vcol;
+			
+			if (!GFraMe_tilemap_is_solid(tmap, tx, ty)) {
+				tx++;
+				continue;
+			}
+			// Get the tile's center
+			tcx = GFraMe_real_from_int(tmap->x + tx * tw) + hhw;
+			tcy = GFraMe_real_from_int(tmap->y + ty * th) + hhh;
+			// Check if they overlap (just like GFraMe_object_overlap)
+			hdist = tcx - obj->dx - hb->cx;
+			vdist = tcy - obj->dy - hb->cy;
+			hmax = hhw + hb->hw;
+			vmax = hhh + hb->hh;
+			if (GFraMe_util_absr(hdist) >= hmax
+					|| GFraMe_util_absr(vdist) >= vmax) {
+				tx++;
+				continue;
+			}
+			// Check on which axis they weren't overlapping last frame (and
+			// on which side the object was)
+			hdist = tcx - obj->ldx - hb->cx;
+			vdist = tcy - obj->ldy - hb->cy;
+			hcol = GFraMe_util_absr(hdist) >= hmax;
+			vcol = GFraMe_util_absr(vdist) >= vmax;
+			// Ignore the edge if there's a solid tile on its other side
+			if (hcol && GFraMe_tilemap_is_solid(tmap, tx + (hdist > 0 ? -1 : 1),
+												ty))
+				hcol = 0;
+			if (vcol && GFraMe_tilemap_is_solid(tmap, tx,
+												ty + (vdist > 0 ? -1 : 1)))
+				vcol = 0;
+			// Push the object out of the tile
+			if (hcol) {
+				if (hdist > 0) {
+					obj->dx = tcx - hmax - hb->cx;
+					obj->hit |= GFraMe_direction_right;
+				}
+				else {
+					obj->dx = tcx + hmax - hb->cx;
+					obj->hit |= GFraMe_direction_left;
+				}
+				obj->x = GFraMe_real_to_int(obj->dx);
+			}
+			if (vcol) {
+				if (vdist > 0) {
+					obj->dy = tcy - vmax - hb->cy;
+					obj->hit |= GFraMe_direction_down;
+				}
+				else {
+					obj->dy = tcy + vmax - hb->cy;
+					obj->hit |= GFraMe_direction_up;
+				}
+				obj->y = GFraMe_real_to_int(obj->dy);
+			}
+			rv = GFraMe_ret_ok;
+			tx++;
+		}
+		ty++;
+	}
+_ret:
 	return rv;
 }
-
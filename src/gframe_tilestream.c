@@ -0,0 +1,455 @@
+/**
+ * @src/gframe_tilestream.c
+ */
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_object.h>
+#include <GFraMe/GFraMe_spriteset.h>
+#include <GFraMe/GFraMe_tilefile.h>
+#include <GFraMe/GFraMe_tilemap.h>
+#include <GFraMe/GFraMe_tilestream.h>
+#include <GFraMe/GFraMe_util.h>
+#include <SDL2/SDL_mutex.h>
+#include <SDL2/SDL_thread.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int GFraMe_tilestream_loader(void *data);
+
+/**
+ * Open a tilemap file and start the loader thread; no region is loaded until
+ *the first update
+ * @param	*stream	Stream to be initialized
+ * @param	*filename	The tilemap file (from the assets folder)
+ * @param	region_w	Width of a region, in tiles
+ * @param	region_h	Height of a region, in tiles
+ * @param	radius	How many regions around the view are loaded (they're kept
+ *		  until more than radius + 1 regions away)
+ * @param	*sset	Spriteset used to render the tilemap
+ * @param	*collideable	Array with which tile types are solid (may be NULL)
+ * @param	col_len	Length of the collideable array
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_tilestream_init(GFraMe_tilestream *stream, char *filename,
+								  int region_w, int region_h, int radius,
+								  GFraMe_spriteset *sset,
+								  GFraMe_tile *collideable, int col_len) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	int num, i;
+
+	memset(stream, 0x0, sizeof(GFraMe_tilestream));
+	GFraMe_assertRV(region_w > 0 && region_h > 0 && radius >= 0 && sset,
+					"Invalid region", rv = GFraMe_ret_bad_param, _ret);
+	stream->sset = sset;
+	stream->region_w = region_w;
+	stream->region_h = region_h;
+	stream->radius = radius;
+	if (collideable && col_len > 0) {
+		stream->collideable = (GFraMe_tile*)malloc(sizeof(GFraMe_tile)
+												   * col_len);
+		GFraMe_assertRV(stream->collideable, "Failed to alloc solid tiles",
+						rv = GFraMe_ret_memory_error, _ret);
+		memcpy(stream->collideable, collideable, sizeof(GFraMe_tile) * col_len);
+		stream->col_len = col_len;
+	}
+
+	rv = GFraMe_tilefile_open(&stream->file, filename);
+	GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to open tilemap", _ret);
+	stream->regions_x = (stream->file.width_in_tiles + region_w - 1)
+		/ region_w;
+	stream->regions_y = (stream->file.height_in_tiles + region_h - 1)
+		/ region_h;
+	num = stream->regions_x * stream->regions_y;
+	stream->region_slot = (int*)malloc(sizeof(int) * num);
+	GFraMe_assertRV(stream->region_slot, "Failed to alloc regions",
+					rv = GFraMe_ret_memory_error, _ret);
+	i = 0;
+	while (i < num) {
+		stream->region_slot[i] = -1;
+		i++;
+	}
+
+	stream->mutex = SDL_CreateMutex();
+	GFraMe_SDLassertRV(stream->mutex, "Failed to create mutex",
+					   rv = GFraMe_ret_failed, _ret);
+	stream->cond = SDL_CreateCond();
+	GFraMe_SDLassertRV(stream->cond, "Failed to create condition",
+					   rv = GFraMe_ret_failed, _ret);
+	stream->thread = SDL_CreateThread(GFraMe_tilestream_loader,
+									  "GFraMe_tilestream", stream);
+	GFraMe_SDLassertRV(stream->thread, "Failed to create loader",
+					   rv = GFraMe_ret_failed, _ret);
+_ret:
+	if (rv != GFraMe_ret_ok)
+		GFraMe_tilestream_clear(stream);
+	return rv;
+}
+
+/**
+ * Stop the loader thread and release every region
+ * @param	*stream	The stream
+ */
+void GFraMe_tilestream_clear(GFraMe_tilestream *stream) {
+	int i;
+
+	if (stream->thread) {
+		SDL_LockMutex(stream->mutex);
+		stream->quit = 1;
+		SDL_CondSignal(stream->cond);
+		SDL_UnlockMutex(stream->mutex);
+		SDL_WaitThread(stream->thread, NULL);
+	}
+	if (stream->cond)
+		SDL_DestroyCond(stream->cond);
+	if (stream->mutex)
+		SDL_DestroyMutex(stream->mutex);
+
+	i = 0;
+	while (i < stream->num_slots) {
+		GFraMe_tilestream_slot *slot = stream->slots[i];
+
+		if (slot->state == GFraMe_tilestream_ready
+				|| slot->state == GFraMe_tilestream_resident)
+			GFraMe_tilemap_clear(&slot->tmap);
+		if (slot->data)
+			free(slot->data);
+		free(slot);
+		i++;
+	}
+	if (stream->slots)
+		free(stream->slots);
+	if (stream->region_slot)
+		free(stream->region_slot);
+	if (stream->collideable)
+		free(stream->collideable);
+	GFraMe_tilefile_close(&stream->file);
+	memset(stream, 0x0, sizeof(GFraMe_tilestream));
+}
+
+/**
+ * Decode a region into its slot (called by the loader, without the lock)
+ */
+static GFraMe_ret GFraMe_tilestream_decode(GFraMe_tilestream *stream,
+										   GFraMe_tilestream_slot *slot,
+										   int region) {
+	GFraMe_ret rv;
+	GFraMe_tilemap_rect rect;
+	int cx0, cy0, cx1, cy1, cx, cy;
+
+	rect.x = (region % stream->regions_x) * stream->region_w;
+	rect.y = (region / stream->regions_x) * stream->region_h;
+	rect.w = stream->region_w;
+	rect.h = stream->region_h;
+	// Regions on the right and bottom borders may be smaller
+	if (rect.x + rect.w > stream->file.width_in_tiles)
+		rect.w = stream->file.width_in_tiles - rect.x;
+	if (rect.y + rect.h > stream->file.height_in_tiles)
+		rect.h = stream->file.height_in_tiles - rect.y;
+
+	rv = GFraMe_tilefile_read(slot->data, &stream->file, &rect);
+	// The tiles were copied, so the decompressed chunks aren't needed anymore
+	cx0 = rect.x / stream->file.chunk_w;
+	cy0 = rect.y / stream->file.chunk_h;
+	cx1 = (rect.x + rect.w - 1) / stream->file.chunk_w;
+	cy1 = (rect.y + rect.h - 1) / stream->file.chunk_h;
+	cy = cy0;
+	while (cy <= cy1) {
+		cx = cx0;
+		while (cx <= cx1) {
+			GFraMe_tilefile_release_chunk(&stream->file, cx, cy);
+			cx++;
+		}
+		cy++;
+	}
+	GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to read region", _ret);
+
+	rv = GFraMe_tilemap_init(&slot->tmap, rect.w, rect.h, slot->data,
+							 stream->sset, stream->collideable,
+							 stream->col_len);
+	GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to create region", _ret);
+	GFraMe_tilemap_set_pos(&slot->tmap, rect.x * stream->sset->tw,
+						   rect.y * stream->sset->th);
+_ret:
+	return rv;
+}
+
+/**
+ * Loader thread: decode the queued region nearest to the view, until the
+ *stream is cleared
+ */
+static int GFraMe_tilestream_loader(void *data) {
+	GFraMe_tilestream *stream = (GFraMe_tilestream*)data;
+
+	SDL_LockMutex(stream->mutex);
+	while (!stream->quit) {
+		GFraMe_tilestream_slot *slot;
+		GFraMe_ret rv;
+		int i, dist, region;
+
+		slot = NULL;
+		dist = 0;
+		i = 0;
+		while (i < stream->num_slots) {
+			GFraMe_tilestream_slot *cur = stream->slots[i];
+
+			if (cur->state == GFraMe_tilestream_queued) {
+				int dx, dy;
+
+				dx = cur->region % stream->regions_x - stream->center_x;
+				dy = cur->region / stream->regions_x - stream->center_y;
+				if (!slot || dx * dx + dy * dy < dist) {
+					slot = cur;
+					dist = dx * dx + dy * dy;
+				}
+			}
+			i++;
+		}
+		if (!slot) {
+			SDL_CondWait(stream->cond, stream->mutex);
+			continue;
+		}
+		slot->state = GFraMe_tilestream_loading;
+		region = slot->region;
+
+		SDL_UnlockMutex(stream->mutex);
+		rv = GFraMe_tilestream_decode(stream, slot, region);
+		SDL_LockMutex(stream->mutex);
+
+		if (rv == GFraMe_ret_ok)
+			slot->state = GFraMe_tilestream_ready;
+		else {
+			slot->state = GFraMe_tilestream_failed;
+			stream->num_failures++;
+		}
+	}
+	SDL_UnlockMutex(stream->mutex);
+	return 0;
+}
+
+/**
+ * Get an unused slot, creating a new one if needed (with the lock held)
+ * @return	The slot's index (or -1, on failure)
+ */
+static int GFraMe_tilestream_get_slot(GFraMe_tilestream *stream) {
+	GFraMe_tilestream_slot *slot;
+	int i;
+
+	i = 0;
+	while (i < stream->num_slots) {
+		if (stream->slots[i]->state == GFraMe_tilestream_free)
+			return i;
+		i++;
+	}
+	if (stream->num_slots == stream->max_slots) {
+		GFraMe_tilestream_slot **tmp;
+		int max;
+
+		max = stream->max_slots * 2;
+		if (max == 0)
+			max = 16;
+		tmp = (GFraMe_tilestream_slot**)realloc(stream->slots,
+									sizeof(GFraMe_tilestream_slot*) * max);
+		GFraMe_assertRV(tmp, "Failed to alloc regions", i = -1, _ret);
+		stream->slots = tmp;
+		stream->max_slots = max;
+	}
+	slot = (GFraMe_tilestream_slot*)calloc(1, sizeof(GFraMe_tilestream_slot));
+	GFraMe_assertRV(slot, "Failed to alloc region", i = -1, _ret);
+	slot->data = (GFraMe_tile*)malloc(sizeof(GFraMe_tile) * stream->region_w
+									  * stream->region_h);
+	if (!slot->data) {
+		free(slot);
+		GFraMe_assertRV(0, "Failed to alloc region", i = -1, _ret);
+	}
+	slot->region = -1;
+	slot->state = GFraMe_tilestream_free;
+	i = stream->num_slots;
+	stream->slots[i] = slot;
+	stream->num_slots++;
+_ret:
+	return i;
+}
+
+/**
+ * Swap in every region already decoded, evict the far away ones and queue the
+ *ones around the view; never waits for the loader
+ * @param	*stream	The stream
+ * @param	cam_x	The camera's horizontal position
+ * @param	cam_y	The camera's vertical position
+ * @param	cam_w	The camera's width
+ * @param	cam_h	The camera's height
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_tilestream_update(GFraMe_tilestream *stream, int cam_x,
+									int cam_y, int cam_w, int cam_h) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	int rx0, ry0, rx1, ry1, pw, ph, i, x, y, r, queued, miss;
+
+	// Find the visible regions (the last ones are inclusive)
+	pw = stream->region_w * stream->sset->tw;
+	ph = stream->region_h * stream->sset->th;
+	rx0 = GFraMe_util_floor_div(cam_x, pw);
+	ry0 = GFraMe_util_floor_div(cam_y, ph);
+	rx1 = GFraMe_util_floor_div(cam_x + cam_w - 1, pw);
+	ry1 = GFraMe_util_floor_div(cam_y + cam_h - 1, ph);
+	r = stream->radius;
+
+	SDL_LockMutex(stream->mutex);
+	stream->center_x = (rx0 + rx1) / 2;
+	stream->center_y = (ry0 + ry1) / 2;
+	i = 0;
+	while (i < stream->num_slots) {
+		GFraMe_tilestream_slot *slot = stream->slots[i];
+		int sx, sy;
+
+		if (slot->state == GFraMe_tilestream_ready) {
+			slot->state = GFraMe_tilestream_resident;
+			stream->num_loads++;
+		}
+		// Evict regions out of the radius (plus one, so regions on its edge
+		//aren't reloaded as the camera moves back and forth)
+		sx = slot->region % stream->regions_x;
+		sy = slot->region / stream->regions_x;
+		if (slot->region >= 0 && slot->state != GFraMe_tilestream_loading
+				&& (sx < rx0 - r - 1 || sx > rx1 + r + 1 || sy < ry0 - r - 1
+					|| sy > ry1 + r + 1)) {
+			if (slot->state == GFraMe_tilestream_resident) {
+				GFraMe_tilemap_clear(&slot->tmap);
+				stream->num_evictions++;
+			}
+			stream->region_slot[slot->region] = -1;
+			slot->region = -1;
+			slot->state = GFraMe_tilestream_free;
+		}
+		i++;
+	}
+
+	// Queue every region around the view that isn't loaded
+	queued = 0;
+	y = (ry0 - r < 0) ? 0 : ry0 - r;
+	while (y <= ry1 + r && y < stream->regions_y) {
+		x = (rx0 - r < 0) ? 0 : rx0 - r;
+		while (x <= rx1 + r && x < stream->regions_x) {
+			int region = y * stream->regions_x + x;
+
+			if (stream->region_slot[region] < 0) {
+				i = GFraMe_tilestream_get_slot(stream);
+				GFraMe_assertRV(i >= 0, "Failed to queue region",
+								rv = GFraMe_ret_memory_error, _ret);
+				stream->slots[i]->region = region;
+				stream->slots[i]->state = GFraMe_tilestream_queued;
+				stream->region_slot[region] = i;
+				queued = 1;
+			}
+			x++;
+		}
+		y++;
+	}
+
+	// Check whether any visible region is missing (failed regions were
+	// already reported and won't load until evicted)
+	miss = 0;
+	y = (ry0 < 0) ? 0 : ry0;
+	while (y <= ry1 && y < stream->regions_y) {
+		x = (rx0 < 0) ? 0 : rx0;
+		while (x <= rx1 && x < stream->regions_x) {
+			i = stream->region_slot[y * stream->regions_x + x];
+			if (i < 0 || (stream->slots[i]->state != GFraMe_tilestream_resident
+					&& stream->slots[i]->state != GFraMe_tilestream_failed))
+				miss = 1;
+			x++;
+		}
+		y++;
+	}
+	if (miss)
+		stream->num_misses++;
+_ret:
+	if (queued)
+		SDL_CondSignal(stream->cond);
+	SDL_UnlockMutex(stream->mutex);
+	return rv;
+}
+
+/**
+ * Draw every resident region (see GFraMe_tilemap_draw)
+ * @param	*stream	The stream
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_tilestream_draw(GFraMe_tilestream *stream) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	int i;
+
+	SDL_LockMutex(stream->mutex);
+	i = 0;
+	while (i < stream->num_slots) {
+		GFraMe_tilestream_slot *slot = stream->slots[i];
+
+		if (slot->state == GFraMe_tilestream_resident) {
+			rv = GFraMe_tilemap_draw(&slot->tmap);
+			GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to draw region",
+							 _ret);
+		}
+		i++;
+	}
+_ret:
+	SDL_UnlockMutex(stream->mutex);
+	return rv;
+}
+
+/**
+ * Draw the resident regions visible by a camera (see
+ *GFraMe_tilemap_draw_camera)
+ * @param	*stream	The stream
+ * @param	cam_x	The camera's horizontal position
+ * @param	cam_y	The camera's vertical position
+ * @param	cam_w	The camera's width
+ * @param	cam_h	The camera's height
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_tilestream_draw_camera(GFraMe_tilestream *stream, int cam_x,
+										 int cam_y, int cam_w, int cam_h) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	int i;
+
+	SDL_LockMutex(stream->mutex);
+	i = 0;
+	while (i < stream->num_slots) {
+		GFraMe_tilestream_slot *slot = stream->slots[i];
+
+		if (slot->state == GFraMe_tilestream_resident) {
+			rv = GFraMe_tilemap_draw_camera(&slot->tmap, cam_x, cam_y, cam_w,
+											cam_h);
+			GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to draw region",
+							 _ret);
+		}
+		i++;
+	}
+_ret:
+	SDL_UnlockMutex(stream->mutex);
+	return rv;
+}
+
+/**
+ * Collide an object against every resident region (see
+ *GFraMe_tilemap_overlap)
+ * @param	*stream	The stream
+ * @param	*obj	The object
+ * @return	GFraMe_ret_ok - Overlapped; GFraMe_ret_no_overlap - Otherwise
+ */
+GFraMe_ret GFraMe_tilestream_overlap(GFraMe_tilestream *stream,
+									 GFraMe_object *obj) {
+	GFraMe_ret rv = GFraMe_ret_no_overlap;
+	int i;
+
+	SDL_LockMutex(stream->mutex);
+	i = 0;
+	while (i < stream->num_slots) {
+		GFraMe_tilestream_slot *slot = stream->slots[i];
+
+		if (slot->state == GFraMe_tilestream_resident
+				&& GFraMe_tilemap_overlap(&slot->tmap, obj) == GFraMe_ret_ok)
+			rv = GFraMe_ret_ok;
+		i++;
+	}
+	SDL_UnlockMutex(stream->mutex);
+	return rv;
+}
@@ -10,22 +10,22 @@ void GFraMe_tween_clear(GFraMe_tween *tw) {
 	tw->fromY = 0;
 	tw->toX = 0;
 	tw->toY = 0;
-	tw->time = 0.0;
-	tw->maxTime = 0.0;
+	tw->time = 0;
+	tw->maxTime = 0;
 }
 
 void GFraMe_tween_init(GFraMe_tween *tw, int fromX, int fromY, int toX,
-					   int toY, double time, GFraMe_tween_type type) {
+					   int toY, GFraMe_real time, GFraMe_tween_type type) {
 	tw->fromX = fromX;
 	tw->fromY = fromY;
 	tw->toX = toX;
 	tw->toY = toY;
-	tw->time = 0.0;
+	tw->time = 0;
 	tw->type = type;
 	tw->maxTime = time;
 }
 
-GFraMe_tween_ret GFraMe_tween_update(GFraMe_tween *tw, double elapsed) {
+GFraMe_tween_ret GFraMe_tween_update(GFraMe_tween *tw, GFraMe_real elapsed) {
 	if (tw->time >= tw->maxTime)
 		return GFraMe_tween_ret_stopped;
 	tw->time += elapsed;
@@ -35,22 +35,23 @@ GFraMe_tween_ret GFraMe_tween_update(GFraMe_tween *tw, double elapsed) {
 }
 
 GFraMe_tween_ret GFraMe_tween_set_obj(GFraMe_tween *tw, GFraMe_object *obj) {
-	double X, Y;
+	GFraMe_real X, Y, t;
 	switch (tw->type) {
 		case GFraMe_tween_lerp:
-			X = GFraMe_util_lerp(tw->fromX, tw->toX, tw->time /tw->maxTime);
-			Y = GFraMe_util_lerp(tw->fromY, tw->toY, tw->time /tw->maxTime);
+			t = GFraMe_util_divr(tw->time, tw->maxTime);
+			X = GFraMe_util_lerp_real(tw->fromX, tw->toX, t);
+			Y = GFraMe_util_lerp_real(tw->fromY, tw->toY, t);
 		break;
 		default:
 			GFraMe_log("Tween mode not implemented");
 			return GFraMe_tween_ret_failed;
 		break;
 	}
-	GFraMe_object_set_pos(obj, X, Y);
+	GFraMe_object_set_pos(obj, GFraMe_real_to_int(X), GFraMe_real_to_int(Y));
 	return GFraMe_tween_ret_ok;
 }
 
 int GFraMe_tween_is_complete(GFraMe_tween *tw) {
-	return tw->maxTime != 0.0 && tw->time >= tw->maxTime;
+	return tw->maxTime != 0 && tw->time >= tw->maxTime;
 }
 
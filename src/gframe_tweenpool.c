@@ -0,0 +1,309 @@
+/**
+ * @src/gframe_tweenpool.c
+ */
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_fixed.h>
+#include <GFraMe/GFraMe_object.h>
+#include <GFraMe/GFraMe_tweenpool.h>
+#include <math.h>
+#include <stdlib.h>
+
+#ifndef M_PI
+#  define M_PI 3.14159265358979323846
+#endif
+
+/**
+ * Easing tables (shared by every pool)
+ */
+static float GFraMe_ease_lut[GFraMe_ease_max][GFRAME_EASE_LUT_SIZE + 1];
+/**
+ * Whether the tables were already built
+ */
+static int GFraMe_ease_lut_ready = 0;
+
+/**
+ * Calculate an easing curve
+ */
+static double GFraMe_ease_calc(GFraMe_ease ease, double t) {
+	const double c1 = 1.70158;
+	const double c3 = c1 + 1.0;
+	const double c4 = 2.0 * M_PI / 3.0;
+
+	switch (ease) {
+		case GFraMe_ease_quad_in: return t * t;
+		case GFraMe_ease_quad_out: return 1.0 - (1.0 - t) * (1.0 - t);
+		case GFraMe_ease_quad_inout:
+			if (t < 0.5)
+				return 2.0 * t * t;
+			return 1.0 - pow(-2.0 * t + 2.0, 2.0) / 2.0;
+		case GFraMe_ease_cubic_in: return t * t * t;
+		case GFraMe_ease_cubic_out: return 1.0 - pow(1.0 - t, 3.0);
+		case GFraMe_ease_cubic_inout:
+			if (t < 0.5)
+				return 4.0 * t * t * t;
+			return 1.0 - pow(-2.0 * t + 2.0, 3.0) / 2.0;
+		case GFraMe_ease_elastic_in:
+			if (t <= 0.0 || t >= 1.0)
+				return t;
+			return -pow(2.0, 10.0 * t - 10.0) * sin((t * 10.0 - 10.75) * c4);
+		case GFraMe_ease_elastic_out:
+			if (t <= 0.0 || t >= 1.0)
+				return t;
+			return pow(2.0, -10.0 * t) * sin((t * 10.0 - 0.75) * c4) + 1.0;
+		case GFraMe_ease_back_in: return c3 * t * t * t - c1 * t * t;
+		case GFraMe_ease_back_out:
+			return 1.0 + c3 * pow(t - 1.0, 3.0) + c1 * pow(t - 1.0, 2.0);
+		default: return t;
+	}
+}
+
+/**
+ * Build every easing table
+ */
+static void GFraMe_ease_build_lut() {
+	int e, i;
+
+	e = 0;
+	while (e < GFraMe_ease_max) {
+		i = 0;
+		while (i <= GFRAME_EASE_LUT_SIZE) {
+			GFraMe_ease_lut[e][i] = (float)GFraMe_ease_calc((GFraMe_ease)e,
+										(double)i / GFRAME_EASE_LUT_SIZE);
+			i++;
+		}
+		e++;
+	}
+	GFraMe_ease_lut_ready = 1;
+}
+
+/**
+ * Sample an easing curve
+ * @param	ease	The curve (invalid ones are sampled as GFraMe_ease_linear)
+ * @param	t	Time, in [0, 1]
+ * @return	The eased value (0 at t = 0 and 1 at t = 1, but may overshoot)
+ */
+float GFraMe_ease_sample(GFraMe_ease ease, float t) {
+	float pos, frac;
+	int i;
+
+	if (!GFraMe_ease_lut_ready)
+		GFraMe_ease_build_lut();
+	if (ease < 0 || ease >= GFraMe_ease_max)
+		ease = GFraMe_ease_linear;
+	if (t <= 0.0f)
+		return GFraMe_ease_lut[ease][0];
+	if (t >= 1.0f)
+		return GFraMe_ease_lut[ease][GFRAME_EASE_LUT_SIZE];
+	// Interpolate between the two nearest samples
+	pos = t * GFRAME_EASE_LUT_SIZE;
+	i = (int)pos;
+	frac = pos - (float)i;
+	return GFraMe_ease_lut[ease][i] + (GFraMe_ease_lut[ease][i + 1] -
+									   GFraMe_ease_lut[ease][i]) * frac;
+}
+
+/**
+ * Initialize a pool
+ * @param	*pool	Pool to be initialized
+ * @param	max	How many tweens may run at once
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_tweenpool_init(GFraMe_tweenpool *pool, int max) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+
+	pool->tweens = NULL;
+	pool->num = 0;
+	pool->max = 0;
+	GFraMe_assertRV(max > 0, "Invalid pool size", rv = GFraMe_ret_bad_param,
+					_ret);
+
+	pool->tweens = (GFraMe_tweenpool_entry*)malloc(
+					sizeof(GFraMe_tweenpool_entry) * max);
+	GFraMe_assertRV(pool->tweens, "Failed to alloc tweens",
+					rv = GFraMe_ret_memory_error, _ret);
+	pool->max = max;
+
+	// Build the tables now, instead of on the first update
+	if (!GFraMe_ease_lut_ready)
+		GFraMe_ease_build_lut();
+_ret:
+	return rv;
+}
+
+/**
+ * Release every memory used by the pool
+ * @param	*pool	The pool
+ */
+void GFraMe_tweenpool_clear(GFraMe_tweenpool *pool) {
+	if (pool->tweens)
+		free(pool->tweens);
+	pool->tweens = NULL;
+	pool->num = 0;
+	pool->max = 0;
+}
+
+/**
+ * Stop every tween (leaving their targets as they are)
+ * @param	*pool	The pool
+ */
+void GFraMe_tweenpool_reset(GFraMe_tweenpool *pool) {
+	pool->num = 0;
+}
+
+/**
+ * Get a new entry, or NULL if the pool is full
+ */
+static GFraMe_tweenpool_entry* GFraMe_tweenpool_new(GFraMe_tweenpool *pool,
+													int duration,
+													GFraMe_ease ease) {
+	GFraMe_tweenpool_entry *tw;
+
+	if (pool->num >= pool->max)
+		return NULL;
+	tw = pool->tweens + pool->num;
+	pool->num++;
+	tw->elapsed = 0;
+	tw->duration = duration;
+	if (ease < 0 || ease >= GFraMe_ease_max)
+		ease = GFraMe_ease_linear;
+	tw->ease = ease;
+	return tw;
+}
+
+/**
+ * Tween an object from its current position to another one
+ * @param	*pool	The pool
+ * @param	*obj	The object
+ * @param	to_x	Final horizontal position
+ * @param	to_y	Final vertical position
+ * @param	duration	How long, in milliseconds, the tween lasts
+ * @param	ease	Easing curve
+ * @return	GFraMe_ret_ok - Success; GFraMe_buffer_too_small - Pool is full
+ */
+GFraMe_ret GFraMe_tweenpool_add_obj(GFraMe_tweenpool *pool, GFraMe_object *obj,
+									int to_x, int to_y, int duration,
+									GFraMe_ease ease) {
+	GFraMe_tweenpool_entry *tw;
+
+	tw = GFraMe_tweenpool_new(pool, duration, ease);
+	GFraMe_assertRet(tw, "Tween pool is full", _ret);
+	tw->obj = obj;
+	tw->value = NULL;
+	tw->from_x = (float)GFraMe_real_to_double(obj->dx);
+	tw->from_y = (float)GFraMe_real_to_double(obj->dy);
+	tw->to_x = (float)to_x;
+	tw->to_y = (float)to_y;
+	return GFraMe_ret_ok;
+_ret:
+	return GFraMe_buffer_too_small;
+}
+
+/**
+ * Tween a float from its current value to another one
+ * @param	*pool	The pool
+ * @param	*value	The float (must stay valid while tweening)
+ * @param	to	Final value
+ * @param	duration	How long, in milliseconds, the tween lasts
+ * @param	ease	Easing curve
+ * @return	GFraMe_ret_ok - Success; GFraMe_buffer_too_small - Pool is full
+ */
+GFraMe_ret GFraMe_tweenpool_add_float(GFraMe_tweenpool *pool, float *value,
+									  float to, int duration,
+									  GFraMe_ease ease) {
+	GFraMe_tweenpool_entry *tw;
+
+	tw = GFraMe_tweenpool_new(pool, duration, ease);
+	GFraMe_assertRet(tw, "Tween pool is full", _ret);
+	tw->obj = NULL;
+	tw->value = value;
+	tw->from_x = *value;
+	tw->from_y = 0.0f;
+	tw->to_x = to;
+	tw->to_y = 0.0f;
+	return GFraMe_ret_ok;
+_ret:
+	return GFraMe_buffer_too_small;
+}
+
+/**
+ * Stop every tween on a target (leaving it as it is)
+ * @param	*pool	The pool
+ * @param	*target	Either an object or a float
+ * @return	How many tweens were stopped
+ */
+int GFraMe_tweenpool_stop(GFraMe_tweenpool *pool, void *target) {
+	int i, count;
+
+	count = 0;
+	if (!target)
+		return 0;
+	i = pool->num - 1;
+	while (i >= 0) {
+		GFraMe_tweenpool_entry *tw = pool->tweens + i;
+		if ((void*)tw->obj == target || (void*)tw->value == target) {
+			// Move the last tween into its place
+			pool->num--;
+			pool->tweens[i] = pool->tweens[pool->num];
+			count++;
+		}
+		i--;
+	}
+	return count;
+}
+
+/**
+ * Update every running tween; finished tweens are set to their final value
+ *and removed
+ * NOTE objects should be updated before this, so their last position is kept
+ *(for collision)
+ * @param	*pool	The pool
+ * @param	ms	Elapsed time from previous frame (in milliseconds)
+ * @return	How many tweens finished
+ */
+int GFraMe_tweenpool_update(GFraMe_tweenpool *pool, int ms) {
+	int i, count;
+
+	count = 0;
+	// Iterate backward, so removed tweens may be replaced by the last one
+	i = pool->num - 1;
+	while (i >= 0) {
+		GFraMe_tweenpool_entry *tw = pool->tweens + i;
+		float t, x, y;
+		int done;
+
+		tw->elapsed += ms;
+		done = (tw->elapsed >= tw->duration);
+		if (done) {
+			x = tw->to_x;
+			y = tw->to_y;
+		}
+		else {
+			t = GFraMe_ease_sample(tw->ease,
+								   (float)tw->elapsed / (float)tw->duration);
+			x = tw->from_x + (tw->to_x - tw->from_x) * t;
+			y = tw->from_y + (tw->to_y - tw->from_y) * t;
+		}
+		if (tw->obj) {
+			GFraMe_object *obj = tw->obj;
+
+			// ldx/ldy are left untouched, so this must run after the objects
+			// are updated (which set them) for collision to still work
+			obj->dx = GFraMe_real_from_double(x);
+			obj->dy = GFraMe_real_from_double(y);
+			obj->x = GFraMe_real_to_int(obj->dx);
+			obj->y = GFraMe_real_to_int(obj->dy);
+		}
+		else
+			*(tw->value) = x;
+
+		if (done) {
+			pool->num--;
+			pool->tweens[i] = pool->tweens[pool->num];
+			count++;
+		}
+		i--;
+	}
+
+	return count;
+}
+
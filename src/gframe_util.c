@@ -114,9 +114,11 @@ char* GFraMe_util_strcat(char *dst, char *src, int *len) {
  * @param	first_tile	First ASCII character ('!') posiiton on the spriteset
  * @return	First position, on the buffer, after the string.
  */
-char* GFraMe_str2tiles(char *data, char *str, int first_tile) {
+GFraMe_tile* GFraMe_str2tiles(GFraMe_tile *data, char *str, int first_tile) {
 	while (*str) {
-		*data = (char)(*str - '!' + first_tile);
+		int tile = *str - '!' + first_tile;
+		// Characters before '!' (e.g., spaces) are left empty
+		*data = (GFraMe_tile)((tile > 0) ? tile : 0);
 		data++;
 		str++;
 	}
@@ -163,6 +165,69 @@ double GFraMe_util_lerp(int a, int b, double time) {
 	return (double)a * (1 - time) + (double)b * time;
 }
 
+/**
+ * Divide two integers, rounding toward negative infinity (instead of toward
+ *zero, as '/' does)
+ * @param	n	The dividend
+ * @param	d	The divisor (must be positive)
+ * @return	The quotient
+ */
+int GFraMe_util_floor_div(int n, int d) {
+	if (n >= 0)
+		return n / d;
+	return -((-n + d - 1) / d);
+}
+
+/**
+ * Super complex integration routine, in fixed point
+ * @param	val	Value to be integrated
+ * @param	time	Time the value should be integrated
+ */
+GFraMe_fixed GFraMe_util_integratex(GFraMe_fixed val, GFraMe_fixed time) {
+	// Use Euler! (lol)
+	return GFraMe_fixed_mul(val, time);
+}
+
+/**
+ * Return the absolute of a fixed point
+ * @param	val	Value to have its absolute computed
+ * @return	Absolute value computed
+ */
+GFraMe_fixed GFraMe_util_absx(GFraMe_fixed val) {
+	// If it's positive, simply return the number
+	if (val >= 0)
+		return val;
+	// Otherwise, negate it (avoiding overflow) and return
+	if (val == GFRAME_FIXED_MIN)
+		return GFRAME_FIXED_MAX;
+	return -val;
+}
+
+/**
+ * Divide two fixed points; the result is saturated, if it doesn't fit
+ * @param	a	The dividend
+ * @param	b	The divisor (mustn't be 0)
+ * @return	The quotient
+ */
+GFraMe_fixed GFraMe_util_divx(GFraMe_fixed a, GFraMe_fixed b) {
+	int64_t res;
+	
+	res = ((int64_t)a * GFRAME_FIXED_ONE) / b;
+	if (res > GFRAME_FIXED_MAX)
+		return GFRAME_FIXED_MAX;
+	if (res < GFRAME_FIXED_MIN)
+		return GFRAME_FIXED_MIN;
+	return (GFraMe_fixed)res;
+}
+
+/**
+ * Interpolate linearly between two number, in fixed point
+ */
+GFraMe_fixed GFraMe_util_lerpx(int a, int b, GFraMe_fixed time) {
+	return GFraMe_fixed_from_int(a) +
+		(GFraMe_fixed)(((int64_t)(b - a) * time));
+}
+
 /**
  * Get the directory to this application's local files. It's set according to
  *the organization and title set when initializing the game. The actual
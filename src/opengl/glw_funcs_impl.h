@@ -19,6 +19,7 @@ static PFNGLENABLEVERTEXATTRIBARRAYPROC glEnableVertexAttribArray;
 static PFNGLVERTEXATTRIBPOINTERPROC glVertexAttribPointer;
 static PFNGLGENBUFFERSPROC glGenBuffers;
 static PFNGLBUFFERDATAPROC glBufferData;
+static PFNGLBUFFERSUBDATAPROC glBufferSubData;
 static PFNGLGENVERTEXARRAYSPROC glGenVertexArrays;
 static PFNGLGENFRAMEBUFFERSPROC glGenFramebuffers;
 static PFNGLFRAMEBUFFERTEXTURE2DPROC glFramebufferTexture2D;
@@ -38,5 +39,9 @@ static PFNGLCOMPILESHADERPROC glCompileShader;
 static PFNGLGETSHADERIVPROC glGetShaderiv;
 static PFNGLGETSHADERINFOLOGPROC glGetShaderInfoLog;
 static PFNGLVALIDATEPROGRAMPROC glValidateProgram;
+#  if defined(GLW_INSTANCED)
+static PFNGLVERTEXATTRIBDIVISORPROC glVertexAttribDivisor;
+static PFNGLDRAWELEMENTSINSTANCEDPROC glDrawElementsInstanced;
+#  endif
 #endif
 
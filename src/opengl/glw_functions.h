@@ -27,6 +27,7 @@ static void glw_loadFunctions() {
 	LOAD_PROC(PFNGLVERTEXATTRIBPOINTERPROC, glVertexAttribPointer);
 	LOAD_PROC(PFNGLGENBUFFERSPROC, glGenBuffers);
 	LOAD_PROC(PFNGLBUFFERDATAPROC, glBufferData);
+	LOAD_PROC(PFNGLBUFFERSUBDATAPROC, glBufferSubData);
 	LOAD_PROC(PFNGLGENVERTEXARRAYSPROC, glGenVertexArrays);
 	LOAD_PROC(PFNGLGENFRAMEBUFFERSPROC, glGenFramebuffers);
 	LOAD_PROC(PFNGLFRAMEBUFFERTEXTURE2DPROC, glFramebufferTexture2D);
@@ -46,6 +47,10 @@ static void glw_loadFunctions() {
 	LOAD_PROC(PFNGLGETSHADERIVPROC, glGetShaderiv);
 	LOAD_PROC(PFNGLGETSHADERINFOLOGPROC, glGetShaderInfoLog);
 	LOAD_PROC(PFNGLVALIDATEPROGRAMPROC, glValidateProgram);
+#if defined(GLW_INSTANCED)
+	LOAD_PROC(PFNGLVERTEXATTRIBDIVISORPROC, glVertexAttribDivisor);
+	LOAD_PROC(PFNGLDRAWELEMENTSINSTANCEDPROC, glDrawElementsInstanced);
+#endif
 }
 
 static GLuint compileShader(GLenum eShaderType,
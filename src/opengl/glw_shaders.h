@@ -1,22 +1,25 @@
 
-static char sprVs[] = 
+#if defined(GLW_INSTANCED)
+static char sprVs_instanced[] = 
   "#version 330\n"
   "layout(location = 0) in vec2 vtx;\n"
+  "layout(location = 1) in vec2 translation;\n"
+  "layout(location = 2) in vec2 dimensions;\n"
+  "layout(location = 3) in vec2 texOffset;\n"
+  "layout(location = 4) in vec2 scale;\n"
+  "layout(location = 5) in vec2 rotation;\n"
+  "layout(location = 6) in float instAlpha;\n"
   "out vec2 texCoord;\n"
+  "out float alpha;\n"
   "uniform mat4 locToGL;\n"
   "uniform vec2 texDimensions;\n"
-  "uniform vec2 rotation;\n"
-  "uniform vec2 scale;\n"
-  "uniform vec2 translation;\n"
-  "uniform vec2 dimensions;\n"
-  "uniform vec2 texOffset;\n"
   "void main() {\n"
-  "  mat2 rot = mat2(rotation.x, -rotation.y,"
-  "                  rotation.y, rotation.x);\n"
+  "  mat2 rot = mat2(rotation.x, rotation.y,"
+  "                  -rotation.y, rotation.x);\n"
   "  vec2 pos = vtx;\n"
   "  pos *= dimensions;\n"
   "  pos *= scale;\n"
-  //"  pos *= rot;\n"
+  "  pos = rot*pos;\n"
   "  pos += dimensions*vec2(0.5f,"
   "                            0.5f);\n"
   "  pos += translation;\n"
@@ -26,17 +29,35 @@ static char sprVs[] =
   
   "  vec2 _texCoord = vtx + vec2(0.5f,"
                              "0.5f);\n"
-  "  _texCoord *= texDimensions;\n"
   "  _texCoord *= dimensions;\n"
-  "  texCoord = texDimensions*texOffset"
-  "                +_texCoord;\n"
+  "  texCoord = (texOffset + _texCoord)"
+  "                *texDimensions;\n"
+  "  alpha = instAlpha;\n"
+  "}\n";
+#else
+static char sprVs[] = 
+  "#version 330\n"
+  "layout(location = 0) in vec2 vtx;\n"
+  "layout(location = 1) in vec2 uv;\n"
+  "layout(location = 2) in float vtxAlpha;\n"
+  "out vec2 texCoord;\n"
+  "out float alpha;\n"
+  "uniform mat4 locToGL;\n"
+  "uniform vec2 texDimensions;\n"
+  "void main() {\n"
+  "  vec4 position = vec4(vtx.x, vtx.y,"
+  "                     -1.0f, 1.0f);\n"
+  "  gl_Position = position*locToGL;\n"
+  "  texCoord = uv*texDimensions;\n"
+  "  alpha = vtxAlpha;\n"
   "}\n";
+#endif
 
 static char sprFs[] = 
   "#version 330\n"
   "in vec2 texCoord;\n"
+  "in float alpha;\n"
   "uniform sampler2D gSampler;\n"
-  "uniform float alpha;\n"
   "void main() {\n"
   "  gl_FragColor = texture2D(gSampler, texCoord.st);\n"
   "  gl_FragColor.a *= alpha;\n"
@@ -0,0 +1,274 @@
+/**
+ * @file glw_state.h
+ * 
+ * Cached binds and state changes used by opengl_wrapper.c (over the shadows
+ *declared on glw_static.h). Calls that wouldn't change anything never reach
+ *the driver; each call is counted as either issued or elided.
+ * The shadows assume the wrapper is the only one making GL calls on the
+ *context; if anything else does, glw_invalidateState must be called before
+ *the wrapper renders again
+ * 
+ * @author GFM
+ */
+#ifndef __GLW_STATE_H_
+#define __GLW_STATE_H_
+
+/**
+ * Value of a binding that isn't known (so the next bind is always issued)
+ */
+#define GLW_UNKNOWN ((GLuint)-1)
+
+/**
+ * Set the shadows to the state of a newly created context
+ */
+static void glw_resetState(GLint *viewport) {
+	int i;
+	
+	stPrg = 0;
+	stTexUnit = GL_TEXTURE0;
+	i = 0;
+	while (i < GLW_TEX_UNITS)
+		stTex[i++] = 0;
+	stVao = 0;
+	stArrayBuf = 0;
+	stElementBuf = 0;
+	stFbo = 0;
+	stBlend = GFraMe_blend_alpha;
+	i = 0;
+	while (i < 4) {
+		stViewport[i] = viewport[i];
+		i++;
+	}
+	memset(stAttribs, 0x0, sizeof(stAttribs));
+	memset(stUniforms, 0x0, sizeof(stUniforms));
+	stNumUniforms = 0;
+	stIssued = 0;
+	stElided = 0;
+	stDraws = 0;
+}
+
+/**
+ * Set every shadow as unknown, so the next call to change each piece of state
+ *is always issued
+ */
+static void glw_forgetState() {
+	int i;
+	
+	stPrg = GLW_UNKNOWN;
+	stTexUnit = GLW_UNKNOWN;
+	i = 0;
+	while (i < GLW_TEX_UNITS)
+		stTex[i++] = GLW_UNKNOWN;
+#if !defined(GFRAME_MOBILE)
+	stVao = GLW_UNKNOWN;
+#else
+	// Vertex arrays aren't used on mobile, so the default one stays bound
+	stVao = 0;
+#endif
+	stArrayBuf = GLW_UNKNOWN;
+	stElementBuf = GLW_UNKNOWN;
+	stFbo = GLW_UNKNOWN;
+	// Not a GFraMe_blend
+	stBlend = -1;
+	// No viewport is ever set with a negative size
+	i = 0;
+	while (i < 4)
+		stViewport[i++] = -1;
+	// Attributes not set are always enabled and pointed again
+	memset(stAttribs, 0x0, sizeof(stAttribs));
+	stNumUniforms = 0;
+}
+
+static void glw_useProgram(GLuint prg) {
+	if (prg == stPrg) {
+		stElided++;
+		return;
+	}
+	glUseProgram(prg);
+	stPrg = prg;
+	stIssued++;
+}
+
+static void glw_activeTexture(GLenum unit) {
+	if (unit == stTexUnit) {
+		stElided++;
+		return;
+	}
+	glActiveTexture(unit);
+	stTexUnit = unit;
+	stIssued++;
+}
+
+/**
+ * Bind a 2D texture to the active unit
+ */
+static void glw_bindTexture(GLuint tex) {
+	GLuint *cur = NULL;
+	
+	if (stTexUnit - GL_TEXTURE0 < GLW_TEX_UNITS)
+		cur = stTex + (stTexUnit - GL_TEXTURE0);
+	if (cur && *cur == tex) {
+		stElided++;
+		return;
+	}
+	glBindTexture(GL_TEXTURE_2D, tex);
+	if (cur)
+		*cur = tex;
+	stIssued++;
+}
+
+#if !defined(GFRAME_MOBILE)
+static void glw_bindVertexArray(GLuint vao) {
+	if (vao == stVao) {
+		stElided++;
+		return;
+	}
+	glBindVertexArray(vao);
+	stVao = vao;
+	// The element buffer is part of the vertex array
+	stElementBuf = GLW_UNKNOWN;
+	stIssued++;
+}
+#endif
+
+static void glw_bindBuffer(GLenum target, GLuint buf) {
+	GLuint *cur;
+	
+	if (target == GL_ARRAY_BUFFER)
+		cur = &stArrayBuf;
+	else
+		cur = &stElementBuf;
+	if (*cur == buf) {
+		stElided++;
+		return;
+	}
+	glBindBuffer(target, buf);
+	*cur = buf;
+	stIssued++;
+}
+
+static void glw_bindFramebuffer(GLuint fbo) {
+	if (fbo == stFbo) {
+		stElided++;
+		return;
+	}
+	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	stFbo = fbo;
+	stIssued++;
+}
+
+static void glw_viewport(GLint x, GLint y, GLsizei w, GLsizei h) {
+	if (x == stViewport[0] && y == stViewport[1] && w == stViewport[2] &&
+	    h == stViewport[3]) {
+		stElided++;
+		return;
+	}
+	glViewport(x, y, w, h);
+	stViewport[0] = x;
+	stViewport[1] = y;
+	stViewport[2] = w;
+	stViewport[3] = h;
+	stIssued++;
+}
+
+/**
+ * Enable an attribute; only shadowed on the default vertex array (other
+ *arrays are only set up once)
+ */
+static void glw_enableAttrib(GLuint idx) {
+	if (stVao == 0 && idx < GLW_ATTRIBS) {
+		if (stAttribs[idx].enabled) {
+			stElided++;
+			return;
+		}
+		stAttribs[idx].enabled = 1;
+	}
+	glEnableVertexAttribArray(idx);
+	stIssued++;
+}
+
+/**
+ * Point an attribute to the bound array buffer; only shadowed on the default
+ *vertex array
+ */
+static void glw_attribPointer(GLuint idx, GLint size, GLenum type,
+	GLboolean norm, GLsizei stride, const void *ptr) {
+	if (stVao == 0 && idx < GLW_ATTRIBS) {
+		glw_attrib *attr = stAttribs + idx;
+		
+		if (attr->set && attr->buf == stArrayBuf && attr->size == size &&
+		    attr->type == type && attr->norm == norm &&
+		    attr->stride == stride && attr->ptr == ptr) {
+			stElided++;
+			return;
+		}
+		attr->set = 1;
+		attr->buf = stArrayBuf;
+		attr->size = size;
+		attr->type = type;
+		attr->norm = norm;
+		attr->stride = stride;
+		attr->ptr = ptr;
+	}
+	glVertexAttribPointer(idx, size, type, norm, stride, ptr);
+	stIssued++;
+}
+
+/**
+ * Get the shadow of a uniform on the current program (NULL, if there are too
+ *many)
+ */
+static glw_uniform* glw_getUniform(GLint loc) {
+	glw_uniform *uni;
+	int i;
+	
+	i = 0;
+	while (i < stNumUniforms) {
+		uni = stUniforms + i;
+		if (uni->prg == stPrg && uni->loc == loc)
+			return uni;
+		i++;
+	}
+	if (stNumUniforms >= GLW_UNIFORMS)
+		return NULL;
+	uni = stUniforms + stNumUniforms;
+	stNumUniforms++;
+	uni->prg = stPrg;
+	uni->loc = loc;
+	uni->set = 0;
+	return uni;
+}
+
+static void glw_uniform1i(GLint loc, GLint v) {
+	glw_uniform *uni = glw_getUniform(loc);
+	
+	if (uni && uni->set && uni->i == v) {
+		stElided++;
+		return;
+	}
+	glUniform1i(loc, v);
+	if (uni) {
+		uni->set = 1;
+		uni->i = v;
+	}
+	stIssued++;
+}
+
+static void glw_uniform2f(GLint loc, GLfloat x, GLfloat y) {
+	glw_uniform *uni = glw_getUniform(loc);
+	
+	if (uni && uni->set && uni->f[0] == x && uni->f[1] == y) {
+		stElided++;
+		return;
+	}
+	glUniform2f(loc, x, y);
+	if (uni) {
+		uni->set = 1;
+		uni->f[0] = x;
+		uni->f[1] = y;
+	}
+	stIssued++;
+}
+
+#endif
+
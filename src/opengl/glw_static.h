@@ -24,13 +24,104 @@ static GLuint sprTex;
 static GLuint sprPrg;
 static GLuint sprLocToGL;
 static GLuint sprTexDimensions;
-static GLuint sprTranslation;
-static GLuint sprRotation;
-static GLuint sprScale;
-static GLuint sprDimensions;
-static GLuint sprTexOffset;
 static GLuint sprSampler;
-static GLuint sprAlpha;
+
+/**
+ * How many sprites fit a batch (so every vertex can be indexed by a short)
+ */
+#define GLW_BATCH_QUADS 16384
+
+#if !defined(GLW_INSTANCED)
+/**
+ * A sprite's corner, as streamed to sprVbo
+ */
+typedef struct {
+	GLfloat x;
+	GLfloat y;
+	GLfloat u;
+	GLfloat v;
+	GLfloat alpha;
+} glw_vertex;
+
+static glw_vertex *batVtx;
+#else
+/**
+ * A sprite, as streamed to instVbo (sprVbo holds the quad shared by every
+ *instance); 32 bytes
+ */
+typedef struct {
+	GLfloat x;
+	GLfloat y;
+	GLushort w;
+	GLushort h;
+	GLushort tx;
+	GLushort ty;
+	GLfloat sx;
+	GLfloat sy;
+	/** Rotation's cosine and sine, normalized */
+	GLshort rc;
+	GLshort rs;
+	/** Alpha, normalized */
+	GLubyte alpha;
+	GLubyte pad[3];
+} glw_instance;
+
+static glw_instance *batInst;
+static GLuint instVbo;
+#endif
+static int batLen;
+static GLfloat batScaleX = 1.0f;
+static GLfloat batScaleY = 1.0f;
+static GLfloat batAlpha = 1.0f;
+
+/**
+ * How many texture units, attributes and uniforms are shadowed
+ */
+#define GLW_TEX_UNITS 4
+#define GLW_ATTRIBS 8
+#define GLW_UNIFORMS 16
+
+/**
+ * Shadow of an attribute on the default vertex array (the only one whose
+ *pointers are set while rendering)
+ */
+typedef struct {
+	int enabled;
+	int set;
+	GLuint buf;
+	GLint size;
+	GLenum type;
+	GLboolean norm;
+	GLsizei stride;
+	const void *ptr;
+} glw_attrib;
+
+/**
+ * Shadow of a uniform on a program
+ */
+typedef struct {
+	GLuint prg;
+	GLint loc;
+	int set;
+	GLint i;
+	GLfloat f[2];
+} glw_uniform;
+
+static int stIssued;
+static int stElided;
+static int stDraws;
+static GLuint stPrg;
+static GLenum stTexUnit;
+static GLuint stTex[GLW_TEX_UNITS];
+static GLuint stVao;
+static GLuint stArrayBuf;
+static GLuint stElementBuf;
+static GLuint stFbo;
+static int stBlend;
+static GLint stViewport[4];
+static glw_attrib stAttribs[GLW_ATTRIBS];
+static glw_uniform stUniforms[GLW_UNIFORMS];
+static int stNumUniforms;
 
 static GLuint bbVbo;
 static GLuint bbIbo;
@@ -6,14 +6,17 @@
 #endif
 #include <GFraMe/GFraMe_screen.h>
 #include <GFraMe/GFraMe_log.h>
+#include <GFraMe/GFraMe_renderqueue.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "opengl_wrapper.h"
 // import a few functions implementations (and variable declarations),
 //to keep this source clean
 #include "glw_functions.h"
 #include "glw_static.h"
 #include "glw_shaders.h"
+#include "glw_state.h"
 
 void glw_setAttr() {
 	SDL_GL_SetAttribute(SDL_GL_RED_SIZE, 5);
@@ -41,6 +44,7 @@ GLW_RV glw_createCtx(SDL_Window *wnd) {
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 	
 	glGetIntegerv(GL_VIEWPORT, vp);
+	glw_resetState(vp);
 	
 	GFraMe_new_log(
 "=============================\n"
@@ -56,7 +60,11 @@ GLW_RV glw_createCtx(SDL_Window *wnd) {
 }
 
 GLW_RV glw_compileProgram(int use_scanlines) {
+#if !defined(GLW_INSTANCED)
 	char *sprShd[2] = {sprVs, sprFs};
+#else
+	char *sprShd[2] = {sprVs_instanced, sprFs};
+#endif
 	char *bbShd[2] = {bbVs, bbFs};
 	GLenum types[2] = {GL_VERTEX_SHADER, GL_FRAGMENT_SHADER};
 	
@@ -73,13 +81,7 @@ GLW_RV glw_compileProgram(int use_scanlines) {
 	
 	sprLocToGL = glGetUniformLocation(sprPrg, "locToGL");
 	sprTexDimensions = glGetUniformLocation(sprPrg,"texDimensions");
-	sprTranslation = glGetUniformLocation(sprPrg, "translation");
-	sprRotation = glGetUniformLocation(sprPrg, "rotation");
-	sprScale = glGetUniformLocation(sprPrg, "scale");
-	sprDimensions = glGetUniformLocation(sprPrg, "dimensions");
-	sprTexOffset = glGetUniformLocation(sprPrg, "texOffset");
 	sprSampler = glGetUniformLocation(sprPrg, "gSampler");
-	sprAlpha = glGetUniformLocation(sprPrg, "alpha");
 	
 	bbSampler = glGetUniformLocation(bbPrg, "gSampler");
 	bbTexDimensions = glGetUniformLocation(bbPrg, "texDimensions");
@@ -87,44 +89,180 @@ GLW_RV glw_compileProgram(int use_scanlines) {
 	return GLW_SUCCESS;
 }
 
-GLW_RV glw_createSprite(int width, int height, char *data) {
+#if defined(GLW_INSTANCED)
+/**
+ * Point the instance attributes to the sprites on instVbo (which must be
+ *bound)
+ */
+static void glw_setInstanceAttribs() {
+	GLsizei stride = sizeof(glw_instance);
+	int i;
+	
+	glw_attribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (void*)0);
+	glw_attribPointer(2, 2, GL_UNSIGNED_SHORT, GL_FALSE, stride,
+	                  (void*)8);
+	glw_attribPointer(3, 2, GL_UNSIGNED_SHORT, GL_FALSE, stride,
+	                  (void*)12);
+	glw_attribPointer(4, 2, GL_FLOAT, GL_FALSE, stride, (void*)16);
+	glw_attribPointer(5, 2, GL_SHORT, GL_TRUE, stride, (void*)24);
+	glw_attribPointer(6, 1, GL_UNSIGNED_BYTE, GL_TRUE, stride,
+	                  (void*)28);
+	i = 1;
+	while (i <= 6) {
+		glw_enableAttrib(i);
+		glVertexAttribDivisor(i, 1);
+		i++;
+	}
+}
+
+/**
+ * Create the unit quad shared by every sprite and the buffer the sprites are
+ *streamed to
+ */
+static GLW_RV glw_createSpriteBuffers() {
 	float vbo_data[] = {-0.5f,-0.5f, -0.5f,0.5f, 0.5f,0.5f, 0.5f,-0.5f};
 	GLshort ibo_data[] = {0,1,2, 2,3,0};
 	
+	batInst = (glw_instance*)malloc(sizeof(glw_instance) * GLW_BATCH_QUADS);
+	if (!batInst)
+		return GLW_FAILURE;
+	batLen = 0;
+	
 	sprVbo = 0;
 	glGenBuffers(1, &sprVbo);
 	if (sprVbo == 0)
 		return GLW_FAILURE;
-	glBindBuffer(GL_ARRAY_BUFFER, sprVbo);
+	glw_bindBuffer(GL_ARRAY_BUFFER, sprVbo);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(vbo_data), vbo_data, GL_STATIC_DRAW);
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glw_bindBuffer(GL_ARRAY_BUFFER, 0);
 	
 	sprIbo = 0;
 	glGenBuffers(1, &sprIbo);
 	if (sprIbo == 0)
 		return GLW_FAILURE;
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, sprIbo);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(ibo_data), ibo_data, GL_STATIC_DRAW);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	glw_bindBuffer(GL_ELEMENT_ARRAY_BUFFER, sprIbo);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(ibo_data), ibo_data,
+	             GL_STATIC_DRAW);
+	glw_bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	
+	instVbo = 0;
+	glGenBuffers(1, &instVbo);
+	if (instVbo == 0)
+		return GLW_FAILURE;
+	glw_bindBuffer(GL_ARRAY_BUFFER, instVbo);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(glw_instance) * GLW_BATCH_QUADS, NULL,
+	             GL_STREAM_DRAW);
+	glw_bindBuffer(GL_ARRAY_BUFFER, 0);
+	
+	sprVao = 0;
+	glGenVertexArrays(1, &sprVao);
+	if (sprVao == 0)
+		return GLW_FAILURE;
+	glw_bindVertexArray(sprVao);
+	glw_enableAttrib(0);
+	glw_bindBuffer(GL_ARRAY_BUFFER, sprVbo);
+	glw_bindBuffer(GL_ELEMENT_ARRAY_BUFFER, sprIbo);
+	glw_attribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, 0);
+	glw_bindBuffer(GL_ARRAY_BUFFER, instVbo);
+	glw_setInstanceAttribs();
+	glw_bindVertexArray(0);
+	
+	return GLW_SUCCESS;
+}
+#else
+/**
+ * Point the sprite attributes to the vertices on sprVbo (which must be bound)
+ */
+static void glw_setSpriteAttribs() {
+	glw_enableAttrib(0);
+	glw_enableAttrib(1);
+	glw_enableAttrib(2);
+	glw_attribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(glw_vertex),
+	                  (void*)0);
+	glw_attribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(glw_vertex),
+	                  (void*)(2 * sizeof(GLfloat)));
+	glw_attribPointer(2, 1, GL_FLOAT, GL_FALSE, sizeof(glw_vertex),
+	                  (void*)(4 * sizeof(GLfloat)));
+}
+
+/**
+ * Create the buffers the sprites are streamed to
+ */
+static GLW_RV glw_createSpriteBuffers() {
+	GLushort *ibo_data;
+	int i;
+	
+	// Sprites are expanded into this buffer and streamed to sprVbo
+	batVtx = (glw_vertex*)malloc(sizeof(glw_vertex) * 4 * GLW_BATCH_QUADS);
+	if (!batVtx)
+		return GLW_FAILURE;
+	batLen = 0;
+	
+	sprVbo = 0;
+	glGenBuffers(1, &sprVbo);
+	if (sprVbo == 0)
+		return GLW_FAILURE;
+	glw_bindBuffer(GL_ARRAY_BUFFER, sprVbo);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(glw_vertex) * 4 * GLW_BATCH_QUADS,
+	             NULL, GL_STREAM_DRAW);
+	glw_bindBuffer(GL_ARRAY_BUFFER, 0);
+	
+	// The indices never change, so every quad is set only once
+	ibo_data = (GLushort*)malloc(sizeof(GLushort) * 6 * GLW_BATCH_QUADS);
+	if (!ibo_data)
+		return GLW_FAILURE;
+	i = 0;
+	while (i < GLW_BATCH_QUADS) {
+		GLushort *idx = ibo_data + i * 6;
+		GLushort vtx = (GLushort)(i * 4);
+		
+		idx[0] = vtx;
+		idx[1] = vtx + 1;
+		idx[2] = vtx + 2;
+		idx[3] = vtx + 2;
+		idx[4] = vtx + 3;
+		idx[5] = vtx;
+		i++;
+	}
+	
+	sprIbo = 0;
+	glGenBuffers(1, &sprIbo);
+	if (sprIbo == 0) {
+		free(ibo_data);
+		return GLW_FAILURE;
+	}
+	glw_bindBuffer(GL_ELEMENT_ARRAY_BUFFER, sprIbo);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+	             sizeof(GLushort) * 6 * GLW_BATCH_QUADS, ibo_data,
+	             GL_STATIC_DRAW);
+	glw_bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	free(ibo_data);
 	
 #if !defined(GFRAME_MOBILE)
 	sprVao = 0;
 	glGenVertexArrays(1, &sprVao);
 	if (sprVao == 0)
 		return GLW_FAILURE;
-	glBindVertexArray(sprVao);
-	glEnableVertexAttribArray(0);
-	glBindBuffer(GL_ARRAY_BUFFER, sprVbo);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, sprIbo);
-	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, 0);
-	glBindVertexArray(0);
+	glw_bindVertexArray(sprVao);
+	glw_bindBuffer(GL_ARRAY_BUFFER, sprVbo);
+	glw_bindBuffer(GL_ELEMENT_ARRAY_BUFFER, sprIbo);
+	glw_setSpriteAttribs();
+	glw_bindVertexArray(0);
 #endif
 	
+	return GLW_SUCCESS;
+}
+#endif
+
+GLW_RV glw_createSprite(int width, int height, char *data) {
+	if (glw_createSpriteBuffers() != GLW_SUCCESS)
+		return GLW_FAILURE;
+	
 	sprTex = 0;
 	glGenTextures(1, &sprTex);
 	if (sprTex == 0)
 		return GLW_FAILURE;
-	glBindTexture(GL_TEXTURE_2D, sprTex);
+	glw_bindTexture(sprTex);
 	glTexImage2D(GL_TEXTURE_2D,
 	             0,
 	             GL_RGBA,
@@ -136,14 +274,11 @@ GLW_RV glw_createSprite(int width, int height, char *data) {
 	             data);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glBindTexture(GL_TEXTURE_2D, 0);
+	glw_bindTexture(0);
 	
-	glUseProgram(sprPrg);
-	glUniform2f(sprTexDimensions, 1.0f / (float)width, 1.0f / (float)height);
-	glUniform2f(sprRotation, 1.0f, 0.0f);
-	glUniform2f(sprScale, 1.0f, 1.0f);
-	glUniform1f(sprAlpha, 1.0f);
-	glUseProgram(0);
+	glw_useProgram(sprPrg);
+	glw_uniform2f(sprTexDimensions, 1.0f / (float)width, 1.0f / (float)height);
+	glw_useProgram(0);
 	
 	return GLW_SUCCESS;
 }
@@ -157,36 +292,36 @@ GLW_RV glw_createBackbuffer(int width, int height, int sX, int sY) {
 	glGenBuffers(1, &bbVbo);
 	if (bbVbo == 0)
 		return GLW_FAILURE;
-	glBindBuffer(GL_ARRAY_BUFFER, bbVbo);
+	glw_bindBuffer(GL_ARRAY_BUFFER, bbVbo);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(vbo_data), vbo_data, GL_STATIC_DRAW);
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glw_bindBuffer(GL_ARRAY_BUFFER, 0);
 	
 	bbIbo = 0;
 	glGenBuffers(1, &bbIbo);
 	if (bbIbo == 0)
 		return GLW_FAILURE;
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, bbIbo);
+	glw_bindBuffer(GL_ELEMENT_ARRAY_BUFFER, bbIbo);
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(ibo_data), ibo_data, GL_STATIC_DRAW);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	glw_bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 	
 #if !defined(GFRAME_MOBILE)
 	bbVao = 0;
 	glGenVertexArrays(1, &bbVao);
 	if (bbVao == 0)
 		return GLW_FAILURE;
-	glBindVertexArray(bbVao);
-	glEnableVertexAttribArray(0);
-	glBindBuffer(GL_ARRAY_BUFFER, bbVbo);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, bbIbo);
-	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, 0);
-	glBindVertexArray(0);
+	glw_bindVertexArray(bbVao);
+	glw_enableAttrib(0);
+	glw_bindBuffer(GL_ARRAY_BUFFER, bbVbo);
+	glw_bindBuffer(GL_ELEMENT_ARRAY_BUFFER, bbIbo);
+	glw_attribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, 0);
+	glw_bindVertexArray(0);
 #endif
 	
 	bbTex = 0;
 	glGenTextures(1, &bbTex);
 	if (bbTex == 0)
 		return GLW_FAILURE;
-	glBindTexture(GL_TEXTURE_2D, bbTex);
+	glw_bindTexture(bbTex);
 #if !defined(GFRAME_MOBILE)
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
@@ -205,112 +340,242 @@ GLW_RV glw_createBackbuffer(int width, int height, int sX, int sY) {
 	             GL_RGBA,
 	             GL_UNSIGNED_BYTE,
 	             NULL);
-	glBindTexture(GL_TEXTURE_2D, 0);
+	glw_bindTexture(0);
 	
 	bbFbo = 0;
 	glGenFramebuffers(1, &bbFbo);
 	if (bbFbo == 0)
 		return GLW_FAILURE;
-	glBindFramebuffer(GL_FRAMEBUFFER, bbFbo);
+	glw_bindFramebuffer(bbFbo);
 	glFramebufferTexture2D(GL_FRAMEBUFFER,
 	                       GL_COLOR_ATTACHMENT0,
 	                       GL_TEXTURE_2D,
 	                       bbTex,
 	                       0);
 	status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	glw_bindFramebuffer(0);
 	if (status != GL_FRAMEBUFFER_COMPLETE)
 		return GLW_FAILURE;
 	
 	worldMatrix[0] = 2.0f / (float)width;
 	worldMatrix[5] = -2.0f / (float)height;
 	
-	glUseProgram(sprPrg);
+	glw_useProgram(sprPrg);
 	glUniformMatrix4fv(sprLocToGL, 1, GL_FALSE, worldMatrix);
-	glUseProgram(bbPrg);
-	glUniform2f(bbTexDimensions, 1.0f / (float)width, 1.0f / (float)height);
-	glUseProgram(0);
+	glw_useProgram(bbPrg);
+	glw_uniform2f(bbTexDimensions, 1.0f / (float)width, 1.0f / (float)height);
+	glw_useProgram(0);
 	
 	return GLW_SUCCESS;
 }
 
 void glw_prepareRender() {
-	glBindFramebuffer(GL_FRAMEBUFFER, bbFbo);
+	glw_bindFramebuffer(bbFbo);
 	glClear(GL_COLOR_BUFFER_BIT);
 	
-	glUseProgram(sprPrg);
-	glViewport(0, 0, GFraMe_screen_w, GFraMe_screen_h);
+	glw_useProgram(sprPrg);
+	glw_viewport(0, 0, GFraMe_screen_w, GFraMe_screen_h);
 	
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, sprTex);
-	glUniform1i(sprSampler, 0);
+	glw_activeTexture(GL_TEXTURE0);
+	glw_bindTexture(sprTex);
+	glw_uniform1i(sprSampler, 0);
 	
-#if !defined(GFRAME_MOBILE)
-	glBindVertexArray(sprVao);
+#if defined(GLW_INSTANCED)
+	glw_bindVertexArray(sprVao);
+	glw_bindBuffer(GL_ARRAY_BUFFER, instVbo);
+#elif !defined(GFRAME_MOBILE)
+	glw_bindVertexArray(sprVao);
+	glw_bindBuffer(GL_ARRAY_BUFFER, sprVbo);
+#else
+	glw_bindBuffer(GL_ARRAY_BUFFER, sprVbo);
+	glw_bindBuffer(GL_ELEMENT_ARRAY_BUFFER, sprIbo);
+	glw_setSpriteAttribs();
+#endif
+	batLen = 0;
+}
+
+/**
+ * Draw every sprite on the batch; the buffer is orphaned first, so the driver
+ *doesn't have to wait for the previous draw to finish reading it
+ */
+static void glw_flush() {
+	if (batLen == 0)
+		return;
+	
+#if defined(GLW_INSTANCED)
+	glw_bindBuffer(GL_ARRAY_BUFFER, instVbo);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(glw_instance) * GLW_BATCH_QUADS, NULL,
+	             GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(glw_instance) * batLen,
+	                batInst);
+	glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, 0, batLen);
 #else
-	glEnableVertexAttribArray(0);
-	glBindBuffer(GL_ARRAY_BUFFER, sprVbo);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, sprIbo);
-	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, 0);
+	glw_bindBuffer(GL_ARRAY_BUFFER, sprVbo);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(glw_vertex) * 4 * GLW_BATCH_QUADS,
+	             NULL, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(glw_vertex) * 4 * batLen,
+	                batVtx);
+	glDrawElements(GL_TRIANGLES, 6 * batLen, GL_UNSIGNED_SHORT, 0);
 #endif
+	stDraws++;
+	
+	batLen = 0;
 }
 
 void glw_setRotation(float angle) {
-	glUniform2f(sprRotation, 1.0f, 0.0f);
+	// Sprites aren't rotated yet
 }
 
+// Scale and alpha are stored on each vertex, so changing them doesn't break
+// the batch
 void glw_setScale(float sX, float sY) {
-	glUniform2f(sprScale, sX, sY);
+	batScaleX = sX;
+	batScaleY = sY;
 }
 
 void glw_setAlpha(float alpha) {
-	glUniform1f(sprAlpha, alpha);
+	batAlpha = alpha;
+}
+
+void glw_setBlend(int mode) {
+	if (mode == stBlend) {
+		stElided++;
+		return;
+	}
+	// Sprites already on the batch must use the previous mode
+	glw_flush();
+	stBlend = mode;
+	stIssued++;
+	switch (mode) {
+		case GFraMe_blend_add:
+			glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+		break;
+		case GFraMe_blend_mod:
+			glBlendFunc(GL_DST_COLOR, GL_ZERO);
+		break;
+		case GFraMe_blend_none:
+			glBlendFunc(GL_ONE, GL_ZERO);
+		break;
+		default:
+			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	}
 }
 
 void glw_renderSprite(int x, int y, int dx, int dy, int tx, int ty) {
-	glUniform2f(sprTranslation, (float)x, (float)y);
-	glUniform2f(sprDimensions, (float)dx, (float)dy);
-	glUniform2f(sprTexOffset, (float)tx, (float)ty);
-	
-	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, 0);
+#if !defined(GLW_INSTANCED)
+	glw_vertex *vtx;
+	GLfloat cx, cy, hw, hh, u0, v0, u1, v1;
+	
+	if (batLen >= GLW_BATCH_QUADS)
+		glw_flush();
+	
+	// Scale around the sprite's center; a negative scale flips it
+	hw = (GLfloat)dx * batScaleX * 0.5f;
+	hh = (GLfloat)dy * batScaleY * 0.5f;
+	cx = (GLfloat)x + (GLfloat)dx * 0.5f;
+	cy = (GLfloat)y + (GLfloat)dy * 0.5f;
+	u0 = (GLfloat)tx;
+	v0 = (GLfloat)ty;
+	u1 = (GLfloat)(tx + dx);
+	v1 = (GLfloat)(ty + dy);
+	
+	vtx = batVtx + batLen * 4;
+	vtx[0].x = cx - hw;
+	vtx[0].y = cy - hh;
+	vtx[0].u = u0;
+	vtx[0].v = v0;
+	vtx[1].x = cx - hw;
+	vtx[1].y = cy + hh;
+	vtx[1].u = u0;
+	vtx[1].v = v1;
+	vtx[2].x = cx + hw;
+	vtx[2].y = cy + hh;
+	vtx[2].u = u1;
+	vtx[2].v = v1;
+	vtx[3].x = cx + hw;
+	vtx[3].y = cy - hh;
+	vtx[3].u = u1;
+	vtx[3].v = v0;
+	vtx[0].alpha = batAlpha;
+	vtx[1].alpha = batAlpha;
+	vtx[2].alpha = batAlpha;
+	vtx[3].alpha = batAlpha;
+	
+	batLen++;
+#else
+	glw_instance *inst;
+	
+	if (batLen >= GLW_BATCH_QUADS)
+		glw_flush();
+	
+	// The quad is expanded (and scaled around its center) by the shader
+	inst = batInst + batLen;
+	inst->x = (GLfloat)x;
+	inst->y = (GLfloat)y;
+	inst->w = (GLushort)dx;
+	inst->h = (GLushort)dy;
+	inst->tx = (GLushort)tx;
+	inst->ty = (GLushort)ty;
+	inst->sx = batScaleX;
+	inst->sy = batScaleY;
+	inst->rc = 32767;
+	inst->rs = 0;
+	inst->alpha = (GLubyte)(batAlpha * 255.0f);
+	
+	batLen++;
+#endif
 }
 
 void glw_doRender(SDL_Window *wnd) {
-#if !defined(GFRAME_MOBILE)
-	glBindVertexArray(0);
-#endif
-	glUseProgram(0);
+	glw_flush();
 	
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	// Nothing is unbound, as the next bind would be issued anyway
+	glw_bindFramebuffer(0);
 	glClear(GL_COLOR_BUFFER_BIT);
 	
-	glUseProgram(bbPrg);
+	glw_useProgram(bbPrg);
 	//glViewport(0, 0, GFraMe_window_w, GFraMe_window_h);
-	glViewport(GFraMe_buffer_x,
-	           GFraMe_buffer_y,
-	           GFraMe_buffer_w,
-			   GFraMe_buffer_h);
-	
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, bbTex);
-	glUniform1i(bbSampler, 0);
+	glw_viewport(GFraMe_buffer_x,
+	             GFraMe_buffer_y,
+	             GFraMe_buffer_w,
+	             GFraMe_buffer_h);
+	
+	glw_activeTexture(GL_TEXTURE0);
+	glw_bindTexture(bbTex);
+	glw_uniform1i(bbSampler, 0);
 #if !defined(GFRAME_MOBILE)
-	glBindVertexArray(bbVao);
+	glw_bindVertexArray(bbVao);
 #else
-	glEnableVertexAttribArray(0);
-	glBindBuffer(GL_ARRAY_BUFFER, bbVbo);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, bbIbo);
-	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, 0);
+	glw_enableAttrib(0);
+	glw_bindBuffer(GL_ARRAY_BUFFER, bbVbo);
+	glw_bindBuffer(GL_ELEMENT_ARRAY_BUFFER, bbIbo);
+	glw_attribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, 0);
 #endif
 	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, 0);
-#if !defined(GFRAME_MOBILE)
-	glBindVertexArray(0);
-#endif
-	glUseProgram(0);
+	stDraws++;
 	
 	SDL_GL_SwapWindow(wnd);
 }
 
+void glw_getStats(int *issued, int *elided, int *draws) {
+	*issued = stIssued;
+	*elided = stElided;
+	*draws = stDraws;
+}
+
+void glw_resetStats() {
+	stIssued = 0;
+	stElided = 0;
+	stDraws = 0;
+}
+
+void glw_invalidateState() {
+	glw_forgetState();
+	// Blending isn't shadowed (it's only enabled once), but it may have been
+	// disabled as well
+	glEnable(GL_BLEND);
+}
+
 void glw_cleanup() {
 	if (bbTex)
 		glDeleteTextures(1, &bbTex);
@@ -334,6 +599,17 @@ void glw_cleanup() {
 		glDeleteBuffers(1, &sprIbo);
 	if (sprVbo)
 		glDeleteBuffers(1, &sprVbo);
+#if defined(GLW_INSTANCED)
+	if (instVbo)
+		glDeleteBuffers(1, &instVbo);
+	if (batInst)
+		free(batInst);
+	batInst = NULL;
+#else
+	if (batVtx)
+		free(batVtx);
+	batVtx = NULL;
+#endif
 	if (bbPrg)
 		glDeleteProgram(bbPrg);
 	if (sprPrg)
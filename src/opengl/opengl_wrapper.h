@@ -11,6 +11,11 @@
 
 #include <SDL2/SDL.h>
 
+// Instancing requires GL 3.3, so it's only available on desktop
+#if defined(GFRAME_GL_INSTANCED) && !defined(GFRAME_MOBILE)
+#  define GLW_INSTANCED
+#endif
+
 typedef enum {
 	GLW_SUCCESS = 0,
 	GLW_FAILURE
@@ -47,19 +52,42 @@ GLW_RV glw_createBackbuffer(int width, int height, int sX, int sY);
 void glw_prepareRender();
 
 /**
- * Render one sprite to the backbuffer
+ * Queue one sprite on the batch; it's drawn when the blend mode changes, the
+ *batch fills up or the frame ends
  */
 void glw_renderSprite(int x, int y, int dx, int dy, int tx, int ty);
 
 void glw_setRotation(float angle);
 void glw_setScale(float sX, float sY);
 void glw_setAlpha(float alpha);
+/**
+ * Set the blend function (mode is a GFraMe_blend)
+ */
+void glw_setBlend(int mode);
 
 /**
  * Render the backbuffer to the screen
  */
 void glw_doRender();
 
+/**
+ * Get how many state changes reached the driver, how many were skipped (as
+ *they wouldn't change anything) and how many draw calls were made
+ */
+void glw_getStats(int *issued, int *elided, int *draws);
+
+/**
+ * Zero the counters returned by glw_getStats
+ */
+void glw_resetStats();
+
+/**
+ * Forget the GL state shadowed by the wrapper, so every bind and state change
+ *is issued again; must be called after any GL call made outside the wrapper
+ *(e.g., by another library), between frames (i.e., before glw_prepareRender)
+ */
+void glw_invalidateState();
+
 /**
  * Cleanup memory used by this wrapper
  */
@@ -5,6 +5,7 @@
  */
 #include <GFraMe/GFraMe.h>
 #include <GFraMe/GFraMe_accumulator.h>
+#include <GFraMe/GFraMe_animation.h>
 #include <GFraMe/GFraMe_error.h>
 #include <GFraMe/GFraMe_event.h>
 #include <GFraMe/GFraMe_log.h>
@@ -119,6 +120,12 @@ static void clean_assets();
  * Check which event ocurred (necessary for stepping the timer and quitting)
  */
 static void event_handler();
+/**
+ * Check sampling, seeking and updating shared animations against known values
+ * 
+ * return How many checks failed
+ */
+static int check_animdefs();
 
 /**
  * Main function.
@@ -144,6 +151,13 @@ int main (int argc, char *argv[]) {
     rv = init_assets();
     GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to init assets", __ret);
     
+    // Check the shared animations before showing anything
+    if (check_animdefs() != 0) {
+        rv = GFraMe_ret_failed;
+        GFraMe_assertRet(0, "Animation checks failed", __ret);
+    }
+    GFraMe_log("Every animation check passed");
+    
     // Init the sprite and its animations
     GFraMe_sprite_init(&s, (SCR_W - SPR_W) / 2, (SCR_H - SPR_H) / 2, SPR_W,
         SPR_H, &sset8x8, 0, 0);
@@ -236,3 +250,132 @@ static void event_handler() {
     GFraMe_event_end();
 }
 
+/**
+ * Log a failed check and count it
+ */
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            GFraMe_log("Check failed: %s", #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+/**
+ * Check that sampling a definition returns the expected state
+ */
+#define CHECK_SAMPLE(def, t, tile, idx, fin) \
+    do { \
+        int _idx, _fin; \
+        CHECK(GFraMe_animation_sample(def, t, &_idx, &_fin) == (tile)); \
+        CHECK(_idx == (idx) && _fin == (fin)); \
+    } while (0)
+
+/**
+ * Check sampling, seeking and updating shared animations against known values
+ * 
+ * return How many checks failed
+ */
+static int check_animdefs() {
+    // 3 frames of 100ms each
+    static int framesFixed[] = {0, 1, 2};
+    // 3 frames of 50ms, 150ms and 100ms
+    static int framesVar[] = {5, 6, 7};
+    static int durations[] = {50, 150, 100};
+    // 2 frames with the same tile
+    static int framesSame[] = {4, 4};
+    GFraMe_animdef fixedLoop, fixedOnce, varLoop, varOnce, same;
+    GFraMe_animplayer p, q, many[4];
+    GFraMe_ret rv;
+    int changed[4];
+    int failures, t, n;
+    
+    failures = 0;
+    GFraMe_animdef_init(&fixedLoop, 10, framesFixed, 3, 1);
+    GFraMe_animdef_init(&fixedOnce, 10, framesFixed, 3, 0);
+    GFraMe_animdef_init(&same, 10, framesSame, 2, 1);
+    rv = GFraMe_animdef_init_durations(&varLoop, framesVar, durations, 3, 1);
+    CHECK(rv == GFraMe_ret_ok);
+    rv = GFraMe_animdef_init_durations(&varOnce, framesVar, durations, 3, 0);
+    CHECK(rv == GFraMe_ret_ok);
+    CHECK(fixedLoop.total == 300 && varLoop.total == 300);
+    
+    // Frame boundaries
+    CHECK_SAMPLE(&fixedLoop, 0, 0, 0, 0);
+    CHECK_SAMPLE(&fixedLoop, 99, 0, 0, 0);
+    CHECK_SAMPLE(&fixedLoop, 100, 1, 1, 0);
+    CHECK_SAMPLE(&fixedLoop, 299, 2, 2, 0);
+    CHECK_SAMPLE(&varLoop, 49, 5, 0, 0);
+    CHECK_SAMPLE(&varLoop, 50, 6, 1, 0);
+    CHECK_SAMPLE(&varLoop, 199, 6, 1, 0);
+    CHECK_SAMPLE(&varLoop, 200, 7, 2, 0);
+    CHECK_SAMPLE(&varLoop, 299, 7, 2, 0);
+    // Loop boundaries
+    CHECK_SAMPLE(&fixedLoop, 300, 0, 0, 1);
+    CHECK_SAMPLE(&fixedLoop, 650, 0, 0, 2);
+    CHECK_SAMPLE(&varLoop, 300, 5, 0, 1);
+    CHECK_SAMPLE(&varLoop, 350, 6, 1, 1);
+    // Animations that don't loop stop at their last frame
+    CHECK_SAMPLE(&fixedOnce, 299, 2, 2, 0);
+    CHECK_SAMPLE(&fixedOnce, 300, 2, 2, 1);
+    CHECK_SAMPLE(&fixedOnce, 5000, 2, 2, 1);
+    CHECK_SAMPLE(&varOnce, 300, 7, 2, 1);
+    CHECK_SAMPLE(&varOnce, 5000, 7, 2, 1);
+    
+    // Seeking sets how long until the frame ends
+    GFraMe_animplayer_play(&p, &varLoop);
+    GFraMe_animplayer_seek(&p, 0);
+    CHECK(p.index == 0 && p.acc == 50);
+    GFraMe_animplayer_seek(&p, 50);
+    CHECK(p.index == 1 && p.acc == 150);
+    GFraMe_animplayer_seek(&p, 300);
+    CHECK(p.index == 0 && p.num_finished == 1 && p.acc == 50);
+    GFraMe_animplayer_play(&p, &varOnce);
+    GFraMe_animplayer_seek(&p, 300);
+    CHECK(p.index == 2 && p.num_finished == 1 && p.acc == 0);
+    CHECK(GFraMe_animplayer_update(&p, 16) == GFraMe_ret_anim_finished);
+    
+    // Updating (in one big step, which skips whole loops, or in many small
+    // ones) must agree with seeking
+    t = 0;
+    while (t < 2000) {
+        int step;
+        
+        GFraMe_animplayer_play(&p, &varLoop);
+        GFraMe_animplayer_seek(&p, t);
+        GFraMe_animplayer_play(&q, &varLoop);
+        if (t > 0)
+            GFraMe_animplayer_update(&q, t);
+        CHECK(p.index == q.index && p.acc == q.acc &&
+            p.num_finished == q.num_finished);
+        GFraMe_animplayer_play(&q, &varLoop);
+        step = t;
+        while (step > 0) {
+            GFraMe_animplayer_update(&q, step > 7 ? 7 : step);
+            step -= 7;
+        }
+        CHECK(p.index == q.index && p.acc == q.acc &&
+            p.num_finished == q.num_finished);
+        t += 37;
+    }
+    GFraMe_animplayer_play(&q, &fixedOnce);
+    CHECK(GFraMe_animplayer_update(&q, 1000) == GFraMe_ret_anim_finished);
+    CHECK(q.index == 2 && q.num_finished == 1 && q.acc == 0);
+    
+    // Only instances whose tile changed are reported
+    GFraMe_animplayer_play(many, &fixedLoop);
+    GFraMe_animplayer_play(many + 1, &same);
+    GFraMe_animplayer_play(many + 2, NULL);
+    GFraMe_animplayer_play(many + 3, &fixedLoop);
+    GFraMe_animplayer_seek(many + 3, 50);
+    n = GFraMe_animation_update_many(many, 4, 100, changed);
+    CHECK(n == 2 && changed[0] == 0 && changed[1] == 3);
+    CHECK(many[1].index == 1 && many[3].index == 1 && many[3].acc == 50);
+    n = GFraMe_animation_update_many(many, 4, 10, changed);
+    CHECK(n == 0);
+    
+    GFraMe_animdef_clear(&varLoop);
+    GFraMe_animdef_clear(&varOnce);
+    return failures;
+}
+
@@ -224,8 +224,8 @@ int main (int argc, char *argv[]) {
         
         GFraMe_sprite_init(&s1, t->x1, t->y1, t->w1, t->h1, t->sset1, 0, 0);
         s1.cur_tile = t->tile1;
-        GFraMe_sprite_get_object(&s1)->vx = t->vx;
-        GFraMe_sprite_get_object(&s1)->vy = t->vy;
+        GFraMe_sprite_get_object(&s1)->vx = GFraMe_real_from_int(t->vx);
+        GFraMe_sprite_get_object(&s1)->vy = GFraMe_real_from_int(t->vy);
         
         GFraMe_sprite_init(&s2, t->x2, t->y2, t->w2, t->h2, t->sset2, 0, 0);
         s2.cur_tile = t->tile2;
@@ -0,0 +1,401 @@
+/**
+ * @file gframe_test_nav.c
+ *
+ * Check navigation on small hand-built maps: every path found by jump-point
+ * search must cost as much as the one found by a plain Dijkstra, and moving a
+ * flow field's target to a neighbor must give the same distances as
+ * computing the whole field again
+ */
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_log.h>
+#include <GFraMe/GFraMe_nav.h>
+#include <GFraMe/GFraMe_tilemap.h>
+#include <limits.h>
+#include <stdlib.h>
+
+/**
+ * Greatest map's width
+ */
+#define MAX_W 16
+/**
+ * Greatest map's height
+ */
+#define MAX_H 11
+/**
+ * How many times a flow field's target is moved on each map
+ */
+#define NUM_MOVES 200
+
+/**
+ * Maps used for testing ('#' is solid, '.' is free); every row of a map must
+ * be as long, and a map ends on a NULL row
+ */
+static char *maps[][MAX_H + 1] = {
+    // Open room with pillars
+    {
+        "################",
+        "#..............#",
+        "#..##......##..#",
+        "#..##......##..#",
+        "#..............#",
+        "#......##......#",
+        "#......##......#",
+        "#..............#",
+        "#..##......##..#",
+        "#..............#",
+        "################",
+        NULL
+    },
+    // Maze (a single path between most tiles)
+    {
+        "################",
+        "#.#......#.....#",
+        "#.#.####.#.###.#",
+        "#.#.#....#...#.#",
+        "#...#.######.#.#",
+        "#####.#......#.#",
+        "#.....#.####.#.#",
+        "#.#####.#..#...#",
+        "#.......#..#####",
+        "#########......#",
+        "################",
+        NULL
+    },
+    // Two rooms touching only diagonally (corners can't be cut, so there's
+    // no path between them)
+    {
+        "##########",
+        "#....#...#",
+        "#....#...#",
+        "#...#....#",
+        "#...#....#",
+        "##########",
+        NULL
+    },
+    // No walls, so jumps stop on the map's borders
+    {
+        "............",
+        "............",
+        "...#........",
+        "........#...",
+        "............",
+        ".....#......",
+        "............",
+        "............",
+        NULL
+    }
+};
+
+/**
+ * Solid tile types
+ */
+static GFraMe_tile collideable[] = {1};
+/**
+ * Tiles of the current map
+ */
+static GFraMe_tile tiles[MAX_W * MAX_H];
+/**
+ * Distances computed by the reference Dijkstra
+ */
+static int ref[MAX_W * MAX_H];
+/**
+ * Points on a path
+ */
+static int path[2 * MAX_W * MAX_H];
+
+/**
+ * Check whether a tile is free (tiles outside the map aren't)
+ */
+static int is_free(GFraMe_tilemap *tmap, int x, int y);
+/**
+ * Compute every tile's distance to a target with a plain Dijkstra
+ */
+static void dijkstra(GFraMe_tilemap *tmap, int tx, int ty);
+/**
+ * Check every path between every pair of tiles on a map
+ *
+ * return How many checks failed
+ */
+static int check_paths(GFraMe_tilemap *tmap, GFraMe_nav *nav);
+/**
+ * Walk a flow field's target over a map, comparing it to a field computed
+ * from scratch (and to the reference)
+ *
+ * return How many checks failed
+ */
+static int check_flowfield(GFraMe_tilemap *tmap, GFraMe_flowfield *field,
+    GFraMe_flowfield *full);
+
+/**
+ * Main function.
+ *
+ * @param argc Number of arguments
+ * @param argv The actual arguments
+ * @return Error code
+ */
+int main (int argc, char *argv[]) {
+    GFraMe_ret rv;
+    GFraMe_tilemap tmap;
+    GFraMe_nav nav;
+    GFraMe_flowfield field, full;
+    int i, w, h, x, y, failures;
+
+    rv = GFraMe_ret_ok;
+    failures = 0;
+    i = 0;
+    while (i < (int)(sizeof(maps) / sizeof(maps[0]))) {
+        // Convert the map into tiles
+        w = 0;
+        while (maps[i][0][w])
+            w++;
+        h = 0;
+        while (maps[i][h])
+            h++;
+        y = 0;
+        while (y < h) {
+            x = 0;
+            while (x < w) {
+                tiles[x + y * w] = (maps[i][y][x] == '#') ? 1 : 0;
+                x++;
+            }
+            y++;
+        }
+
+        rv = GFraMe_tilemap_init(&tmap, w, h, tiles, NULL, collideable,
+            sizeof(collideable) / sizeof(GFraMe_tile));
+        GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to init tilemap", __ret);
+        rv = GFraMe_nav_init(&nav, &tmap);
+        GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to init nav", __ret);
+        rv = GFraMe_flowfield_init(&field, &tmap);
+        GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to init field", __ret);
+        rv = GFraMe_flowfield_init(&full, &tmap);
+        GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to init field", __ret);
+
+        failures += check_paths(&tmap, &nav);
+        failures += check_flowfield(&tmap, &field, &full);
+        GFraMe_log("Map %i checked (%i failures so far)", i, failures);
+
+        GFraMe_flowfield_clear(&full);
+        GFraMe_flowfield_clear(&field);
+        GFraMe_nav_clear(&nav);
+        GFraMe_tilemap_clear(&tmap);
+        i++;
+    }
+
+    if (failures != 0) {
+        rv = GFraMe_ret_failed;
+        GFraMe_assertRet(0, "Navigation checks failed", __ret);
+    }
+    GFraMe_log("Every navigation check passed");
+__ret:
+    return rv;
+}
+
+/**
+ * Check whether a tile is free (tiles outside the map aren't)
+ */
+static int is_free(GFraMe_tilemap *tmap, int x, int y) {
+    return x >= 0 && y >= 0 && x < tmap->width_in_tiles
+        && y < tmap->height_in_tiles && !GFraMe_tilemap_is_solid(tmap, x, y);
+}
+
+/**
+ * Compute every tile's distance to a target with a plain Dijkstra
+ */
+static void dijkstra(GFraMe_tilemap *tmap, int tx, int ty) {
+    static int done[MAX_W * MAX_H];
+    int w, num, i;
+
+    w = tmap->width_in_tiles;
+    num = w * tmap->height_in_tiles;
+    i = 0;
+    while (i < num) {
+        ref[i] = INT_MAX;
+        done[i] = 0;
+        i++;
+    }
+    ref[tx + ty * w] = 0;
+    while (1) {
+        int cur, dx, dy;
+
+        // Visit the nearest tile not yet visited
+        cur = -1;
+        i = 0;
+        while (i < num) {
+            if (!done[i] && ref[i] != INT_MAX && (cur < 0 || ref[i] < ref[cur]))
+                cur = i;
+            i++;
+        }
+        if (cur < 0)
+            break;
+        done[cur] = 1;
+        dy = -1;
+        while (dy <= 1) {
+            dx = -1;
+            while (dx <= 1) {
+                int x, y, cost;
+
+                x = cur % w + dx;
+                y = cur / w + dy;
+                if ((dx || dy) && is_free(tmap, x, y)
+                    && (!dx || !dy || (is_free(tmap, cur % w + dx, cur / w)
+                        && is_free(tmap, cur % w, cur / w + dy)))) {
+                    cost = (dx && dy) ? GFRAME_NAV_DIAGONAL
+                        : GFRAME_NAV_STRAIGHT;
+                    if (ref[cur] + cost < ref[x + y * w])
+                        ref[x + y * w] = ref[cur] + cost;
+                }
+                dx++;
+            }
+            dy++;
+        }
+    }
+}
+
+/**
+ * Log a failed check and count it
+ */
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            GFraMe_log("Check failed: %s", #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+/**
+ * Check every path between every pair of tiles on a map
+ *
+ * return How many checks failed
+ */
+static int check_paths(GFraMe_tilemap *tmap, GFraMe_nav *nav) {
+    int w, num, goal, start, failures;
+
+    failures = 0;
+    w = tmap->width_in_tiles;
+    num = w * tmap->height_in_tiles;
+    goal = 0;
+    while (goal < num) {
+        int gx, gy;
+
+        gx = goal % w;
+        gy = goal / w;
+        if (!is_free(tmap, gx, gy)) {
+            goal++;
+            continue;
+        }
+        dijkstra(tmap, gx, gy);
+        start = 0;
+        while (start < num) {
+            GFraMe_ret rv;
+            int sx, sy, len, cost, k;
+
+            sx = start % w;
+            sy = start / w;
+            if (!is_free(tmap, sx, sy)) {
+                start++;
+                continue;
+            }
+            rv = GFraMe_nav_find_path(path, &len, MAX_W * MAX_H, nav, sx, sy,
+                gx, gy);
+            if (ref[start] == INT_MAX) {
+                CHECK(rv == GFraMe_ret_failed);
+                start++;
+                continue;
+            }
+            CHECK(rv == GFraMe_ret_ok);
+            if (rv != GFraMe_ret_ok) {
+                start++;
+                continue;
+            }
+            CHECK(len > 0 && path[0] == sx && path[1] == sy);
+            CHECK(len > 0 && path[2 * len - 2] == gx
+                && path[2 * len - 1] == gy);
+            // Walk every line on the path, summing its cost
+            cost = 0;
+            k = 0;
+            while (k + 1 < len) {
+                int x, y, dx, dy;
+
+                x = path[2 * k];
+                y = path[2 * k + 1];
+                dx = (path[2 * k + 2] > x) - (path[2 * k + 2] < x);
+                dy = (path[2 * k + 3] > y) - (path[2 * k + 3] < y);
+                CHECK(x == path[2 * k + 2] || y == path[2 * k + 3]
+                    || abs(path[2 * k + 2] - x) == abs(path[2 * k + 3] - y));
+                while (x != path[2 * k + 2] || y != path[2 * k + 3]) {
+                    CHECK(!dx || !dy || (is_free(tmap, x + dx, y)
+                        && is_free(tmap, x, y + dy)));
+                    x += dx;
+                    y += dy;
+                    CHECK(is_free(tmap, x, y));
+                    cost += (dx && dy) ? GFRAME_NAV_DIAGONAL
+                        : GFRAME_NAV_STRAIGHT;
+                }
+                k++;
+            }
+            CHECK(cost == ref[start]);
+            start++;
+        }
+        goal++;
+    }
+    return failures;
+}
+
+/**
+ * Walk a flow field's target over a map, comparing it to a field computed
+ * from scratch (and to the reference)
+ *
+ * return How many checks failed
+ */
+static int check_flowfield(GFraMe_tilemap *tmap, GFraMe_flowfield *field,
+    GFraMe_flowfield *full) {
+    GFraMe_ret rv;
+    int w, num, tx, ty, move, i, failures;
+
+    failures = 0;
+    w = tmap->width_in_tiles;
+    num = w * tmap->height_in_tiles;
+    // Start on the first free tile
+    i = 0;
+    while (i < num && !is_free(tmap, i % w, i / w))
+        i++;
+    tx = i % w;
+    ty = i / w;
+    rv = GFraMe_flowfield_set_target(field, tx, ty);
+    CHECK(rv == GFraMe_ret_ok);
+
+    // Move the target to a random free neighbor, again and again
+    srand(0);
+    move = 0;
+    while (move < NUM_MOVES) {
+        int dx, dy;
+
+        dx = rand() % 3 - 1;
+        dy = rand() % 3 - 1;
+        if ((!dx && !dy) || !is_free(tmap, tx + dx, ty + dy))
+            continue;
+        tx += dx;
+        ty += dy;
+        rv = GFraMe_flowfield_set_target(field, tx, ty);
+        CHECK(rv == GFraMe_ret_ok);
+        rv = GFraMe_flowfield_set_target(full, tx, ty);
+        CHECK(rv == GFraMe_ret_ok);
+        rv = GFraMe_flowfield_compute(full);
+        CHECK(rv == GFraMe_ret_ok);
+        dijkstra(tmap, tx, ty);
+        i = 0;
+        while (i < num) {
+            int dist;
+
+            dist = GFraMe_flowfield_get_dist(field, i % w, i / w);
+            CHECK(dist == GFraMe_flowfield_get_dist(full, i % w, i / w));
+            // Solid tiles are only checked against the full field
+            if (is_free(tmap, i % w, i / w))
+                CHECK(dist == (ref[i] == INT_MAX ? -1 : ref[i]));
+            i++;
+        }
+        move++;
+    }
+    return failures;
+}
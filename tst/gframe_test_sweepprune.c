@@ -0,0 +1,445 @@
+/**
+ * @file gframe_test_sweepprune.c
+ *
+ * Check the events reported by the sweep and prune: objects are moved,
+ * resized and removed, and after every update the reported pairs must match
+ * the ones found by testing every pair of objects
+ */
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_hitbox.h>
+#include <GFraMe/GFraMe_log.h>
+#include <GFraMe/GFraMe_object.h>
+#include <GFraMe/GFraMe_sweepprune.h>
+#include <stdlib.h>
+
+/**
+ * How many objects there are
+ */
+#define NUM_OBJS 12
+/**
+ * How many updates are done while moving objects randomly
+ */
+#define NUM_STEPS 2000
+/**
+ * Width of the area where objects are moved randomly
+ */
+#define AREA_W 96
+/**
+ * Height of the area where objects are moved randomly
+ */
+#define AREA_H 48
+/**
+ * Marks a pair that wasn't reported on the last update
+ */
+#define NO_EVENT -1
+
+/**
+ * Every object
+ */
+static GFraMe_object objs[NUM_OBJS];
+/**
+ * Every object's hitbox (upper left corner and dimensions)
+ */
+static int boxes[NUM_OBJS][4];
+/**
+ * Whether each object was added to the sweep and prune
+ */
+static int alive[NUM_OBJS];
+/**
+ * Whether each pair was touching on the last update
+ */
+static int touching[NUM_OBJS][NUM_OBJS];
+/**
+ * Event reported for each pair on the last update
+ */
+static int events[NUM_OBJS][NUM_OBJS];
+/**
+ * How many of each event were reported
+ */
+static int totals[3];
+/**
+ * How many checks failed
+ */
+static int failures;
+
+/**
+ * Log a failed check and count it
+ */
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            GFraMe_log("Check failed: %s", #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+/**
+ * Move and resize an object
+ */
+static void place(int i, int x, int y, int w, int h);
+/**
+ * Add an object to the sweep and prune
+ */
+static void add(GFraMe_sweepprune *sap, int i);
+/**
+ * Remove an object from the sweep and prune
+ */
+static void remove_obj(GFraMe_sweepprune *sap, int i);
+/**
+ * Record an event reported by the sweep and prune
+ */
+static void on_event(GFraMe_object *o1, GFraMe_object *o2,
+    GFraMe_sweepprune_event ev, void *ctx);
+/**
+ * Update the sweep and prune and compare every reported event with the ones
+ * expected from testing every pair of objects
+ */
+static void update(GFraMe_sweepprune *sap);
+/**
+ * Remove every object and check that everything ended
+ */
+static void reset(GFraMe_sweepprune *sap);
+/**
+ * Move an object over another and back
+ */
+static void check_moving(GFraMe_sweepprune *sap);
+/**
+ * Grow and shrink objects whose hitboxes have no width
+ */
+static void check_zero_width(GFraMe_sweepprune *sap);
+/**
+ * Remove objects while they are overlapping
+ */
+static void check_removal(GFraMe_sweepprune *sap);
+/**
+ * Move, resize, remove and add objects randomly
+ */
+static void check_random(GFraMe_sweepprune *sap);
+
+/**
+ * Main function.
+ *
+ * @param argc Number of arguments
+ * @param argv The actual arguments
+ * @return Error code
+ */
+int main (int argc, char *argv[]) {
+    GFraMe_ret rv;
+    GFraMe_sweepprune sap;
+    int i;
+
+    failures = 0;
+    i = 0;
+    while (i < NUM_OBJS) {
+        GFraMe_object_clear(objs + i);
+        alive[i] = 0;
+        i++;
+    }
+
+    rv = GFraMe_sweepprune_init(&sap, NUM_OBJS);
+    GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to init sweep and prune",
+        __ret);
+
+    check_moving(&sap);
+    GFraMe_log("Moving objects checked (%i failures so far)", failures);
+    check_zero_width(&sap);
+    GFraMe_log("Zero-width objects checked (%i failures so far)", failures);
+    check_removal(&sap);
+    GFraMe_log("Removal checked (%i failures so far)", failures);
+    check_random(&sap);
+    GFraMe_log("Random objects checked (%i failures so far)", failures);
+    GFraMe_log("Events: %i began, %i persisted, %i ended",
+        totals[GFraMe_sweepprune_begin], totals[GFraMe_sweepprune_persist],
+        totals[GFraMe_sweepprune_end]);
+
+    GFraMe_sweepprune_clear(&sap);
+    if (failures != 0) {
+        rv = GFraMe_ret_failed;
+        GFraMe_assertRet(0, "Sweep and prune checks failed", __ret);
+    }
+    GFraMe_log("Every sweep and prune check passed");
+__ret:
+    return rv;
+}
+
+/**
+ * Move and resize an object
+ */
+static void place(int i, int x, int y, int w, int h) {
+    GFraMe_object_set_pos(objs + i, x, y);
+    GFraMe_hitbox_set(GFraMe_object_get_hitbox(objs + i),
+        GFraMe_hitbox_upper_left, 0, 0, w, h);
+    boxes[i][0] = x;
+    boxes[i][1] = y;
+    boxes[i][2] = w;
+    boxes[i][3] = h;
+}
+
+/**
+ * Add an object to the sweep and prune
+ */
+static void add(GFraMe_sweepprune *sap, int i) {
+    CHECK(GFraMe_sweepprune_add(sap, objs + i) == GFraMe_ret_ok);
+    alive[i] = 1;
+}
+
+/**
+ * Remove an object from the sweep and prune
+ */
+static void remove_obj(GFraMe_sweepprune *sap, int i) {
+    CHECK(GFraMe_sweepprune_remove(sap, objs + i) == GFraMe_ret_ok);
+    alive[i] = 0;
+}
+
+/**
+ * Record an event reported by the sweep and prune
+ */
+static void on_event(GFraMe_object *o1, GFraMe_object *o2,
+    GFraMe_sweepprune_event ev, void *ctx) {
+    int i, j;
+
+    i = (int)(o1 - objs);
+    j = (int)(o2 - objs);
+    CHECK(i >= 0 && i < NUM_OBJS && j >= 0 && j < NUM_OBJS);
+    if (i < 0 || i >= NUM_OBJS || j < 0 || j >= NUM_OBJS)
+        return;
+    // An object must never be paired with itself
+    CHECK(i != j);
+    // Every pair must be reported only once
+    CHECK(events[i][j] == NO_EVENT && events[j][i] == NO_EVENT);
+    events[i][j] = ev;
+    events[j][i] = ev;
+    totals[ev]++;
+}
+
+/**
+ * Update the sweep and prune and compare every reported event with the ones
+ * expected from testing every pair of objects
+ */
+static void update(GFraMe_sweepprune *sap) {
+    int i, j, count, expected;
+
+    i = 0;
+    while (i < NUM_OBJS) {
+        j = 0;
+        while (j < NUM_OBJS) {
+            events[i][j] = NO_EVENT;
+            j++;
+        }
+        i++;
+    }
+
+    count = GFraMe_sweepprune_update(sap, on_event, NULL);
+
+    expected = 0;
+    i = 0;
+    while (i < NUM_OBJS) {
+        j = i + 1;
+        while (j < NUM_OBJS) {
+            int now, ev;
+
+            now = alive[i] && alive[j]
+                && boxes[i][0] < boxes[j][0] + boxes[j][2]
+                && boxes[j][0] < boxes[i][0] + boxes[i][2]
+                && boxes[i][1] < boxes[j][1] + boxes[j][3]
+                && boxes[j][1] < boxes[i][1] + boxes[i][3];
+            if (now && touching[i][j])
+                ev = GFraMe_sweepprune_persist;
+            else if (now)
+                ev = GFraMe_sweepprune_begin;
+            else if (touching[i][j])
+                ev = GFraMe_sweepprune_end;
+            else
+                ev = NO_EVENT;
+            if (events[i][j] != ev)
+                GFraMe_log("Objects %i and %i: reported %i, expected %i", i,
+                    j, events[i][j], ev);
+            CHECK(events[i][j] == ev);
+            touching[i][j] = now;
+            expected += now;
+            j++;
+        }
+        i++;
+    }
+    CHECK(count == expected);
+}
+
+/**
+ * Remove every object and check that everything ended
+ */
+static void reset(GFraMe_sweepprune *sap) {
+    int i;
+
+    i = 0;
+    while (i < NUM_OBJS) {
+        if (alive[i])
+            remove_obj(sap, i);
+        i++;
+    }
+    update(sap);
+    CHECK(sap->num_endpoints == 0 && sap->num_pairs == 0);
+}
+
+/**
+ * Move an object over another and back
+ */
+static void check_moving(GFraMe_sweepprune *sap) {
+    int x, begins, ends;
+
+    place(0, 0, 0, 16, 16);
+    place(1, 32, 8, 8, 8);
+    add(sap, 0);
+    add(sap, 1);
+    begins = totals[GFraMe_sweepprune_begin];
+    ends = totals[GFraMe_sweepprune_end];
+    x = 32;
+    while (x >= -16) {
+        place(1, x, 8, 8, 8);
+        update(sap);
+        x -= 2;
+    }
+    while (x <= 32) {
+        place(1, x, 8, 8, 8);
+        update(sap);
+        x += 2;
+    }
+    // It passed over the other object twice
+    CHECK(totals[GFraMe_sweepprune_begin] - begins == 2);
+    CHECK(totals[GFraMe_sweepprune_end] - ends == 2);
+    // Overlapping horizontally isn't enough
+    place(1, 4, 32, 8, 8);
+    update(sap);
+    place(1, 4, 16, 8, 8);
+    update(sap);
+    place(1, 4, 15, 8, 8);
+    update(sap);
+    CHECK(events[0][1] == GFraMe_sweepprune_begin);
+    reset(sap);
+}
+
+/**
+ * Grow and shrink objects whose hitboxes have no width
+ */
+static void check_zero_width(GFraMe_sweepprune *sap) {
+    int w;
+
+    // Lone object growing from nothing (it must not pair with itself)
+    place(0, 16, 0, 0, 8);
+    add(sap, 0);
+    update(sap);
+    w = 2;
+    while (w <= 8) {
+        place(0, 16 - w / 2, 0, w, 8);
+        update(sap);
+        w += 2;
+    }
+    // Two zero-width objects on the same spot, growing one at a time
+    place(0, 16, 0, 0, 8);
+    place(1, 16, 0, 0, 8);
+    add(sap, 1);
+    update(sap);
+    CHECK(events[0][1] == NO_EVENT);
+    place(1, 12, 0, 8, 8);
+    update(sap);
+    CHECK(events[0][1] == GFraMe_sweepprune_begin);
+    place(0, 12, 0, 8, 8);
+    update(sap);
+    CHECK(events[0][1] == GFraMe_sweepprune_persist);
+    place(0, 16, 0, 0, 8);
+    place(1, 16, 0, 0, 8);
+    update(sap);
+    CHECK(events[0][1] == GFraMe_sweepprune_end);
+    // Zero-width object sweeping over a wider one
+    place(2, 24, 0, 8, 8);
+    add(sap, 2);
+    w = 8;
+    while (w <= 40) {
+        place(0, w, 4, 0, 8);
+        update(sap);
+        w++;
+    }
+    reset(sap);
+}
+
+/**
+ * Remove objects while they are overlapping
+ */
+static void check_removal(GFraMe_sweepprune *sap) {
+    place(0, 0, 0, 16, 16);
+    place(1, 8, 8, 16, 16);
+    place(2, 12, 4, 8, 8);
+    add(sap, 0);
+    add(sap, 1);
+    add(sap, 2);
+    update(sap);
+    CHECK(events[0][1] == GFraMe_sweepprune_begin);
+    CHECK(events[1][2] == GFraMe_sweepprune_begin);
+    update(sap);
+    CHECK(events[0][1] == GFraMe_sweepprune_persist);
+
+    // Removing an object ends its pairs, but keeps the others
+    remove_obj(sap, 1);
+    update(sap);
+    CHECK(events[0][1] == GFraMe_sweepprune_end);
+    CHECK(events[1][2] == GFraMe_sweepprune_end);
+    CHECK(events[0][2] == GFraMe_sweepprune_persist);
+    // ...and it's reported only once
+    update(sap);
+    CHECK(events[0][1] == NO_EVENT && events[1][2] == NO_EVENT);
+
+    // Removing an object that was never added
+    CHECK(GFraMe_sweepprune_remove(sap, objs + 1) == GFraMe_ret_failed);
+    reset(sap);
+}
+
+/**
+ * Move, resize, remove and add objects randomly
+ */
+static void check_random(GFraMe_sweepprune *sap) {
+    int step, i;
+
+    srand(0);
+    i = 0;
+    while (i < NUM_OBJS) {
+        place(i, rand() % AREA_W, rand() % AREA_H, (rand() % 5) * 4,
+            (rand() % 5) * 4);
+        add(sap, i);
+        i++;
+    }
+    update(sap);
+
+    step = 0;
+    while (step < NUM_STEPS) {
+        i = 0;
+        while (i < NUM_OBJS) {
+            int x, y, w, h;
+
+            // Move it a little, keeping it within a small area
+            x = boxes[i][0] + rand() % 9 - 4;
+            y = boxes[i][1] + rand() % 9 - 4;
+            if (x < 0 || x > AREA_W)
+                x = boxes[i][0];
+            if (y < 0 || y > AREA_H)
+                y = boxes[i][1];
+            w = boxes[i][2];
+            h = boxes[i][3];
+            // Sometimes, resize it (possibly to nothing)
+            if (rand() % 16 == 0) {
+                w = (rand() % 5) * 4;
+                h = (rand() % 5) * 4;
+            }
+            place(i, x, y, w, h);
+            // Sometimes, remove or add it back
+            if (rand() % 64 == 0) {
+                if (alive[i])
+                    remove_obj(sap, i);
+                else
+                    add(sap, i);
+            }
+            i++;
+        }
+        update(sap);
+        step++;
+    }
+    reset(sap);
+}
@@ -0,0 +1,306 @@
+/**
+ * @file gframe_test_tilestream.c
+ *
+ * Check that a streamed tilemap keeps up with a moving camera: a map is
+ * written to a tilemap file and a scripted camera scrolls over it; every
+ * visible region must already be resident when the camera reaches it
+ */
+#include <GFraMe/GFraMe.h>
+#include <GFraMe/GFraMe_assets.h>
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_event.h>
+#include <GFraMe/GFraMe_log.h>
+#include <GFraMe/GFraMe_spriteset.h>
+#include <GFraMe/GFraMe_texture.h>
+#include <GFraMe/GFraMe_tilefile.h>
+#include <GFraMe/GFraMe_tilestream.h>
+
+/**
+ * Window's width
+ */
+#define WND_W 320
+/**
+ * Window's height
+ */
+#define WND_H 240
+/**
+ * Screen's width
+ */
+#define SCR_W 160
+/**
+ * Screen's height
+ */
+#define SCR_H 120
+/**
+ * Tile's width
+ */
+#define TILE_W 8
+/**
+ * Tile's height
+ */
+#define TILE_H 8
+/**
+ * Map's width, in tiles
+ */
+#define MAP_W 256
+/**
+ * Map's height, in tiles
+ */
+#define MAP_H 256
+/**
+ * Size of the map file's chunks, in tiles
+ */
+#define CHUNK 16
+/**
+ * Size of the streamed regions, in tiles
+ */
+#define REGION 32
+/**
+ * How many regions around the view are loaded
+ */
+#define RADIUS 1
+/**
+ * How many pixels the camera moves per update
+ */
+#define CAM_SPEED 16
+/**
+ * Map file (within the assets folder)
+ */
+#define MAP_FILE "test_tilestream.gftm"
+
+#define alp 0x00,0x00,0x00,0x00
+#define lne 0x59,0x56,0x52,0xff
+#define med 0x9b,0xad,0xb7,0xff
+unsigned char data[] = {
+alp,alp,alp,alp,alp,alp,alp,alp,lne,lne,lne,lne,lne,lne,lne,lne,
+alp,alp,alp,alp,alp,alp,alp,alp,lne,med,med,med,med,med,med,lne,
+alp,alp,alp,alp,alp,alp,alp,alp,lne,med,med,med,med,med,med,lne,
+alp,alp,alp,alp,alp,alp,alp,alp,lne,med,med,med,med,med,med,lne,
+alp,alp,alp,alp,alp,alp,alp,alp,lne,med,med,med,med,med,med,lne,
+alp,alp,alp,alp,alp,alp,alp,alp,lne,med,med,med,med,med,med,lne,
+alp,alp,alp,alp,alp,alp,alp,alp,lne,med,med,med,med,med,med,lne,
+alp,alp,alp,alp,alp,alp,alp,alp,lne,lne,lne,lne,lne,lne,lne,lne
+};
+
+/**
+ * Solid tile types
+ */
+static GFraMe_tile collideable[] = {1};
+/**
+ * Points the camera goes through, in order
+ */
+static int path[][2] = {
+    {0, 0},
+    {MAP_W * TILE_W - SCR_W, 0},
+    {MAP_W * TILE_W - SCR_W, MAP_H * TILE_H - SCR_H},
+    {0, MAP_H * TILE_H - SCR_H},
+    {MAP_W * TILE_W / 2, MAP_H * TILE_H / 2},
+    {0, 0}
+};
+/**
+ * The map's tiles (only used to write the file)
+ */
+static GFraMe_tile tiles[MAP_W * MAP_H];
+/**
+ * The streamed tilemap
+ */
+static GFraMe_tilestream stream;
+/**
+ * Spriteset used by the tilemap
+ */
+static GFraMe_spriteset sset8x8;
+/**
+ * Texture used by the tilemap
+ */
+static GFraMe_texture atlas;
+/**
+ * Whether the assets where initialized
+ */
+static int didInitAssets;
+/**
+ * Keep the main loop running
+ */
+static int running;
+
+// Define some variables needed by the events module
+GFraMe_event_setup();
+
+/**
+ * Initialize the assets and write the map file
+ *
+ * return GFraMe error code
+ */
+static GFraMe_ret init_assets();
+/**
+ * Clean up assets
+ */
+static void clean_assets();
+/**
+ * Check which event ocurred (necessary for stepping the timer and quitting)
+ */
+static void event_handler();
+
+/**
+ * Main function.
+ *
+ * @param argc Number of arguments
+ * @param argv The actual arguments
+ * @return Error code
+ */
+int main (int argc, char *argv[]) {
+    GFraMe_ret rv;
+    int cam_x, cam_y, next, started, misses;
+
+    // Mark assets as not needing clean up
+    didInitAssets = 0;
+
+    // Init the framework
+    rv = GFraMe_init(SCR_W, SCR_H, WND_W, WND_H, "com.gfmgamecorner",
+        "TilestreamTest", GFraMe_window_resizable, 0, 60, 0, 0);
+    GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to init the framework",
+        __ret);
+
+    // Init the assets
+    rv = init_assets();
+    GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to init assets", __ret);
+
+    // Init the framework update and draw clock
+    GFraMe_event_init(60, 60);
+
+    // Run the main loop
+    cam_x = path[0][0];
+    cam_y = path[0][1];
+    next = 1;
+    started = 0;
+    running = 1;
+    while (running) {
+        event_handler();
+        GFraMe_event_update_begin();
+            misses = stream.num_misses;
+            rv = GFraMe_tilestream_update(&stream, cam_x, cam_y, SCR_W,
+                SCR_H);
+            GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to update stream",
+                __ret);
+            // Only start moving once the first view is loaded
+            if (!started) {
+                if (stream.num_misses == misses) {
+                    stream.num_misses = 0;
+                    started = 1;
+                }
+            }
+            else if (next < (int)(sizeof(path) / sizeof(path[0]))) {
+                int dx, dy;
+
+                // Move toward the next point on the path
+                dx = path[next][0] - cam_x;
+                dy = path[next][1] - cam_y;
+                if (dx > CAM_SPEED)
+                    dx = CAM_SPEED;
+                else if (dx < -CAM_SPEED)
+                    dx = -CAM_SPEED;
+                if (dy > CAM_SPEED)
+                    dy = CAM_SPEED;
+                else if (dy < -CAM_SPEED)
+                    dy = -CAM_SPEED;
+                cam_x += dx;
+                cam_y += dy;
+                if (cam_x == path[next][0] && cam_y == path[next][1])
+                    next++;
+            }
+            else
+                running = 0;
+        GFraMe_event_update_end();
+        GFraMe_event_draw_begin();
+            GFraMe_tilestream_draw_camera(&stream, cam_x, cam_y, SCR_W,
+                SCR_H);
+        GFraMe_event_draw_end();
+    }
+
+    GFraMe_log("Regions loaded: %i, evicted: %i, failed: %i, misses: %i",
+        stream.num_loads, stream.num_evictions, stream.num_failures,
+        stream.num_misses);
+    if (started && stream.num_misses == 0 && stream.num_failures == 0)
+        GFraMe_log("Every region was resident before it was visible");
+    else {
+        rv = GFraMe_ret_failed;
+        GFraMe_assertRet(0, "Tilestream check failed", __ret);
+    }
+__ret:
+    // Clean up everything
+    clean_assets();
+    GFraMe_quit();
+    return rv;
+}
+
+/**
+ * Initialize the assets and write the map file
+ *
+ * return GFraMe error code
+ */
+static GFraMe_ret init_assets() {
+    GFraMe_ret rv;
+    char path[GFraMe_max_path_len];
+    int len, x, y;
+
+    // Load the texture
+    rv = GFraMe_texture_load(&atlas, TILE_W * 2, TILE_H, data);
+    GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to load the texture",
+        __ret);
+    // From here on, the texture must be released (clearing the stream is
+    // safe even if it's never initialized, as it's zeroed)
+    didInitAssets = 1;
+    GFraMe_spriteset_init(&sset8x8, &atlas, TILE_W, TILE_H);
+
+    // Create a map with a border and some blocks scattered around
+    y = 0;
+    while (y < MAP_H) {
+        x = 0;
+        while (x < MAP_W) {
+            if (x == 0 || y == 0 || x == MAP_W - 1 || y == MAP_H - 1
+                || (x * 7 + y * 13) % 11 == 0)
+                tiles[x + y * MAP_W] = 1;
+            else
+                tiles[x + y * MAP_W] = 0;
+            x++;
+        }
+        y++;
+    }
+    // Write it where the stream will look for it
+    len = GFraMe_max_path_len;
+    rv = GFraMe_assets_clean_filename(path, MAP_FILE, &len);
+    GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to get the map's path",
+        __ret);
+    rv = GFraMe_tilefile_write(path, tiles, MAP_W, MAP_H, CHUNK, CHUNK);
+    GFraMe_assertRet(rv == GFraMe_ret_ok,
+        "Failed to write the map (is there an 'assets' folder?)", __ret);
+
+    rv = GFraMe_tilestream_init(&stream, MAP_FILE, REGION, REGION, RADIUS,
+        &sset8x8, collideable, sizeof(collideable) / sizeof(GFraMe_tile));
+    GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to init the stream", __ret);
+
+    rv = GFraMe_ret_ok;
+__ret:
+    return rv;
+}
+
+/**
+ * Clean up assets
+ */
+static void clean_assets() {
+    if (!didInitAssets)
+        return;
+    GFraMe_tilestream_clear(&stream);
+    GFraMe_texture_clear(&atlas);
+}
+
+/**
+ * Check which event ocurred (necessary for stepping the timer and quitting)
+ */
+static void event_handler() {
+    GFraMe_event_begin();
+        GFraMe_event_on_timer();
+        GFraMe_event_on_quit();
+            GFraMe_log("Received quit!");
+            running = 0;
+    GFraMe_event_end();
+}
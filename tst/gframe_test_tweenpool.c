@@ -0,0 +1,207 @@
+/**
+ * @file gframe_test_tweenpool.c
+ *
+ * Check the tween pool: every easing curve must start at 0 and end at 1, and
+ * tweens must be removed from the pool as soon as they finish, leaving their
+ * targets exactly on their final values
+ */
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_log.h>
+#include <GFraMe/GFraMe_object.h>
+#include <GFraMe/GFraMe_tweenpool.h>
+#include <math.h>
+
+/**
+ * How many objects are tweened
+ */
+#define NUM_OBJS 8
+/**
+ * How long, in milliseconds, each update lasts
+ */
+#define FRAME_MS 16
+/**
+ * Greatest difference between two floats considered equal
+ */
+#define EPSILON 0.0001f
+
+/**
+ * How many checks failed
+ */
+static int failures;
+
+/**
+ * Log a failed check and count it
+ */
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            GFraMe_log("Check failed: %s", #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+/**
+ * Check that every easing curve starts at 0 and ends at 1
+ */
+static void check_eases();
+/**
+ * Tween objects and floats with different durations and curves, checking that
+ * each is removed on the update it finishes, at its final value
+ */
+static void check_pool(GFraMe_tweenpool *pool);
+/**
+ * Check that stopped tweens leave their targets as they are
+ */
+static void check_stop(GFraMe_tweenpool *pool);
+
+/**
+ * Main function.
+ *
+ * @param argc Number of arguments
+ * @param argv The actual arguments
+ * @return Error code
+ */
+int main (int argc, char *argv[]) {
+    GFraMe_ret rv;
+    GFraMe_tweenpool pool;
+
+    failures = 0;
+    rv = GFraMe_tweenpool_init(&pool, NUM_OBJS * 2);
+    GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to init tween pool", __ret);
+
+    check_eases();
+    GFraMe_log("Easing curves checked (%i failures so far)", failures);
+    check_pool(&pool);
+    GFraMe_log("Finished tweens checked (%i failures so far)", failures);
+    check_stop(&pool);
+    GFraMe_log("Stopped tweens checked (%i failures so far)", failures);
+
+    GFraMe_tweenpool_clear(&pool);
+    if (failures != 0) {
+        rv = GFraMe_ret_failed;
+        GFraMe_assertRet(0, "Tween pool checks failed", __ret);
+    }
+    GFraMe_log("Every tween pool check passed");
+__ret:
+    return rv;
+}
+
+/**
+ * Check that every easing curve starts at 0 and ends at 1
+ */
+static void check_eases() {
+    int e;
+
+    e = 0;
+    while (e < GFraMe_ease_max) {
+        float v0, v1;
+
+        v0 = GFraMe_ease_sample((GFraMe_ease)e, 0.0f);
+        v1 = GFraMe_ease_sample((GFraMe_ease)e, 1.0f);
+        if (fabsf(v0) > EPSILON || fabsf(v1 - 1.0f) > EPSILON)
+            GFraMe_log("Ease %i: %f at t = 0, %f at t = 1", e, v0, v1);
+        CHECK(fabsf(v0) <= EPSILON);
+        CHECK(fabsf(v1 - 1.0f) <= EPSILON);
+        // Times outside [0, 1] are clamped
+        CHECK(GFraMe_ease_sample((GFraMe_ease)e, -1.0f) == v0);
+        CHECK(GFraMe_ease_sample((GFraMe_ease)e, 2.0f) == v1);
+        e++;
+    }
+    // Invalid curves are sampled as linear
+    CHECK(fabsf(GFraMe_ease_sample(GFraMe_ease_max, 0.25f) - 0.25f)
+        <= EPSILON);
+    CHECK(fabsf(GFraMe_ease_sample(GFraMe_ease_linear, 0.5f) - 0.5f)
+        <= EPSILON);
+}
+
+/**
+ * Tween objects and floats with different durations and curves, checking that
+ * each is removed on the update it finishes, at its final value
+ */
+static void check_pool(GFraMe_tweenpool *pool) {
+    GFraMe_object objs[NUM_OBJS];
+    float values[NUM_OBJS];
+    int durations[NUM_OBJS];
+    int i, elapsed, running;
+
+    i = 0;
+    while (i < NUM_OBJS) {
+        GFraMe_object_clear(objs + i);
+        GFraMe_object_set_pos(objs + i, i * 10, -i * 10);
+        values[i] = (float)i;
+        // Some tweens finish within a single update, others between updates
+        durations[i] = 1 + i * 37;
+        CHECK(GFraMe_tweenpool_add_obj(pool, objs + i, 100 + i, 200 - i,
+            durations[i], (GFraMe_ease)(i % GFraMe_ease_max))
+            == GFraMe_ret_ok);
+        CHECK(GFraMe_tweenpool_add_float(pool, values + i, -(float)i,
+            durations[i], (GFraMe_ease)((i + 3) % GFraMe_ease_max))
+            == GFraMe_ret_ok);
+        i++;
+    }
+    CHECK(pool->num == NUM_OBJS * 2);
+
+    elapsed = 0;
+    running = NUM_OBJS * 2;
+    while (running > 0) {
+        int finished, expected;
+
+        finished = GFraMe_tweenpool_update(pool, FRAME_MS);
+        elapsed += FRAME_MS;
+        running -= finished;
+        CHECK(pool->num == running);
+
+        expected = 0;
+        i = 0;
+        while (i < NUM_OBJS) {
+            if (durations[i] <= elapsed) {
+                // Finished: it must be exactly on its final value
+                CHECK(objs[i].x == 100 + i && objs[i].y == 200 - i);
+                CHECK(objs[i].dx == GFraMe_real_from_int(100 + i));
+                CHECK(objs[i].dy == GFraMe_real_from_int(200 - i));
+                CHECK(values[i] == -(float)i);
+                if (durations[i] > elapsed - FRAME_MS)
+                    expected += 2;
+            }
+            i++;
+        }
+        CHECK(finished == expected);
+        // Don't loop forever if a tween never finishes
+        if (elapsed > durations[NUM_OBJS - 1] + FRAME_MS) {
+            CHECK(running == 0);
+            break;
+        }
+    }
+    CHECK(pool->num == 0);
+
+    // Updating an empty pool does nothing
+    CHECK(GFraMe_tweenpool_update(pool, FRAME_MS) == 0);
+}
+
+/**
+ * Check that stopped tweens leave their targets as they are
+ */
+static void check_stop(GFraMe_tweenpool *pool) {
+    GFraMe_object obj;
+    float value;
+    int x, y;
+
+    GFraMe_object_clear(&obj);
+    value = 0.0f;
+    CHECK(GFraMe_tweenpool_add_obj(pool, &obj, 64, 64, 1000,
+        GFraMe_ease_linear) == GFraMe_ret_ok);
+    CHECK(GFraMe_tweenpool_add_float(pool, &value, 1.0f, 1000,
+        GFraMe_ease_linear) == GFraMe_ret_ok);
+    CHECK(GFraMe_tweenpool_update(pool, 500) == 0);
+    CHECK(obj.x == 32 && obj.y == 32);
+    CHECK(fabsf(value - 0.5f) <= EPSILON);
+
+    x = obj.x;
+    y = obj.y;
+    CHECK(GFraMe_tweenpool_stop(pool, &obj) == 1);
+    CHECK(pool->num == 1);
+    CHECK(GFraMe_tweenpool_update(pool, 1000) == 1);
+    CHECK(obj.x == x && obj.y == y);
+    CHECK(value == 1.0f);
+    CHECK(pool->num == 0);
+}